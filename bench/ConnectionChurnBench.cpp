@@ -0,0 +1,291 @@
+//
+// Created by shuzeyong on 2025/5/27.
+//
+
+/*
+ * 连接对象创建/销毁基准：对比 TcpServer::newConnection 中的 std::allocate_shared + [SlabAllocator]
+ * 与原先的 std::make_shared
+ *
+ * 用法：bench_conn_churn [连接数] [同时存活的连接数]
+ * 输出每种方式的吞吐（连接/秒）与平均每个连接的堆分配次数
+ * - object：只创建/销毁与 TcpConnection 等大的对象，衡量分配器本身
+ * - connection：构造真实的 TcpConnection（每个连接一个 socket），衡量 newConnection 的完整开销
+ * - connection mmap source：同上，另外像 TcpServer::setBlockSource() 一样换用 [NgxMmapBlockSource]，
+ *   并让两个缓冲区各扩容一次（写入 4KB），衡量连接缓冲区的存储是否触发 mmap/munmap
+ * - remote：在本线程分配、最后一个引用在另一个线程释放，走 [SlabPool] 的远程释放栈（旧的 newConnection：
+ *   baseloop 分配，ioLoop 析构）
+ * - on io：本线程只把创建任务交给另一个线程，由其从自己的池分配并在该线程释放（当前的 newConnection：
+ *   连接在 ioLoop 线程中从 [EventLoop::connectionPool()] 创建并析构）。每个任务是一个需要堆分配的 std::function，
+ *   比 TcpServer 的批量交接队列多一次分配
+ */
+
+#include "../include/net/ObjectPool.h"
+#include "../include/net/TcpConnection.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+using namespace net;
+
+namespace
+{
+    std::atomic<uint64_t> g_allocations{0};//!< 全局 operator new 调用次数
+
+    /**
+     * @brief 与 TcpConnection 等大的对象，只衡量分配器
+     */
+    struct Dummy
+    {
+        alignas(std::max_align_t) char data[sizeof(TcpConnection)];
+    };
+
+    /**
+     * @brief 运行一个基准并打印结果
+     * @param name 基准名称
+     * @param count 连接数
+     * @param body 基准主体
+     */
+    template<typename Body>
+    void run(const char *name, size_t count, Body &&body)
+    {
+        uint64_t allocsBefore = g_allocations.load(std::memory_order_relaxed);
+        auto begin = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        uint64_t allocs = g_allocations.load(std::memory_order_relaxed) - allocsBefore;
+
+        double seconds = std::chrono::duration<double>(end - begin).count();
+        printf("%-28s %12.0f conns/s %8.2f allocs/conn\n", name, static_cast<double>(count) / seconds,
+               static_cast<double>(allocs) / static_cast<double>(count));
+    }
+
+    /**
+     * @brief 滚动创建对象：始终保持 window 个存活，新对象替换最早的对象
+     * @param count 创建总数
+     * @param window 同时存活的对象数
+     * @param make 创建函数，参数为序号
+     */
+    template<typename Make>
+    void churn(size_t count, size_t window, Make &&make)
+    {
+        std::vector<decltype(make(size_t{0}))> live(window);
+        for (size_t i = 0; i < count; ++i)
+        {
+            live[i % window] = make(i);
+        }
+    }
+
+    /**
+     * @brief 与 churn 相同，但被替换的对象交给另一个线程释放
+     */
+    template<typename Make>
+    void churnRemoteFree(size_t count, size_t window, Make &&make)
+    {
+        using Ptr = decltype(make(size_t{0}));
+        const size_t kBatch = 256;
+
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::vector<Ptr> pending;// 待释放（生产者写入）
+        bool done = false;
+        pending.reserve(kBatch);
+
+        std::thread releaser([&] {
+            std::vector<Ptr> batch;
+            batch.reserve(kBatch);
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true)
+            {
+                cond.wait(lock, [&] { return !pending.empty() || done; });
+                if (pending.empty())
+                {
+                    break;
+                }
+                batch.swap(pending);
+                lock.unlock();
+                batch.clear();// 在本线程释放最后一个引用
+                lock.lock();
+                cond.notify_one();
+            }
+        });
+
+        std::vector<Ptr> live(window);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Ptr &slot = live[i % window];
+            if (slot)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [&] { return pending.size() < kBatch; });
+                pending.push_back(std::move(slot));
+                cond.notify_one();
+            }
+            slot = make(i);
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (Ptr &slot: live)
+            {
+                if (slot)
+                {
+                    cond.wait(lock, [&] { return pending.size() < kBatch; });
+                    pending.push_back(std::move(slot));
+                    cond.notify_one();
+                }
+            }
+            done = true;
+            cond.notify_one();
+        }
+        releaser.join();
+    }
+
+    /**
+     * @brief 与 churn 相同，但创建与替换都在另一个线程执行，本线程只投递创建任务
+     */
+    template<typename Make>
+    void churnOnWorker(size_t count, size_t window, Make &&make)
+    {
+        using Ptr = decltype(make(size_t{0}));
+        const size_t kBatch = 256;
+
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::vector<std::function<void()>> pending;// 待执行的创建任务（生产者写入）
+        bool done = false;
+        pending.reserve(kBatch);
+        std::vector<Ptr> live(window);// 只由 worker 线程访问
+
+        std::thread worker([&] {
+            std::vector<std::function<void()>> batch;
+            batch.reserve(kBatch);
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true)
+            {
+                cond.wait(lock, [&] { return !pending.empty() || done; });
+                if (pending.empty())
+                {
+                    break;
+                }
+                batch.swap(pending);
+                lock.unlock();
+                for (auto &job: batch)
+                {
+                    job();
+                }
+                batch.clear();
+                lock.lock();
+                cond.notify_one();
+            }
+            live.clear();// 剩余对象同样在本线程释放
+        });
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&] { return pending.size() < kBatch; });
+            pending.emplace_back([&live, &make, window, i] { live[i % window] = make(i); });
+            cond.notify_one();
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done = true;
+            cond.notify_one();
+        }
+        worker.join();
+    }
+
+    /**
+     * @brief 创建一个连接（与 TcpServer::newConnection 相同的构造参数）
+     */
+    template<typename Alloc>
+    TcpConnectionPtr makeConnection(const Alloc &alloc, EventLoop *loop, size_t i)
+    {
+        int sockfd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (sockfd < 0)
+        {
+            perror("socket");
+            exit(1);
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "bench-%zu", i);
+        InetAddress addr(8000);
+        return std::allocate_shared<TcpConnection>(alloc, loop, name, sockfd, addr, addr);
+    }
+}// namespace
+
+// 统计堆分配次数
+void *operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+    const size_t window = std::max<size_t>(argc > 2 ? strtoul(argv[2], nullptr, 10) : 1024, 1);
+
+    // 连接构造/析构会打 INFO/DEBUG 日志，基准中关闭
+    Logger::setLogLevel(ERROR);
+    EventLoop loop;
+
+    run("object make_shared", count, [&] {
+        churn(count, window, [](size_t) { return std::make_shared<Dummy>(); });
+    });
+    run("object slab", count, [&] {
+        auto pool = SlabPool::create();
+        churn(count, window, [&](size_t) { return std::allocate_shared<Dummy>(SlabAllocator<Dummy>(pool)); });
+    });
+    run("object make_shared remote", count, [&] {
+        churnRemoteFree(count, window, [](size_t) { return std::make_shared<Dummy>(); });
+    });
+    run("object slab remote", count, [&] {
+        auto pool = SlabPool::create();
+        churnRemoteFree(count, window,
+                        [&](size_t) { return std::allocate_shared<Dummy>(SlabAllocator<Dummy>(pool)); });
+    });
+    run("object make_shared on io", count, [&] {
+        churnOnWorker(count, window, [](size_t) { return std::make_shared<Dummy>(); });
+    });
+    run("object slab on io", count, [&] {
+        auto pool = SlabPool::create();
+        churnOnWorker(count, window,
+                      [&](size_t) { return std::allocate_shared<Dummy>(SlabAllocator<Dummy>(pool)); });
+    });
+
+    run("connection make_shared", count, [&] {
+        churn(count, window, [&](size_t i) { return makeConnection(std::allocator<TcpConnection>(), &loop, i); });
+    });
+    run("connection slab", count, [&] {
+        auto pool = SlabPool::create();
+        churn(count, window, [&](size_t i) { return makeConnection(SlabAllocator<TcpConnection>(pool), &loop, i); });
+    });
+    run("connection mmap source", count, [&] {
+        auto pool = SlabPool::create();
+        NgxMmapBlockSource source;
+        std::string payload(4096, 'x');
+        churn(count, window, [&](size_t i) {
+            TcpConnectionPtr conn = makeConnection(SlabAllocator<TcpConnection>(pool), &loop, i);
+            conn->setBlockSource(&source);
+            conn->getInputBuffer()->append(payload.data(), payload.size());
+            conn->getOutputBuffer()->append(payload.data(), payload.size());
+            return conn;
+        });
+    });
+    return 0;
+}
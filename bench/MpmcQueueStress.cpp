@@ -0,0 +1,212 @@
+//
+// Created by shuzeyong on 2025/5/27.
+//
+
+/*
+ * [thp::MpmcQueue] / [thp::EventCount] 并发压力测试，建议以 -fsanitize=thread 构建运行
+ *
+ * 用法：stress_mpmc_queue [每个生产者的元素数] [生产者数] [消费者数]
+ * - queue：小容量队列上多生产者/多消费者收发，队列反复在满与空之间切换；
+ *   消费者为空时在 EventCount 上无超时休眠，丢失唤醒会表现为超时
+ * - pool：启用 [ThreadPool::setLockFreeQueue()] 的线程池由多个线程并发提交
+ * 检查：每个元素恰好被取出一次；同一消费者看到的同一生产者的元素保持入队顺序。失败时返回非 0
+ */
+
+#include "../include/thp/EventCount.h"
+#include "../include/thp/MpmcQueue.h"
+#include "../include/thp/ThreadPool.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    const auto kTimeout = std::chrono::seconds(60);//!< 单个阶段的最长运行时间，超过视为丢失唤醒
+
+    /**
+     * @brief 等待 done 返回 true，超时返回 false
+     */
+    template<typename Done>
+    bool waitFor(Done &&done)
+    {
+        auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (!done())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    /**
+     * @brief 队列阶段：元素编码为 生产者编号 << 32 | 序号，0 作为消费者的退出标记
+     */
+    bool stressQueue(size_t perProducer, size_t producers, size_t consumers)
+    {
+        thp::MpmcQueue<uint64_t> queue(8);
+        thp::EventCount notEmpty;
+        thp::EventCount notFull;
+        std::vector<std::atomic<uint8_t>> seen(producers * perProducer);
+        std::atomic<size_t> received{0};
+        std::atomic<size_t> errors{0};
+
+        auto push = [&](uint64_t value) {
+            while (!queue.tryPush(value))
+            {
+                thp::EventCount::Key key = notFull.prepareWait();
+                if (queue.tryPush(value))
+                {
+                    notFull.cancelWait();
+                    break;
+                }
+                notFull.wait(key);
+            }
+            notEmpty.notifyOne();
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t c = 0; c < consumers; ++c)
+        {
+            threads.emplace_back([&] {
+                std::vector<uint64_t> last(producers, 0);// 每个生产者上一次看到的序号 + 1
+                uint64_t value;
+                while (true)
+                {
+                    if (!queue.tryPop(value))
+                    {
+                        thp::EventCount::Key key = notEmpty.prepareWait();
+                        if (!queue.tryPop(value))
+                        {
+                            notEmpty.wait(key);
+                            continue;
+                        }
+                        notEmpty.cancelWait();
+                    }
+                    notFull.notifyOne();
+                    if (value == 0)
+                    {
+                        break;
+                    }
+                    size_t producer = (value >> 32) - 1;
+                    uint64_t seq = value & 0xffffffffu;
+                    if (seq + 1 <= last[producer])
+                    {
+                        errors.fetch_add(1, std::memory_order_relaxed);// 同一生产者的元素乱序
+                    }
+                    last[producer] = seq + 1;
+                    if (seen[producer * perProducer + seq].fetch_add(1, std::memory_order_relaxed) != 0)
+                    {
+                        errors.fetch_add(1, std::memory_order_relaxed);// 重复取出
+                    }
+                    received.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        std::vector<std::thread> producerThreads;
+        for (size_t p = 0; p < producers; ++p)
+        {
+            producerThreads.emplace_back([&, p] {
+                for (uint64_t i = 0; i < perProducer; ++i)
+                {
+                    push((static_cast<uint64_t>(p + 1) << 32) | i);
+                }
+            });
+        }
+
+        const size_t total = producers * perProducer;
+        bool finished = waitFor([&] { return received.load(std::memory_order_relaxed) == total; });
+        for (auto &thread: producerThreads)
+        {
+            thread.join();
+        }
+        if (!finished)
+        {
+            printf("queue: timed out with %zu/%zu items received (lost wakeup?)\n", received.load(), total);
+            return false;// 消费者可能永远休眠，直接退出进程
+        }
+        for (size_t c = 0; c < consumers; ++c)
+        {
+            push(0);
+        }
+        for (auto &thread: threads)
+        {
+            thread.join();
+        }
+
+        size_t missing = 0;
+        for (auto &count: seen)
+        {
+            missing += count.load(std::memory_order_relaxed) == 0;
+        }
+        printf("queue: %zu items, %zu producers, %zu consumers, %zu errors, %zu missing\n", total, producers,
+               consumers, errors.load(), missing);
+        return errors.load() == 0 && missing == 0 && queue.empty();
+    }
+
+    /**
+     * @brief 线程池阶段：多个线程并发提交到无锁队列模式的线程池
+     */
+    bool stressPool(size_t perProducer, size_t producers, size_t workers)
+    {
+        thp::ThreadPool pool;
+        pool.setLockFreeQueue(true);
+        pool.setTaskQueMaxSize(64);// 小队列：提交方频繁遇到队列已满
+        pool.setRejectPolicy(thp::RejectPolicy::BLOCK, std::chrono::seconds(10));
+        pool.start(workers);
+
+        std::atomic<size_t> executed{0};
+        std::atomic<size_t> rejected{0};
+        std::vector<std::thread> producerThreads;
+        for (size_t p = 0; p < producers; ++p)
+        {
+            producerThreads.emplace_back([&, p] {
+                for (size_t i = 0; i < perProducer; ++i)
+                {
+                    auto priority = static_cast<thp::TaskPriority>((p + i) % 3);
+                    if (!pool.postWithPriority(priority, [&executed] { executed.fetch_add(1, std::memory_order_relaxed); }))
+                    {
+                        rejected.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+        for (auto &thread: producerThreads)
+        {
+            thread.join();
+        }
+
+        const size_t accepted = producers * perProducer - rejected.load();
+        bool finished = waitFor([&] { return executed.load(std::memory_order_relaxed) == accepted; });
+        printf("pool: %zu tasks, %zu producers, %zu workers, %zu executed, %zu rejected\n", producers * perProducer,
+               producers, workers, executed.load(), rejected.load());
+        if (!finished)
+        {
+            printf("pool: timed out (lost wakeup?)\n");
+        }
+        return finished && rejected.load() == 0;
+    }
+}// namespace
+
+int main(int argc, char *argv[])
+{
+    const size_t perProducer = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+    const size_t producers = std::max<size_t>(argc > 2 ? strtoul(argv[2], nullptr, 10) : 4, 1);
+    const size_t consumers = std::max<size_t>(argc > 3 ? strtoul(argv[3], nullptr, 10) : 4, 1);
+
+    if (!stressQueue(perProducer, producers, consumers))
+    {
+        printf("FAILED\n");
+        _exit(1);
+    }
+    if (!stressPool(perProducer, producers, consumers))
+    {
+        printf("FAILED\n");
+        _exit(1);
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,184 @@
+//
+// Created by shuzeyong on 2025/5/27.
+//
+
+/*
+ * 线程池任务提交基准：对比旧的 std::function + shared_ptr<packaged_task> 包装与 [thp::Task]
+ *
+ * 用法：bench_threadpool [任务数] [并发提交线程数]
+ * 输出每种方式的吞吐（任务/秒）与平均每个任务的堆分配次数
+ * - legacy wrap / task wrap：单线程包装 -> 入队 -> 出队 -> 执行 -> 取结果，只衡量任务封装本身
+ * - pool post / pool submitTask：4 个工作线程的端到端提交（submitTask 每批最多 1024 个未完成的 future）
+ * - mp post mutex / mp post lock-free：多个线程同时 post 小任务到 4 个工作线程，对比互斥锁队列与
+ *   [ThreadPool::setLockFreeQueue()]；队列容量 65536，满时按 BLOCK 等待
+ */
+
+#include "../include/thp/ThreadPool.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<uint64_t> g_allocations{0};//!< 全局 operator new 调用次数
+
+    /**
+     * @brief 运行一个基准并打印结果
+     * @param name 基准名称
+     * @param tasks 任务数
+     * @param body 基准主体
+     */
+    template<typename Body>
+    void run(const char *name, size_t tasks, Body &&body)
+    {
+        uint64_t allocsBefore = g_allocations.load(std::memory_order_relaxed);
+        auto begin = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        uint64_t allocs = g_allocations.load(std::memory_order_relaxed) - allocsBefore;
+
+        double seconds = std::chrono::duration<double>(end - begin).count();
+        printf("%-20s %12.0f tasks/s %8.2f allocs/task\n", name, static_cast<double>(tasks) / seconds,
+               static_cast<double>(allocs) / static_cast<double>(tasks));
+    }
+
+    /**
+     * @brief 多个线程并发 post 空任务，等待全部执行完
+     * @param pool 已启动的线程池
+     * @param tasks 任务总数
+     * @param producers 提交线程数
+     */
+    void postConcurrently(thp::ThreadPool &pool, size_t tasks, size_t producers)
+    {
+        std::atomic<uint64_t> done{0};
+        std::vector<std::thread> threads;
+        threads.reserve(producers);
+        for (size_t p = 0; p < producers; ++p)
+        {
+            size_t count = tasks / producers + (p < tasks % producers ? 1 : 0);
+            threads.emplace_back([&pool, &done, count] {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    pool.post([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+        for (auto &thread: threads)
+        {
+            thread.join();
+        }
+        while (done.load(std::memory_order_relaxed) < tasks)
+        {
+            std::this_thread::yield();
+        }
+    }
+}// namespace
+
+// 统计堆分配次数
+void *operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+int main(int argc, char *argv[])
+{
+    const size_t tasks = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+    const size_t producers = std::max<size_t>(argc > 2 ? strtoul(argv[2], nullptr, 10) : 8, 1);
+    uint64_t sink = 0;
+
+    // 旧实现：packaged_task 放在 shared_ptr 中，再包一层 std::function 入队
+    run("legacy wrap", tasks, [&] {
+        std::queue<std::function<void()>> queue;
+        for (size_t i = 0; i < tasks; ++i)
+        {
+            auto task = std::make_shared<std::packaged_task<uint64_t()>>(std::bind([](size_t v) { return v; }, i));
+            std::future<uint64_t> result = task->get_future();
+            queue.emplace([task]() { (*task)(); });
+            queue.front()();
+            queue.pop();
+            sink += result.get();
+        }
+    });
+
+    // 新实现：可调用对象内联存放在 Task 中，共享状态由 SharedStateAllocator 分配
+    run("task wrap", tasks, [&] {
+        thp::TaskQueue queue;
+        for (size_t i = 0; i < tasks; ++i)
+        {
+            std::promise<uint64_t> promise(std::allocator_arg, thp::SharedStateAllocator<uint64_t>());
+            std::future<uint64_t> result = promise.get_future();
+            queue.emplace([promise = std::move(promise), i]() mutable { promise.set_value(i); });
+            queue.front()();
+            queue.pop();
+            sink += result.get();
+        }
+    });
+
+    {
+        thp::ThreadPool pool;
+        pool.setTaskQueMaxSize(tasks);
+        pool.start(4);
+        std::atomic<uint64_t> done{0};
+
+        run("pool post", tasks, [&] {
+            for (size_t i = 0; i < tasks; ++i)
+            {
+                pool.post([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+            while (done.load(std::memory_order_relaxed) < tasks)
+            {
+                std::this_thread::yield();
+            }
+        });
+
+        // 每批最多 kWindow 个未完成的 future（稳定运行时的典型情形），future 在计时范围内释放
+        const size_t kWindow = 1024;
+        std::vector<std::future<uint64_t>> results;
+        results.reserve(kWindow);
+        auto submitAll = [&] {
+            for (size_t i = 0; i < tasks; ++i)
+            {
+                results.push_back(pool.submitTask([](size_t v) { return static_cast<uint64_t>(v); }, i));
+                if (results.size() == kWindow || i + 1 == tasks)
+                {
+                    for (auto &result: results)
+                    {
+                        sink += result.get();
+                    }
+                    results.clear();
+                }
+            }
+        };
+        submitAll();// 预热：填充共享状态缓存
+        run("pool submitTask", tasks, submitAll);
+    }
+
+    for (bool lockFree: {false, true})
+    {
+        thp::ThreadPool pool;
+        pool.setTaskQueMaxSize(65536);
+        pool.setLockFreeQueue(lockFree);
+        pool.start(4);
+        postConcurrently(pool, tasks / 10, producers);// 预热
+        run(lockFree ? "mp post lock-free" : "mp post mutex", tasks, [&] { postConcurrently(pool, tasks, producers); });
+    }
+
+    printf("checksum %lu\n", sink);
+    return 0;
+}
@@ -0,0 +1,178 @@
+//
+// Created by shuzeyong on 2025/5/15.
+//
+
+#ifndef MY_MUDUO_ASYNCLOGGING_H
+#define MY_MUDUO_ASYNCLOGGING_H
+
+#include "LogFile.h"
+#include "NonCopyable.h"
+#include "SysHeadFile.h"
+#include "Thread.h"
+
+namespace net
+{
+    const size_t kSmallBuffer = 4000;       //!< 单行日志缓冲区大小
+    const size_t kLargeBuffer = 4000 * 1000;//!< 异步日志前端缓冲区大小（约 4MB）
+
+    /**
+     * @class FixedBuffer
+     * @brief 固定大小的日志缓冲区，只追加不扩容
+     * @tparam SIZE 缓冲区字节数
+     */
+    template<size_t SIZE>
+    class FixedBuffer : NonCopyable
+    {
+    public:
+        FixedBuffer()
+            : cur_(data_)
+        {}
+
+        /**
+         * @brief 追加数据，剩余空间不足时整条丢弃
+         * @param buf 数据起始地址
+         * @param len 数据长度
+         * @return 是否已追加
+         */
+        bool append(const char *buf, size_t len)
+        {
+            if (avail() > len)
+            {
+                memcpy(cur_, buf, len);
+                cur_ += len;
+                return true;
+            }
+            return false;
+        }
+
+        [[nodiscard]] const char *data() const { return data_; }
+        [[nodiscard]] size_t length() const { return static_cast<size_t>(cur_ - data_); }
+        [[nodiscard]] size_t avail() const { return static_cast<size_t>(end() - cur_); }
+
+        /**
+         * @brief 清空缓冲区（仅移动写指针，不清零内存）
+         */
+        void reset() { cur_ = data_; }
+
+    private:
+        [[nodiscard]] const char *end() const { return data_ + sizeof(data_); }
+
+        char data_[SIZE];//!< 数据存储区
+        char *cur_;      //!< 当前写入位置
+    };
+
+    /**
+     * @class AsyncLogging
+     * @brief 异步日志后端，采用双缓冲 + 后台线程批量写文件
+     *
+     * 工作方式：
+     * - 前端线程调用 [append()] 将日志行追加到当前缓冲区，只在缓冲区写满时才交换缓冲区
+     * - 后台线程每 [flushInterval_] 秒或有写满的缓冲区时被唤醒，批量写入 [LogFile] 并刷新
+     * - 日志文件按大小和按天滚动，可限制保留的文件数量
+     * - 待写缓冲区数量达到上限 [maxQueuedBuffers_] 时丢弃新日志行，保证内存占用有上界；
+     *   超过单个缓冲区容量的日志行同样丢弃，均计入 [droppedLines()] / [droppedBytes()]
+     *
+     * 使用方式：
+     * @code
+     * AsyncLogging asyncLog("/tmp/server", 500 * 1000 * 1000);
+     * asyncLog.start();
+     * Logger::getInstance().setOutput([&](const char *msg, size_t len) { asyncLog.append(msg, len); });
+     * Logger::getInstance().setFlush([&] { asyncLog.flush(); });
+     * @endcode
+     */
+    class AsyncLogging : NonCopyable
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param basename 日志文件名前缀（参见 [LogFile]）
+         * @param rollSize 单个日志文件的最大字节数
+         * @param flushInterval 后台线程刷新间隔（秒）
+         * @param maxQueuedBuffers 待写缓冲区上限，超过后丢弃日志
+         * @param maxFiles 最多保留的日志文件数量，0 表示不限制
+         */
+        AsyncLogging(std::string basename,
+                     off_t rollSize,
+                     int flushInterval = 3,
+                     size_t maxQueuedBuffers = 25,
+                     size_t maxFiles = 0);
+
+        /**
+         * @brief 析构函数，停止后台线程并写出剩余日志
+         */
+        ~AsyncLogging();
+
+        /**
+         * @brief 追加一条日志（线程安全，供前端线程调用）
+         * @param logline 日志内容
+         * @param len 日志长度
+         */
+        void append(const char *logline, size_t len);
+
+        /**
+         * @brief 启动后台写日志线程（[stop()] 之后可再次启动）
+         */
+        void start();
+
+        /**
+         * @brief 停止后台线程，写出所有已缓冲的日志
+         */
+        void stop();
+
+        /**
+         * @brief 同步刷新：阻塞直到调用前追加的日志全部写入文件
+         */
+        void flush();
+
+        /**
+         * @brief 获取被丢弃的日志行数（待写缓冲区达到上限或单行过长）
+         * @return 丢弃的日志行数
+         */
+        [[nodiscard]] uint64_t droppedLines() const;
+
+        /**
+         * @brief 获取被丢弃的日志字节数（待写缓冲区达到上限或单行过长）
+         * @return 丢弃的日志字节数
+         */
+        [[nodiscard]] uint64_t droppedBytes() const;
+
+    private:
+        using Buffer = FixedBuffer<kLargeBuffer>;
+        using BufferPtr = std::unique_ptr<Buffer>;
+        using BufferVector = std::vector<BufferPtr>;
+
+        /**
+         * @brief 后台线程入口，循环交换缓冲区并写文件
+         */
+        void threadFunc();
+
+        /**
+         * @brief 将一批缓冲区写入文件
+         * @param output 日志文件
+         * @param buffers 待写缓冲区
+         */
+        static void writeBuffers(LogFile &output, const BufferVector &buffers);
+
+        const int flushInterval_;       //!< 刷新间隔（秒）
+        const size_t maxQueuedBuffers_; //!< 待写缓冲区上限
+        std::atomic_bool running_;      //!< 后台线程运行标志
+        const std::string basename_;    //!< 日志文件名前缀
+        const off_t rollSize_;          //!< 单个日志文件的最大字节数
+        const size_t maxFiles_;         //!< 最多保留的日志文件数量
+        std::unique_ptr<Thread> thread_;//!< 后台写日志线程（每次 [start()] 新建）
+
+        std::mutex mutex_;                 //!< 保护下方缓冲区及刷新状态
+        std::condition_variable cond_;     //!< 唤醒后台线程
+        std::condition_variable flushDone_;//!< 通知 flush() 调用者刷新完成
+        BufferPtr currentBuffer_;          //!< 当前写入的缓冲区
+        BufferPtr nextBuffer_;             //!< 预备缓冲区
+        BufferVector buffers_;             //!< 已写满、等待后台写出的缓冲区
+        uint64_t flushRequested_;          //!< 已请求的刷新序号
+        uint64_t flushCompleted_;          //!< 已完成的刷新序号
+
+        std::atomic<uint64_t> droppedLines_;//!< 丢弃的日志行数
+        std::atomic<uint64_t> droppedBytes_;//!< 丢弃的日志字节数
+    };
+}// namespace net
+
+#endif//MY_MUDUO_ASYNCLOGGING_H
@@ -0,0 +1,281 @@
+//
+// Created by shuzeyong on 2025/5/17.
+//
+
+#ifndef MY_MUDUO_BINARYLOGGING_H
+#define MY_MUDUO_BINARYLOGGING_H
+
+#include "CurrentThread.h"
+#include "Logger.h"
+#include "NonCopyable.h"
+#include "SysHeadFile.h"
+#include "Thread.h"
+#include "Timestamp.h"
+
+/*
+ * 二进制结构化日志：适用于连接建立/关闭、逐请求追踪等高频事件。
+ *
+ * - [BinaryLogger] 启动后，LOG_INFO / LOG_DEBUG（参见 Logger.h）改走二进制路径；未启动时仍输出文本日志
+ * - 每个调用点首次执行时注册一次级别、格式串及参数类型，得到格式 ID
+ * - 运行期只把格式 ID、时间戳和参数原始字节 memcpy 进当前线程的环形缓冲区，不做 snprintf
+ * - 后台线程定期把各线程环形缓冲区的数据连同格式字典写入 basename.binlog
+ * - 使用 binlog_decoder 工具离线还原为文本
+ */
+namespace net
+{
+    /*
+     * 文件格式（小端）：
+     *   文件头   : kBinLogMagic（8 字节）
+     *   格式定义 : uint8 kBinLogFormatEntry, uint32 id, uint8 level, uint32 line, uint16 nargs, uint8 types[nargs],
+     *             uint32 fileLen, file, uint32 fmtLen, fmt
+     *   线程数据 : uint8 kBinLogChunkEntry, int32 tid, uint32 length, 若干条记录
+     *   记录     : uint32 id, int64 microSecondsSinceEpoch, uint16 payloadLen, 参数
+     *   参数     : 定长类型直接存放原始字节；字符串为 uint16 长度 + 内容
+     */
+    const char kBinLogMagic[8] = {'M', 'M', 'B', 'L', 'O', 'G', '0', '2'};
+    const uint8_t kBinLogFormatEntry = 1;
+    const uint8_t kBinLogChunkEntry = 2;
+    const size_t kBinLogMaxRecord = 1024;//!< 单条记录最大字节数，超长字符串会被截断
+
+    /**
+     * @enum BinArgType
+     * @brief 二进制日志参数类型
+     */
+    enum class BinArgType : uint8_t
+    {
+        kInt32,  ///< 有符号 32 位整数（含 char、short）
+        kUInt32, ///< 无符号 32 位整数（含 bool）
+        kInt64,  ///< 有符号 64 位整数
+        kUInt64, ///< 无符号 64 位整数
+        kDouble, ///< 浮点数
+        kString, ///< 字符串
+        kPointer ///< 指针
+    };
+
+    /**
+     * @brief 由 C++ 类型推导二进制参数类型
+     * @tparam T 参数类型
+     * @return 对应的 [BinArgType]
+     */
+    template<typename T>
+    constexpr BinArgType binArgType()
+    {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_enum_v<U>)
+        {
+            return binArgType<std::underlying_type_t<U>>();
+        }
+        else if constexpr (std::is_integral_v<U>)
+        {
+            if constexpr (std::is_signed_v<U>)
+            {
+                return sizeof(U) <= 4 ? BinArgType::kInt32 : BinArgType::kInt64;
+            }
+            else
+            {
+                return sizeof(U) <= 4 ? BinArgType::kUInt32 : BinArgType::kUInt64;
+            }
+        }
+        else if constexpr (std::is_floating_point_v<U>)
+        {
+            return BinArgType::kDouble;
+        }
+        else if constexpr (std::is_same_v<U, const char *> || std::is_same_v<U, char *> ||
+                           std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>)
+        {
+            return BinArgType::kString;
+        }
+        else
+        {
+            static_assert(std::is_pointer_v<U>, "unsupported binary log argument type");
+            return BinArgType::kPointer;
+        }
+    }
+
+    /**
+     * @class BinaryLogger
+     * @brief 二进制日志前后端：前端写线程本地环形缓冲区，后台线程落盘
+     *
+     * 使用方式：
+     * @code
+     * BinaryLogger::getInstance().start("/tmp/server");
+     * LOG_INFO("conn %s fd=%d up", name.c_str(), fd);// 写入 /tmp/server.binlog
+     * ...
+     * BinaryLogger::getInstance().stop();
+     * // 离线：binlog_decoder /tmp/server.binlog
+     * @endcode
+     *
+     * @note 环形缓冲区写满时丢弃新记录并计数（参见 [droppedRecords()]），前端永不阻塞
+     */
+    class BinaryLogger : NonCopyable
+    {
+    public:
+        /**
+         * @brief 获取单例
+         * @return BinaryLogger 实例
+         */
+        static BinaryLogger &getInstance();
+
+        /**
+         * @brief 二进制日志是否已启动（热路径判断）
+         * @return 已启动返回 true
+         */
+        static bool isRunning() { return running_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief 启动后台线程，写入 basename.binlog
+         * @param basename 文件名前缀
+         * @param flushIntervalMs 后台线程轮询间隔（毫秒）
+         * @param ringSize 每个线程环形缓冲区的大小（会向上取整为 2 的幂）
+         * @return 文件打开失败返回 false
+         */
+        bool start(const std::string &basename, int flushIntervalMs = 100, size_t ringSize = 256 * 1024);
+
+        /**
+         * @brief 停止后台线程，写出全部已缓冲的记录
+         */
+        void stop();
+
+        /**
+         * @brief 获取因环形缓冲区写满而丢弃的记录数
+         * @return 丢弃的记录数
+         */
+        [[nodiscard]] uint64_t droppedRecords() const;
+
+        /**
+         * @brief 写入一条二进制日志（由 LOG_INFO / LOG_DEBUG 在已启动时调用）
+         * @param siteId 调用点的格式 ID 缓存，0 表示尚未注册
+         * @param level 日志级别（仅注册时使用）
+         * @param file 源文件名
+         * @param line 行号
+         * @param fmt printf 风格格式串（仅注册时使用）
+         * @param args 参数
+         */
+        template<typename... Args>
+        void log(std::atomic_uint32_t *siteId, int level, const char *file, int line, const char *fmt,
+                 const Args &...args)
+        {
+            uint32_t id = siteId->load(std::memory_order_acquire);
+            if (__builtin_expect(id == 0, 0))
+            {
+                static constexpr BinArgType kTypes[sizeof...(Args) + 1] = {binArgType<Args>()...};
+                id = registerFormat(siteId, level, file, line, fmt, kTypes, sizeof...(Args));
+            }
+
+            // 在栈上编码整条记录，再一次性拷入环形缓冲区
+            char record[kBinLogMaxRecord];
+            char *p = record + kRecordHeaderSize;
+            char *end = record + sizeof(record);
+            (encodeArg(p, end, args), ...);
+
+            auto payloadLen = static_cast<uint16_t>(p - record - kRecordHeaderSize);
+            int64_t now = Timestamp::now().microSecondsSinceEpoch();
+            memcpy(record, &id, sizeof(id));
+            memcpy(record + 4, &now, sizeof(now));
+            memcpy(record + 12, &payloadLen, sizeof(payloadLen));
+            append(record, static_cast<size_t>(p - record));
+        }
+
+    private:
+        struct ThreadRing;
+        struct FormatEntry;
+
+        static const size_t kRecordHeaderSize = 4 + 8 + 2;//!< 记录头：id + 时间戳 + 负载长度
+
+        BinaryLogger();
+        ~BinaryLogger();
+
+        /**
+         * @brief 编码一个参数，空间不足时截断或丢弃
+         */
+        template<typename T>
+        static void encodeArg(char *&p, char *end, const T &arg)
+        {
+            constexpr BinArgType type = binArgType<T>();
+            if constexpr (type == BinArgType::kString)
+            {
+                std::string_view sv = toStringView(arg);
+                if (end - p < 2)
+                {
+                    return;
+                }
+                size_t n = std::min<size_t>({sv.size(), static_cast<size_t>(end - p - 2), 0xffff});
+                auto len = static_cast<uint16_t>(n);
+                memcpy(p, &len, sizeof(len));
+                memcpy(p + 2, sv.data(), n);
+                p += 2 + n;
+            }
+            else
+            {
+                using Stored = std::conditional_t<type == BinArgType::kInt32, int32_t,
+                               std::conditional_t<type == BinArgType::kUInt32, uint32_t,
+                               std::conditional_t<type == BinArgType::kInt64, int64_t,
+                               std::conditional_t<type == BinArgType::kUInt64, uint64_t,
+                               std::conditional_t<type == BinArgType::kDouble, double, uint64_t>>>>>;
+                Stored value;
+                if constexpr (type == BinArgType::kPointer)
+                {
+                    value = reinterpret_cast<uintptr_t>(arg);
+                }
+                else
+                {
+                    value = static_cast<Stored>(arg);
+                }
+                if (static_cast<size_t>(end - p) >= sizeof(value))
+                {
+                    memcpy(p, &value, sizeof(value));
+                    p += sizeof(value);
+                }
+            }
+        }
+
+        static std::string_view toStringView(const char *s) { return s ? std::string_view(s) : std::string_view("(null)"); }
+        static std::string_view toStringView(const std::string &s) { return s; }
+        static std::string_view toStringView(std::string_view s) { return s; }
+
+        /**
+         * @brief 注册调用点格式（每个调用点只执行一次）
+         * @return 格式 ID（从 1 开始）
+         */
+        uint32_t registerFormat(std::atomic_uint32_t *siteId, int level, const char *file, int line, const char *fmt,
+                                const BinArgType *types, size_t nargs);
+
+        /**
+         * @brief 将编码好的记录拷入当前线程的环形缓冲区
+         * @param record 记录起始地址
+         * @param len 记录长度
+         */
+        void append(const char *record, size_t len);
+
+        /**
+         * @brief 获取（必要时创建）当前线程的环形缓冲区
+         * @return 环形缓冲区
+         */
+        ThreadRing *threadRing();
+
+        /**
+         * @brief 后台线程入口
+         */
+        void threadFunc();
+
+        /**
+         * @brief 写出新注册的格式定义及各线程缓冲区中的记录
+         */
+        void drain();
+
+        inline static std::atomic_bool running_ = false;//!< 是否已启动
+
+        std::mutex mutex_;                              //!< 保护格式表、线程缓冲区列表
+        std::condition_variable cond_;                  //!< 唤醒后台线程
+        std::vector<FormatEntry> formats_;              //!< 已注册的格式（下标 + 1 为 ID）
+        std::vector<std::shared_ptr<ThreadRing>> rings_;//!< 所有线程的环形缓冲区
+        size_t emittedFormats_;                         //!< 已写入文件的格式数量
+        size_t ringSize_;                               //!< 新建环形缓冲区的大小
+        int flushIntervalMs_;                           //!< 后台线程轮询间隔
+        FILE *fp_;                                      //!< 输出文件
+        std::unique_ptr<Thread> thread_;                //!< 后台线程
+        std::atomic<uint64_t> droppedRecords_;          //!< 丢弃的记录数
+    };
+}// namespace net
+
+#endif//MY_MUDUO_BINARYLOGGING_H
@@ -5,6 +5,7 @@
 #ifndef MY_MUDUO_BUFFER_H
 #define MY_MUDUO_BUFFER_H
 
+#include "NgxBlockSource.h"
 #include "SysHeadFile.h"
 
 namespace net
@@ -44,8 +45,11 @@ namespace net
         /**
          * @brief 构造函数
          * @param initialSize 初始缓冲区大小，默认为 kInitialSize
+         * @param source 存储的内存来源，默认为 malloc/free（大缓冲区可使用 NgxMmapBlockSource 启用大页）；
+         *               存储不足 2MB 时仍使用 malloc/free，扩容到 2MB 及以上才从该来源申请
          */
-        explicit Buffer(size_t initialSize = kInitialSize);
+        explicit Buffer(size_t initialSize = kInitialSize,
+                        NgxBlockSource *source = NgxBlockSource::mallocSource());
 
         /**
          * @brief 获取当前可读数据的字节数
@@ -65,6 +69,18 @@ namespace net
          */
         [[nodiscard]] size_t prependableBytes() const;
 
+        /**
+         * @brief 获取底层存储已分配的字节数（含前置预留空间）
+         * @return 已分配的字节数
+         */
+        [[nodiscard]] size_t internalCapacity() const;
+
+        /**
+         * @brief 获取可读数据的起始地址（不移动 readerIndex）
+         * @return 可读数据的起始地址
+         */
+        [[nodiscard]] const char *peek() const;
+
         /**
          * @brief 标记已读取 len 字节，移动 readerIndex
          * @param len 已读取的字节数
@@ -162,9 +178,9 @@ namespace net
         void ensureWritableBytes(size_t len);
 
     private:
-        std::vector<char> buffer_;          //!< 实际存储数据的容器
-        size_t readerIndex_ = kCheapPrepend;//!< 当前可读位置索引
-        size_t writerIndex_ = kCheapPrepend;//!< 当前可写位置索引
+        std::vector<char, NgxBlockAllocator<char>> buffer_;//!< 实际存储数据的容器（从内存来源申请）
+        size_t readerIndex_ = kCheapPrepend;               //!< 当前可读位置索引
+        size_t writerIndex_ = kCheapPrepend;               //!< 当前可写位置索引
     };
 }// namespace net
 
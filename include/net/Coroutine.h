@@ -0,0 +1,266 @@
+//
+// Created by shuzeyong on 2025/5/18.
+//
+
+#ifndef MY_MUDUO_COROUTINE_H
+#define MY_MUDUO_COROUTINE_H
+
+#include "Logger.h"
+#include "SysHeadFile.h"
+
+#include <coroutine>
+#include <optional>
+
+namespace net
+{
+    template<typename T = void>
+    class CoTask;
+
+    namespace detail
+    {
+        /**
+         * @class CoPromiseBase
+         * @brief [CoTask] 的 promise 公共部分：惰性启动、结束时对称转移回等待者
+         */
+        class CoPromiseBase
+        {
+        public:
+            /**
+             * @struct FinalAwaiter
+             * @brief 协程结束时恢复等待者；已分离的协程自行销毁
+             */
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept { return false; }
+
+                template<typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+                {
+                    CoPromiseBase &promise = handle.promise();
+                    if (promise.continuation_)
+                    {
+                        return promise.continuation_;
+                    }
+                    if (promise.detached_)
+                    {
+                        promise.reportDetachedException();
+                        handle.destroy();
+                    }
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+
+            void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+            void setContinuation(std::coroutine_handle<> continuation) { continuation_ = continuation; }
+            void setDetached() { detached_ = true; }
+
+        protected:
+            void rethrowIfFailed() const
+            {
+                if (exception_)
+                {
+                    std::rethrow_exception(exception_);
+                }
+            }
+
+        private:
+            /**
+             * @brief 分离的协程没有等待者接收异常，只能记录日志
+             */
+            void reportDetachedException() const noexcept
+            {
+                if (!exception_)
+                {
+                    return;
+                }
+                try
+                {
+                    std::rethrow_exception(exception_);
+                } catch (const std::exception &e)
+                {
+                    LOG_ERROR("detached coroutine threw: %s", e.what());
+                } catch (...)
+                {
+                    LOG_ERROR("detached coroutine threw an unknown exception");
+                }
+            }
+
+            std::coroutine_handle<> continuation_;//!< 等待本协程完成的协程
+            std::exception_ptr exception_;        //!< 协程体抛出的异常
+            bool detached_ = false;               //!< 是否已分离（无等待者）
+        };
+
+        template<typename T>
+        class CoPromise : public CoPromiseBase
+        {
+        public:
+            CoTask<T> get_return_object() noexcept;
+
+            template<typename U>
+            void return_value(U &&value)
+            {
+                value_.emplace(std::forward<U>(value));
+            }
+
+            T result()
+            {
+                rethrowIfFailed();
+                return std::move(*value_);
+            }
+
+        private:
+            std::optional<T> value_;//!< 协程返回值
+        };
+
+        template<>
+        class CoPromise<void> : public CoPromiseBase
+        {
+        public:
+            CoTask<void> get_return_object() noexcept;
+
+            void return_void() const noexcept {}
+
+            void result() const
+            {
+                rethrowIfFailed();
+            }
+        };
+    }// namespace detail
+
+    /**
+     * @class CoTask
+     * @brief 惰性启动的协程任务类型
+     * @tparam T 协程返回值类型
+     *
+     * - 创建后不立即执行，被 co_await 时才启动，完成后直接（对称转移）恢复等待者
+     * - 顶层协程调用 [detach()] 启动，结束后自行销毁协程帧
+     * - 除协程帧外不额外分配内存
+     *
+     * 配合 [TcpConnection::read()]、[TcpConnection::write()]、[EventLoop::sleep()] 等
+     * 可等待对象，以顺序代码编写协议处理逻辑，所有 IO 均在连接所属的事件循环线程中恢复：
+     * @code
+     * net::CoTask<> session(net::TcpConnectionPtr conn)
+     * {
+     *     while (auto line = co_await conn->readUntil("\r\n"))
+     *     {
+     *         std::string reply(*line);
+     *         if (!co_await conn->write(reply))
+     *         {
+     *             break;
+     *         }
+     *     }
+     * }
+     *
+     * server.setConnectionCallback([](const net::TcpConnectionPtr &conn) {
+     *     if (conn->isConnected())
+     *     {
+     *         session(conn).detach();
+     *     }
+     * });
+     * @endcode
+     */
+    template<typename T>
+    class CoTask
+    {
+    public:
+        using promise_type = detail::CoPromise<T>;
+        using Handle = std::coroutine_handle<promise_type>;
+
+        CoTask() noexcept = default;
+
+        explicit CoTask(Handle handle) noexcept
+            : handle_(handle)
+        {}
+
+        CoTask(CoTask &&other) noexcept
+            : handle_(std::exchange(other.handle_, nullptr))
+        {}
+
+        CoTask &operator=(CoTask &&other) noexcept
+        {
+            if (this != &other)
+            {
+                destroy();
+                handle_ = std::exchange(other.handle_, nullptr);
+            }
+            return *this;
+        }
+
+        CoTask(const CoTask &) = delete;
+        CoTask &operator=(const CoTask &) = delete;
+
+        ~CoTask()
+        {
+            destroy();
+        }
+
+        /**
+         * @brief 等待协程完成并获取结果（协程体抛出的异常在此重新抛出）
+         */
+        auto operator co_await() &&noexcept
+        {
+            struct Awaiter
+            {
+                Handle handle;
+
+                bool await_ready() const noexcept { return !handle || handle.done(); }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+                {
+                    handle.promise().setContinuation(continuation);
+                    return handle;
+                }
+
+                T await_resume() { return handle.promise().result(); }
+            };
+            return Awaiter{handle_};
+        }
+
+        /**
+         * @brief 分离并启动协程，协程结束后自行销毁；未捕获的异常记录到日志
+         */
+        void detach()
+        {
+            if (handle_)
+            {
+                Handle handle = std::exchange(handle_, nullptr);
+                handle.promise().setDetached();
+                handle.resume();
+            }
+        }
+
+    private:
+        void destroy()
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+                handle_ = nullptr;
+            }
+        }
+
+        Handle handle_;//!< 协程句柄
+    };
+
+    namespace detail
+    {
+        template<typename T>
+        CoTask<T> CoPromise<T>::get_return_object() noexcept
+        {
+            return CoTask<T>(std::coroutine_handle<CoPromise<T>>::from_promise(*this));
+        }
+
+        inline CoTask<void> CoPromise<void>::get_return_object() noexcept
+        {
+            return CoTask<void>(std::coroutine_handle<CoPromise<void>>::from_promise(*this));
+        }
+    }// namespace detail
+}// namespace net
+
+#endif//MY_MUDUO_COROUTINE_H
@@ -7,11 +7,17 @@
 
 #include "Channel.h"
 #include "CurrentThread.h"
+#include "Metrics.h"
 #include "NonCopyable.h"
+#include "ObjectPool.h"
 #include "Poller.h"
 #include "SysHeadFile.h"
+#include "TimerQueue.h"
 #include "Timestamp.h"
 
+#include <coroutine>
+#include <optional>
+
 namespace net
 {
     class Poller;
@@ -68,6 +74,141 @@ namespace net
          */
         void queueInLoop(const Functor &cb);
 
+        /**
+         * @brief 将任务放入异步队列等待执行（移动版本）
+         * @param cb 需要执行的任务函数
+         */
+        void queueInLoop(Functor &&cb);
+
+        /**
+         * @brief 将 work 交给线程池执行，完成后在本事件循环线程中以其返回值调用 cont
+         * @tparam Pool 线程池类型（如 thp::ThreadPool，需提供 bool tryPost(F)）
+         * @param pool 线程池
+         * @param work 在线程池中执行的任务，签名为 R()
+         * @param cont 在本事件循环线程中执行的后续操作，签名为 void(R)（R 为 void 时为 void()）
+         * @return 任务已入队返回 true；队列已满或线程池已停止返回 false，此时 work 与 cont 都不会执行
+         *
+         * 通过 tryPost 提交：队列已满时不论拒绝策略如何都直接拒绝，事件循环线程既不阻塞，也不会内联执行 work。
+         * 事件循环线程不等待结果；同一轮循环内完成的多个任务，其后续操作只唤醒事件循环一次。
+         * work 抛出的异常由线程池记录，cont 不会执行。
+         *
+         * 使用方式：
+         * @code
+         * loop->offload(pool, [req]() { return compute(req); }, [](Response resp) { ... });
+         * @endcode
+         *
+         * @note 本事件循环必须比提交的任务存活更久；处理连接时使用 [TcpConnection::offload()]
+         * @note 返回 true 后，其他提交者在 DISCARD_OLDEST 策略下仍可能丢弃已排队的任务，此时 work 与 cont 都不会执行，
+         *       调用方也得不到任何通知；用于 offload 的线程池不应使用该策略
+         */
+        template<typename Pool, typename Work, typename Cont>
+        bool offload(Pool &pool, Work &&work, Cont &&cont)
+        {
+            using Result = std::invoke_result_t<std::decay_t<Work> &>;
+            using Storage = std::conditional_t<std::is_void_v<Result>, bool, Result>;
+
+            // work、cont 与结果放在同一块共享状态中：只分配一次，且投递回本线程的回调可拷贝（Functor 要求）
+            struct State
+            {
+                std::decay_t<Work> work;
+                std::decay_t<Cont> cont;
+                std::optional<Storage> result;
+            };
+            auto state = std::make_shared<State>(State{std::forward<Work>(work), std::forward<Cont>(cont), std::nullopt});
+
+            return pool.tryPost([this, state]() {
+                if constexpr (std::is_void_v<Result>)
+                {
+                    state->work();
+                }
+                else
+                {
+                    state->result.emplace(state->work());
+                }
+                queueInLoop([state]() {
+                    if constexpr (std::is_void_v<Result>)
+                    {
+                        state->cont();
+                    }
+                    else
+                    {
+                        state->cont(std::move(*state->result));
+                    }
+                });
+            });
+        }
+
+        /**
+         * @brief 在指定时间执行回调（线程安全）
+         * @param time 到期时间（[Timestamp::monotonic()] 时钟）
+         * @param cb 定时器回调
+         * @return 定时器标识
+         */
+        TimerId runAt(Timestamp time, Functor cb);
+
+        /**
+         * @brief 延迟一段时间后执行回调（线程安全）
+         * @param delay 延迟时间
+         * @param cb 定时器回调
+         * @return 定时器标识
+         */
+        TimerId runAfter(std::chrono::nanoseconds delay, Functor cb);
+
+        /**
+         * @brief 每隔一段时间执行一次回调（线程安全）
+         * @param interval 执行间隔
+         * @param cb 定时器回调
+         * @return 定时器标识
+         */
+        TimerId runEvery(std::chrono::nanoseconds interval, Functor cb);
+
+        /**
+         * @brief 取消定时器（线程安全）
+         * @param timerId 定时器标识
+         */
+        void cancel(TimerId timerId);
+
+        /**
+         * @brief 协程中挂起一段时间，到期后在本事件循环线程中恢复
+         * @param delay 挂起时长
+         *
+         * 使用方式：
+         * @code
+         * co_await loop->sleep(std::chrono::milliseconds(100));
+         * @endcode
+         */
+        auto sleep(std::chrono::nanoseconds delay)
+        {
+            struct Awaiter
+            {
+                EventLoop *loop;
+                std::chrono::nanoseconds delay;
+
+                bool await_ready() const noexcept { return delay.count() <= 0; }
+                void await_suspend(std::coroutine_handle<> handle) { loop->runAfter(delay, [handle]() { handle.resume(); }); }
+                void await_resume() const noexcept {}
+            };
+            return Awaiter{this, delay};
+        }
+
+        /**
+         * @brief 协程切换到本事件循环线程执行（已在本线程时不挂起）
+         *
+         * 常与 thp::ThreadPool::schedule() 配合：在线程池中完成计算后回到连接所属的事件循环
+         */
+        auto schedule()
+        {
+            struct Awaiter
+            {
+                EventLoop *loop;
+
+                bool await_ready() const noexcept { return loop->isInLoopThread(); }
+                void await_suspend(std::coroutine_handle<> handle) { loop->queueInLoop([handle]() { handle.resume(); }); }
+                void await_resume() const noexcept {}
+            };
+            return Awaiter{this};
+        }
+
         /**
          * @brief 唤醒事件循环（跨线程安全）
          */
@@ -91,33 +232,74 @@ namespace net
          */
         [[nodiscard]] bool isInLoopThread() const;
 
+        /**
+         * @brief 获取本轮 poll 返回时缓存的当前时间（CLOCK_REALTIME）
+         * @return 缓存的时间戳
+         *
+         * 同一轮事件处理中的回调共享该值，避免反复读取时钟；
+         * 精度受本轮回调执行耗时影响，需要精确时间时调用 [Timestamp::now()]
+         * @note 只应在事件循环线程中调用
+         */
+        [[nodiscard]] Timestamp now() const { return pollReturnTime_; }
+
+        /**
+         * @brief 获取本轮 poll 返回时缓存的单调时钟（CLOCK_MONOTONIC），用于计算时间间隔
+         * @return 缓存的单调时间戳
+         * @note 只应在事件循环线程中调用
+         */
+        [[nodiscard]] Timestamp monotonicNow() const { return pollReturnMonotonic_; }
+
+        /**
+         * @brief 获取本事件循环的指标分片
+         * @return 指标分片
+         * @note 只应在事件循环线程中写入；读取汇总数据使用 [MetricsRegistry]
+         */
+        LoopMetrics &metrics() { return metrics_; }
+
+        /**
+         * @brief 获取本事件循环的连接对象池
+         * @return 连接对象池
+         * @note 只应在事件循环线程中分配（池的所属线程为第一次分配的线程）；连接通常也在本线程析构，释放不经过远程释放栈
+         */
+        [[nodiscard]] const std::shared_ptr<SlabPool> &connectionPool() const { return connectionPool_; }
+
     private:
         /**
          * @brief 处理 [wakeupFd_] 的可读事件（唤醒事件）
          */
-        void handleRead() const;
+        void handleRead();
 
         /**
          * @brief 执行异步任务队列
          */
         void doPendingFunctors();
 
+        /**
+         * @brief 任务入队后按需唤醒事件循环（已有未处理的唤醒时不再重复写 eventfd）
+         */
+        void wakeupIfNeeded();
+
         using ChannelList = std::vector<Channel *>;//!< 定义事件通道列表类型
 
         std::atomic_bool looping_;//!< 事件循环运行状态标志
         std::atomic_bool quit_;   //!< 退出请求标志
 
         const pid_t threadId_;//!< 所属线程ID（用于线程安全检查）
+        LoopMetrics metrics_; //!< 指标分片（先于其他成员构造、后于其他成员析构）
 
         Timestamp pollReturnTime_;      //!< 最近一次 poll 调用的时间戳
+        Timestamp pollReturnMonotonic_; //!< 最近一次 poll 返回时的单调时钟
         std::unique_ptr<Poller> poller_;//!< 多路复用器（Epoll/Poll 的抽象）
 
-        int wakeupFd_;                          //!< 唤醒文件描述符，用于跨线程唤醒事件循环
-        std::unique_ptr<Channel> wakeupChannel_;//!< 唤醒事件通道，用于监听唤醒事件
+        int wakeupFd_;                            //!< 唤醒文件描述符，用于跨线程唤醒事件循环
+        std::unique_ptr<Channel> wakeupChannel_;  //!< 唤醒事件通道，用于监听唤醒事件
+        std::unique_ptr<TimerQueue> timerQueue_;  //!< 定时器队列
+        std::shared_ptr<SlabPool> connectionPool_;//!< 连接对象池（连接与 shared_ptr 控制块共用一块）
 
         ChannelList activeChannels_;//!< 当前活跃的事件通道列表
 
         std::atomic_bool callingPendingFunctors_;//!< 标识是否正在执行待处理的任务函数
+        std::atomic_bool wakeupPending_;         //!< 已唤醒但尚未开始处理任务队列（用于合并唤醒）
         std::vector<Functor> pendingFunctors_;   //!< 待处理的任务函数队列
         std::mutex mutex_;                       //!< 互斥锁，用于保护待处理任务队列的线程安全
     };
@@ -0,0 +1,125 @@
+//
+// Created by shuzeyong on 2025/5/16.
+//
+
+#ifndef MY_MUDUO_LOGFILE_H
+#define MY_MUDUO_LOGFILE_H
+
+#include "NonCopyable.h"
+#include "SysHeadFile.h"
+
+namespace net
+{
+    /**
+     * @class LogFile
+     * @brief 滚动日志文件，按大小和按天切换文件，并限制保留的文件数量
+     *
+     * 核心特性：
+     * - 单个文件写入超过 [rollSize_] 字节时切换到新文件
+     * - 跨过本地时间零点后切换到新文件
+     * - [maxFiles_] 非 0 时只保留最近生成的若干个文件，旧文件被删除，磁盘占用有上界；
+     *   启动时扫描目录，把之前运行留下的同名前缀日志文件一并计入
+     * - 每 [checkEveryN_] 次写入才检查一次时间，按 [flushInterval_] 秒定期刷新
+     *
+     * 文件名格式：basename.YYYYmmdd-HHMMSS.hostname.pid.log
+     *
+     * @note 作为 [AsyncLogging] 后端时由单个线程访问，可关闭内部锁（threadSafe = false）
+     */
+    class LogFile : NonCopyable
+    {
+    public:
+        /**
+         * @brief 构造函数，立即创建第一个日志文件
+         * @param basename 日志文件名前缀（可含目录）
+         * @param rollSize 单个文件的最大字节数
+         * @param threadSafe 是否对写入加锁
+         * @param flushInterval 刷新间隔（秒）
+         * @param checkEveryN 每写入多少次检查一次时间
+         * @param maxFiles 最多保留的文件数量，0 表示不限制
+         */
+        LogFile(std::string basename,
+                off_t rollSize,
+                bool threadSafe = true,
+                int flushInterval = 3,
+                int checkEveryN = 1024,
+                size_t maxFiles = 0);
+
+        /**
+         * @brief 析构函数，刷新并关闭当前文件
+         */
+        ~LogFile();
+
+        /**
+         * @brief 追加一段日志数据
+         * @param logline 日志内容
+         * @param len 日志长度
+         */
+        void append(const char *logline, size_t len);
+
+        /**
+         * @brief 将用户态缓冲刷新到内核
+         */
+        void flush();
+
+        /**
+         * @brief 切换到新的日志文件
+         * @return 成功切换返回 true；同一秒内重复切换返回 false
+         */
+        bool rollFile();
+
+    private:
+        /**
+         * @brief 不加锁的追加实现
+         * @param logline 日志内容
+         * @param len 日志长度
+         */
+        void appendUnlocked(const char *logline, size_t len);
+
+        /**
+         * @brief 计算某时刻所在的本地自然日序号
+         * @param now 时间（秒）
+         * @return 自然日序号
+         */
+        [[nodiscard]] time_t periodOf(time_t now) const;
+
+        /**
+         * @brief 扫描日志目录，把已存在的 basename.YYYYmmdd-HHMMSS.*.log 文件按时间先后加入 [files_]
+         */
+        void scanOldFiles();
+
+        /**
+         * @brief 删除超出保留数量的旧文件
+         */
+        void removeOldFiles();
+
+        /**
+         * @brief 生成日志文件名
+         * @param basename 文件名前缀
+         * @param now 当前时间（秒）
+         * @return 日志文件名
+         */
+        static std::string getLogFileName(const std::string &basename, time_t now);
+
+        static const int kRollPerSeconds = 60 * 60 * 24;//!< 按天滚动的周期（秒）
+
+        const std::string basename_;//!< 日志文件名前缀
+        const off_t rollSize_;      //!< 单个文件的最大字节数
+        const int flushInterval_;   //!< 刷新间隔（秒）
+        const int checkEveryN_;     //!< 每写入多少次检查一次时间
+        const size_t maxFiles_;     //!< 最多保留的文件数量（0 表示不限制）
+        const long gmtOffset_;      //!< 本地时区相对 UTC 的偏移（秒），用于按本地零点滚动
+
+        int count_;                        //!< 距上次检查时间的写入次数
+        std::unique_ptr<std::mutex> mutex_;//!< 写入锁（threadSafe 为 false 时为空）
+        time_t startOfPeriod_;             //!< 当前文件所属的自然日序号
+        time_t lastRoll_;                  //!< 上次切换文件的时间
+        time_t lastFlush_;                 //!< 上次刷新的时间
+
+        FILE *fp_;                     //!< 当前日志文件
+        off_t writtenBytes_;           //!< 当前文件已写入字节数
+        std::deque<std::string> files_;//!< 已存在和本对象生成的日志文件（按时间先后）
+        char buffer_[64 * 1024];       //!< stdio 用户态缓冲区
+    };
+}// namespace net
+
+#endif//MY_MUDUO_LOGFILE_H
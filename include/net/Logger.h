@@ -8,65 +8,116 @@
 #include "NonCopyable.h"
 #include "SysHeadFile.h"
 
+/*
+ * 编译期日志级别下限：低于 LOG_ACTIVE_LEVEL 的日志宏展开为空语句，参数不会被求值。
+ * 例如编译时加 -DLOG_ACTIVE_LEVEL=1 即可彻底去掉所有 LOG_DEBUG。
+ * （预处理阶段无法使用枚举，因此这里用数值宏，与 [LogLevel] 一一对应）
+ */
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_ERROR 2
+#define LOG_LEVEL_FATAL 3
+
+#ifndef LOG_ACTIVE_LEVEL
+#define LOG_ACTIVE_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+/*
+ * 日志所属模块：源文件可在包含任何头文件之前定义 LOG_MODULE，
+ * 使本文件内的日志使用独立的运行期级别，例如：
+ *     #define LOG_MODULE net::LogModule::kChannel
+ */
+#ifndef LOG_MODULE
+#define LOG_MODULE net::LogModule::kDefault
+#endif
+
 namespace net
 {
 // LOG_INFO("%s, %d", arg1, arg2)
-class Logger;
-#define LOG_INFO(logmsgFormat, ...)                       \
-    do                                                    \
-    {                                                     \
-        Logger &logger = Logger::getInstance();           \
-        logger.setLogLevel(INFO);                         \
-        char buf[1024] = {};                              \
-        snprintf(buf, 1024, logmsgFormat, ##__VA_ARGS__); \
-        logger.log(buf);                                  \
+// 先做一次级别判断，未开启的级别不会进行任何格式化工作
+#define LOG_IMPL(level, logmsgFormat, ...)                                  \
+    do                                                                      \
+    {                                                                       \
+        if (net::Logger::isEnabled(LOG_MODULE, level))                      \
+        {                                                                   \
+            net::Logger::getInstance().log(level, logmsgFormat, ##__VA_ARGS__); \
+        }                                                                   \
     } while (0)
 
-#define LOG_ERROR(logmsgFormat, ...)                      \
-    do                                                    \
-    {                                                     \
-        Logger &logger = Logger::getInstance();           \
-        logger.setLogLevel(ERROR);                        \
-        char buf[1024] = {};                              \
-        snprintf(buf, 1024, logmsgFormat, ##__VA_ARGS__); \
-        logger.log(buf);                                  \
+// 高频的 INFO / DEBUG 日志：[BinaryLogger] 启动后只记录格式 ID 与参数原始字节，未启动时输出文本
+#define LOG_IMPL_BINARY(level, logmsgFormat, ...)                                                           \
+    do                                                                                                      \
+    {                                                                                                       \
+        if (net::Logger::isEnabled(LOG_MODULE, level))                                                      \
+        {                                                                                                   \
+            if (net::BinaryLogger::isRunning())                                                             \
+            {                                                                                               \
+                static std::atomic_uint32_t binLogSiteId_{0};                                               \
+                net::BinaryLogger::getInstance().log(&binLogSiteId_, level, __FILE__, __LINE__, logmsgFormat, \
+                                                     ##__VA_ARGS__);                                        \
+            }                                                                                               \
+            else                                                                                            \
+            {                                                                                               \
+                net::Logger::getInstance().log(level, logmsgFormat, ##__VA_ARGS__);                         \
+            }                                                                                               \
+        }                                                                                                   \
     } while (0)
 
-#define LOG_FATAL(logmsgFormat, ...)                      \
-    do                                                    \
-    {                                                     \
-        Logger &logger = Logger::getInstance();           \
-        logger.setLogLevel(FATAL);                        \
-        char buf[1024] = {};                              \
-        snprintf(buf, 1024, logmsgFormat, ##__VA_ARGS__); \
-        logger.log(buf);                                  \
-        exit(-1);                                         \
-    } while (0)
+#if LOG_ACTIVE_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(logmsgFormat, ...) LOG_IMPL_BINARY(net::INFO, logmsgFormat, ##__VA_ARGS__)
+#else
+#define LOG_INFO(logmsgFormat, ...) \
+    do {} while (0)
+#endif
 
-#ifdef DEBUG
-#define LOG_DEBUG(logmsgFormat, ...)                      \
-    do                                                    \
-    {                                                     \
-        Logger &logger = Logger::getInstance();           \
-        logger.setLogLevel(DEBUG);                        \
-        char buf[1024] = {};                              \
-        snprintf(buf, 1024, logmsgFormat, ##__VA_ARGS__); \
-        logger.log(buf);                                  \
+#if LOG_ACTIVE_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(logmsgFormat, ...) LOG_IMPL(net::ERROR, logmsgFormat, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(logmsgFormat, ...) \
+    do {} while (0)
+#endif
+
+// FATAL 日志不受级别过滤，记录后终止进程
+#define LOG_FATAL(logmsgFormat, ...)                                             \
+    do                                                                           \
+    {                                                                            \
+        net::Logger::getInstance().log(net::FATAL, logmsgFormat, ##__VA_ARGS__); \
+        exit(-1);                                                                \
     } while (0)
+
+#if LOG_ACTIVE_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(logmsgFormat, ...) LOG_IMPL_BINARY(net::DEBUG, logmsgFormat, ##__VA_ARGS__)
 #else
-#define LOG_DEBUG(logmsgFormat, ...)
+#define LOG_DEBUG(logmsgFormat, ...) \
+    do {} while (0)
 #endif
 
 /**
      * @enum LogLevel
-     * @brief 定义日志级别
+     * @brief 定义日志级别（数值越大越严重，只输出不低于阈值的日志）
      */
 enum LogLevel
 {
-    INFO,  ///< 普通信息
-    ERROR, ///< 错误信息
-    FATAL, ///< 严重错误信息（程序终止）
-    DEBUG  ///< 调试信息
+    DEBUG = LOG_LEVEL_DEBUG, ///< 调试信息
+    INFO = LOG_LEVEL_INFO,   ///< 普通信息
+    ERROR = LOG_LEVEL_ERROR, ///< 错误信息
+    FATAL = LOG_LEVEL_FATAL  ///< 严重错误信息（程序终止）
+};
+
+/**
+     * @enum LogModule
+     * @brief 日志模块，每个模块拥有独立的运行期日志级别
+     */
+enum class LogModule
+{
+    kDefault,      ///< 未指定模块的日志
+    kEventLoop,    ///< EventLoop / EventLoopThread
+    kPoller,       ///< Poller / EPollPoller
+    kChannel,      ///< Channel
+    kAcceptor,     ///< Acceptor / Socket
+    kTcpServer,    ///< TcpServer
+    kTcpConnection,///< TcpConnection
+    kNumModules    ///< 模块数量（非模块）
 };
 
 /**
@@ -74,15 +125,19 @@ enum LogLevel
      * @brief 日志类，提供日志记录功能
      *
      * 本类实现单例模式，提供以下功能：
-     * - 支持不同级别的日志记录（INFO、ERROR、FATAL、DEBUG）
-     * - 提供日志级别设置接口
+     * - 支持不同级别的日志记录（DEBUG、INFO、ERROR、FATAL）
+     * - 全局及按模块设置运行期日志级别，级别判断先于格式化
      * - 提供日志写入接口
+     * - 支持替换输出端（默认写 stdout，可接入 [AsyncLogging] 等后端）
      *
      * @note 该类不可拷贝（继承 [NonCopyable]）
      */
 class Logger : NonCopyable
 {
 public:
+    using OutputFunc = std::function<void(const char *msg, size_t len)>;//!< 日志输出函数类型
+    using FlushFunc = std::function<void()>;                            //!< 日志刷新函数类型
+
     /**
          * @brief 获取日志类的唯一单例
          * @return 返回 Logger 实例的引用
@@ -90,20 +145,66 @@ public:
     static Logger &getInstance();
 
     /**
-         * @brief 设置日志级别
+         * @brief 判断某模块的某级别日志是否需要输出（热路径，仅一次原子读和比较）
+         * @param module 日志模块
+         * @param level 日志级别
+         * @return 需要输出返回 true
+         */
+    static bool isEnabled(LogModule module, int level)
+    {
+        return level >= moduleLevels_[static_cast<int>(module)].load(std::memory_order_relaxed);
+    }
+
+    /**
+         * @brief 设置所有模块的最低输出级别（线程安全）
          * @param level 日志级别（参见 [LogLevel]）
          */
-    void setLogLevel(int level);
+    static void setLogLevel(int level);
+
+    /**
+         * @brief 设置单个模块的最低输出级别（线程安全）
+         * @param module 日志模块
+         * @param level 日志级别（参见 [LogLevel]）
+         */
+    static void setModuleLogLevel(LogModule module, int level);
+
+    /**
+         * @brief 获取模块当前的最低输出级别
+         * @param module 日志模块
+         * @return 日志级别
+         */
+    static int getLogLevel(LogModule module = LogModule::kDefault);
 
     /**
-         * @brief 写入日志
-         * @param msg 日志消息内容
+         * @brief 设置日志输出函数（需在多线程写日志之前设置）
+         * @param out 接收一条完整日志行（含换行符）的输出函数
          */
-    void log(const std::string &msg) const;
+    void setOutput(OutputFunc out);
+
+    /**
+         * @brief 设置日志刷新函数，FATAL 日志退出进程前会调用
+         * @param flush 刷新函数
+         */
+    void setFlush(FlushFunc flush);
+
+    /**
+         * @brief 格式化并写入一条日志（调用方负责级别判断）
+         * @param level 日志级别
+         * @param fmt printf 风格的格式串
+         */
+    void log(int level, const char *fmt, ...) const __attribute__((format(printf, 3, 4)));
 
 private:
-    int level_; //!< 当前日志级别
+    Logger();
+
+    static std::atomic_int moduleLevels_[static_cast<int>(LogModule::kNumModules)];//!< 各模块最低输出级别
+
+    OutputFunc output_; //!< 日志输出函数
+    FlushFunc flush_;   //!< 日志刷新函数
 };
 }// namespace net
 
+// LOG_INFO / LOG_DEBUG 展开时需要 BinaryLogger；放在末尾包含，此时 Logger 已完整定义
+#include "BinaryLogging.h"
+
 #endif//MY_MUDUO_LOGGER_H
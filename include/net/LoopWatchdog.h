@@ -0,0 +1,105 @@
+//
+// Created by shuzeyong on 2025/5/25.
+//
+
+#ifndef MY_MUDUO_LOOPWATCHDOG_H
+#define MY_MUDUO_LOOPWATCHDOG_H
+
+#include "Metrics.h"
+#include "NonCopyable.h"
+#include "SysHeadFile.h"
+
+#include <chrono>
+#include <csignal>
+
+namespace net
+{
+    /**
+     * @class LoopWatchdog
+     * @brief 事件循环看门狗：检测卡在某个回调中的事件循环，并测量事件循环延迟
+     *
+     * 后台线程每隔 interval 检查 [MetricsRegistry] 中登记的所有事件循环：
+     * - 卡顿检测：一轮事件处理（I/O 分发或异步任务）持续超过 threshold 时记录一条错误日志，
+     *   包含所处阶段、正在分发的 fd 以及正在执行的任务/定时器回调的类型（lambda 类型名含定义它的函数，可定位调用点），
+     *   并计入 [LoopMetrics::stalls]；同一次卡顿只报告一次。开启 [enableBacktrace()] 后同时输出卡住线程的调用栈
+     * - 延迟测量：向每个事件循环投递一个探测任务，记录其从入队到执行的延迟（[LoopMetrics::lagUs]），
+     *   上一个探测任务未执行时不重复投递
+     *
+     * 使用方式：
+     * @code
+     * LoopWatchdog watchdog(std::chrono::milliseconds(200));
+     * watchdog.enableBacktrace();
+     * watchdog.start();
+     * @endcode
+     *
+     * @note 进程内只应运行一个看门狗（卡顿计数由看门狗线程单独写入）
+     */
+    class LoopWatchdog : NonCopyable
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param threshold 一轮事件处理超过该时长视为卡顿
+         * @param interval 检查与投递探测任务的间隔（默认为 threshold 的一半）
+         */
+        explicit LoopWatchdog(std::chrono::milliseconds threshold = std::chrono::milliseconds(100),
+                              std::chrono::milliseconds interval = std::chrono::milliseconds(0));
+
+        /**
+         * @brief 析构函数，停止后台线程
+         */
+        ~LoopWatchdog();
+
+        /**
+         * @brief 启动后台线程
+         */
+        void start();
+
+        /**
+         * @brief 停止后台线程
+         */
+        void stop();
+
+        /**
+         * @brief 检测到卡顿时向卡住的事件循环线程发送信号，由信号处理函数把调用栈写到标准错误
+         * @param signo 使用的信号，须未被程序的其他部分占用
+         * @note 会为该信号安装进程级的处理函数，需在 [start()] 之前调用；
+         *       卡住的线程中正在进行的 sleep 等不可重启的系统调用会因信号提前返回
+         */
+        void enableBacktrace(int signo = SIGUSR2);
+
+    private:
+        /**
+         * @brief 后台线程主循环
+         */
+        void run();
+
+        /**
+         * @brief 检查所有事件循环并投递探测任务
+         */
+        void check();
+
+        /**
+         * @brief 报告一次卡顿
+         * @param metrics 卡住的事件循环的指标分片
+         * @param stalledNs 已持续的时长（纳秒）
+         */
+        void reportStall(LoopMetrics &metrics, int64_t stalledNs) const;
+
+        /**
+         * @brief 信号处理函数：输出当前线程的调用栈（只使用异步信号安全的调用）
+         */
+        static void backtraceHandler(int signo);
+
+        const int64_t thresholdNs_;                          //!< 卡顿阈值（纳秒）
+        const std::chrono::milliseconds interval_;           //!< 检查间隔
+        int backtraceSignal_;                                //!< 输出调用栈使用的信号（0 表示关闭）
+        std::thread thread_;                                 //!< 后台线程
+        std::mutex mutex_;                                   //!< 保护 running_
+        std::condition_variable cond_;                       //!< 用于提前结束等待
+        bool running_;                                       //!< 后台线程是否运行
+        std::unordered_map<LoopMetrics *, int64_t> reported_;//!< 已报告的卡顿（分片 -> 卡顿开始时间），仅后台线程访问
+    };
+}// namespace net
+
+#endif//MY_MUDUO_LOOPWATCHDOG_H
@@ -5,9 +5,22 @@
 #ifndef NGINX_MEMORY_POOL_NGX_MEM_POOL_H
 #define NGINX_MEMORY_POOL_NGX_MEM_POOL_H
 
+#include "NgxBlockSource.h"
+
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
+
+/*
+ * 调试模式：编译时定义 NGX_POOL_DEBUG=1（或 CMake 选项 -DNGX_POOL_DEBUG=ON）开启，用于排查越界与释放后使用
+ * - 每次分配在末尾追加 NGX_POOL_GUARD_SIZE 字节的保护字节，重置、释放与销毁时检查是否被改写
+ * - 新分配的内存填充 NGX_POOL_POISON_ALLOC，重置或释放后的内存填充 NGX_POOL_POISON_FREE
+ * 调试模式下每次分配多占用保护字节并登记分配记录，不应在生产环境开启
+ */
+#ifndef NGX_POOL_DEBUG
+#define NGX_POOL_DEBUG 0
+#endif
 
 // 定义清理操作函数指针类型
 using NgxPoolCleanupPt = void (*)(void *data);
@@ -25,6 +38,13 @@ struct NgxPoolLarge_t
 {
     NgxPoolLarge_t *next;// 指向下一个大块内存分配节点的指针，用于链接多个大块内存分配节点
     void *alloc;         // 指向实际分配的大块内存的指针
+    size_t size;         // 大块内存的实际大小（按规格取整后），不在规格范围内时释放直接归还内存来源
+};
+
+/*已释放、等待复用的大块内存（链表指针存放在内存块自身中）*/
+struct NgxPoolFreeLarge_t
+{
+    NgxPoolFreeLarge_t *next;// 同一规格的下一个空闲大块内存
 };
 
 struct NgxPool_t;
@@ -37,6 +57,39 @@ struct NgxPoolData_t
     u_int failed;   // 记录该内存块分配失败的次数
 };
 
+/*内存池统计信息，用于根据实际数据调整内存池大小（NGX_MIN_POOL_SIZE、max）*/
+struct NgxPoolStats_t
+{
+    // 小块内存（遍历内存块计算）
+    size_t blocks;             // 内存块数量
+    size_t blockBytes;         // 内存块总大小（含头部）
+    size_t smallUsedBytes;     // 已分配出去的小块内存（含对齐填充、内部跟踪节点与调试保护字节）
+    size_t smallRequestedBytes;// 自上次重置以来通过 palloc/pnalloc/pcalloc 请求的小块内存，与 smallUsedBytes 之差即额外开销
+    size_t smallFreeBytes;     // current 及之后的内存块中仍可分配的空间
+    size_t skippedBlocks;      // current 之前的内存块数量（分配失败超过 4 次而被跳过）
+    size_t skippedFreeBytes;   // current 之前的内存块中剩余、不会再被使用的空间
+    // 大块内存
+    size_t largeLive;          // 仍在使用的大块内存数量
+    size_t largeLiveBytes;     // 仍在使用的大块内存总大小（按规格取整后）
+    size_t largeCachedBytes;   // 按规格缓存、等待复用的空闲大块内存总大小
+    // 累计计数（自内存池创建以来）
+    uint64_t smallAllocs;      // 小块内存分配次数
+    uint64_t blockAllocs;      // 新内存块申请次数
+    uint64_t currentSkips;     // current 前移（跳过内存块）的次数
+    uint64_t largeAllocs;      // 大块内存分配次数
+    uint64_t largeCacheHits;   // 大块内存分配命中规格缓存的次数
+    uint64_t largeFrees;       // pfree 释放大块内存的次数
+    uint64_t resets;           // 重置次数
+    uint64_t guardViolations;  // 调试模式下检测到的保护字节被改写次数
+};
+
+/*调试模式下的分配记录*/
+struct NgxPoolDebugAlloc_t
+{
+    u_char *p;  // 分配给调用方的内存
+    size_t size;// 调用方请求的大小，保护字节紧随其后
+};
+
 struct NgxPool_t
 {
     NgxPoolData_t d;          // 小块内存头部信息
@@ -61,14 +114,33 @@ const int NGX_POOL_ALIGNMENT = 16;
 const int NGX_MIN_POOL_SIZE = ngx_align((sizeof(NgxPool_t) + 2 * sizeof(NgxPoolLarge_t)), NGX_POOL_ALIGNMENT);
 const int NGX_ALIGNMENT = sizeof(unsigned long);
 
+/*可缓存复用的大块内存最小规格（一个页面），更小的大块请求直接向内存来源申请与归还*/
+const size_t NGX_LARGE_CLASS_MIN = ngx_pagesize;
+/*可缓存复用的大块内存最大规格 1MB，更大的请求直接向内存来源申请与归还*/
+const size_t NGX_LARGE_CLASS_MAX = 1024 * 1024;
+/*每个 2 的幂区间划分的规格数（位数），即规格之间相差 25%*/
+const int NGX_LARGE_CLASS_STEP_BITS = 2;
+/*大块内存规格数量：4KB 一档，之后 4KB ~ 1MB 的 8 个 2 的幂区间各 4 档*/
+const int NGX_LARGE_CLASS_COUNT = 1 + 8 * (1 << NGX_LARGE_CLASS_STEP_BITS);
+/*每个内存池缓存的空闲大块内存总量上限，超过后释放的大块内存直接归还内存来源*/
+const size_t NGX_LARGE_CACHE_MAX = 4 * NGX_LARGE_CLASS_MAX;
+
+/*调试模式下每次分配末尾的保护字节数量及填充值*/
+const size_t NGX_POOL_GUARD_SIZE = NGX_POOL_DEBUG ? 16 : 0;
+const u_char NGX_POOL_GUARD_BYTE = 0xFD;
+/*调试模式下新分配内存与已回收内存的填充值*/
+const u_char NGX_POOL_POISON_ALLOC = 0xCD;
+const u_char NGX_POOL_POISON_FREE = 0xDD;
+
 class NgxMemPool
 {
 public:
-    /*构造函数，创建一个新的内存池，分配指定大小的内存块，并初始化内存池的各个成员变量*/
-    explicit NgxMemPool(size_t size = NGX_MIN_POOL_SIZE);
+    /*构造函数，创建一个新的内存池，分配指定大小的内存块，并初始化内存池的各个成员变量；
+      内存块与大块内存都从 source 申请（默认 malloc/free，可使用 NgxMmapBlockSource 启用大页）*/
+    explicit NgxMemPool(size_t size = NGX_MIN_POOL_SIZE, NgxBlockSource *source = NgxBlockSource::mallocSource());
     /*销毁内存池，释放所有分配的内存，并执行所有清理操作*/
     ~NgxMemPool();
-    /*重置内存池，释放所有大块内存，并将小块内存的分配位置重置为初始状态*/
+    /*重置内存池，执行并清空所有清理操作，回收所有大块内存（按规格缓存或释放），并将小块内存的分配位置重置为初始状态*/
     void resetPool();
     /*从内存池中分配对齐的内存（小块或大块）*/
     void *palloc(size_t size);
@@ -76,20 +148,44 @@ public:
     void *pnalloc(size_t size);
     /*分配并清零内存*/
     void *pcalloc(size_t size);
-    /*释放从内存池中分配的大块内存*/
+    /*释放从内存池中分配的大块内存（按规格缓存，供之后相近大小的大块分配复用）*/
     void pfree(void *p);
     /*注册清理回调*/
     NgxPoolCleanup_t *cleanupAdd(size_t size);
+    /*可从小块内存中分配的最大大小，超过该值的请求按大块内存分配*/
+    size_t smallMax() const;
+    /*统计信息：累计计数直接返回，内存块与大块内存的占用情况遍历链表计算*/
+    NgxPoolStats_t stats() const;
+    /*调试模式下检查所有仍在使用的分配的保护字节，返回被改写的数量并输出到标准错误；非调试模式返回 0*/
+    size_t verifyGuards();
 
 private:
+    /*按请求大小选择小块或大块分配，调试模式下追加保护字节并登记*/
+    inline void *allocate(size_t size, bool align);
+    /*调试模式：检查一条分配记录的保护字节*/
+    inline bool guardIntact(const NgxPoolDebugAlloc_t &a) const;
     /*处理小块内存分配*/
     inline void *pallocSmall(size_t size, bool align);
     /*分配新的内存池块*/
     inline void *pallocBlock(size_t size);
     /*分配大内存并加入链表*/
     inline void *pallocLarge(size_t size);
+    /*获取一个大块内存跟踪节点（优先复用已释放的节点）*/
+    inline NgxPoolLarge_t *getLargeNode();
+    /*大块内存不再使用：按规格放入空闲链表等待复用，缓存已满或不按规格缓存时归还内存来源*/
+    inline void releaseLarge(void *p, size_t size);
+    /*计算大块内存的规格下标，不按规格缓存时返回 -1*/
+    static int largeClassIndex(size_t size);
+    /*规格下标对应的大小*/
+    static size_t largeClassSize(int index);
 
     NgxPool_t *_pool;
+    NgxBlockSource *_source;                              // 内存块与大块内存的来源
+    NgxPoolLarge_t *_freeLargeNodes;                      // 可复用的大块内存跟踪节点（位于小块内存中）
+    NgxPoolFreeLarge_t *_freeLarge[NGX_LARGE_CLASS_COUNT];// 各规格的空闲大块内存
+    size_t _freeLargeBytes;                               // 空闲大块内存总量
+    NgxPoolStats_t _stats;                                // 累计计数（占用情况在 stats() 中计算）
+    std::vector<NgxPoolDebugAlloc_t> _debugAllocs;        // 调试模式下仍在使用的分配记录
 };
 
 #endif//NGINX_MEMORY_POOL_NGX_MEM_POOL_H
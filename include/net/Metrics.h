@@ -0,0 +1,256 @@
+//
+// Created by shuzeyong on 2025/5/24.
+//
+
+#ifndef MY_MUDUO_METRICS_H
+#define MY_MUDUO_METRICS_H
+
+#include "MenoryPool.h"
+#include "NonCopyable.h"
+#include "SysHeadFile.h"
+#include "../thp/Histogram.h"
+
+#include <typeinfo>
+
+namespace net
+{
+    class EventLoop;
+
+    /**
+     * @class Counter
+     * @brief 单写者计数器：递增只有普通的原子读写（无锁前缀指令），任意线程可随时读取
+     * @note 同一时刻只能有一个线程调用 [add()]
+     */
+    class Counter : NonCopyable
+    {
+    public:
+        void add(uint64_t delta = 1)
+        {
+            value_.store(value_.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<uint64_t> value_{0};//!< 计数值
+    };
+
+    /**
+     * @class Gauge
+     * @brief 单写者仪表：可增可减的当前值，写入规则与 [Counter] 相同
+     */
+    class Gauge : NonCopyable
+    {
+    public:
+        void add(int64_t delta)
+        {
+            value_.store(value_.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+        void sub(int64_t delta) { add(-delta); }
+
+        void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+
+        [[nodiscard]] int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<int64_t> value_{0};//!< 当前值
+    };
+
+    /**
+     * @struct LoopMetricsSnapshot
+     * @brief 一个事件循环（或多个事件循环汇总）的指标快照
+     */
+    struct LoopMetricsSnapshot
+    {
+        pid_t tid = 0;//!< 事件循环所属线程（汇总快照为 0）
+
+        // EventLoop
+        uint64_t iterations = 0;             //!< 循环次数
+        uint64_t functorsRun = 0;            //!< 执行的异步任务数
+        uint64_t wakeups = 0;                //!< 处理的唤醒事件数
+        thp::HistogramSnapshot eventsPerPoll;//!< 每次 poll 返回的事件数
+        uint64_t ioDispatchNs = 0;           //!< I/O 事件分发累计耗时（纳秒）
+        uint64_t functorsNs = 0;             //!< 异步任务执行累计耗时（纳秒）
+        thp::HistogramSnapshot ioDispatchUs; //!< 每轮 I/O 事件分发耗时（微秒）
+        thp::HistogramSnapshot functorsUs;   //!< 每轮异步任务执行耗时（微秒）
+        thp::HistogramSnapshot lagUs;        //!< 看门狗探测任务从入队到执行的延迟（微秒）
+        uint64_t stalls = 0;                 //!< 看门狗检测到的卡顿次数
+        // EPollPoller
+        uint64_t epollCtls = 0;       //!< epoll_ctl 调用次数
+        uint64_t eventListResizes = 0;//!< 事件数组扩容次数
+        // TcpConnection
+        uint64_t bytesRead = 0;   //!< 读取的字节数
+        uint64_t bytesWritten = 0;//!< 写出的字节数
+        uint64_t eagain = 0;      //!< 读写遇到 EAGAIN 的次数
+        int64_t bufferBytes = 0;  //!< 连接缓冲区已分配的字节数
+        int64_t outputPending = 0;//!< 输出缓冲区中等待发送的字节数
+        // TcpServer
+        uint64_t accepts = 0;         //!< 接受的连接数
+        int64_t activeConnections = 0;//!< 当前连接数
+        // NgxMemPool（连接的请求内存池）
+        int64_t memPools = 0;                   //!< 当前内存池数量
+        uint64_t memPoolSmallAllocs = 0;        //!< 小块内存分配次数
+        uint64_t memPoolLargeAllocs = 0;        //!< 大块内存分配次数
+        uint64_t memPoolLargeCacheHits = 0;     //!< 大块内存命中规格缓存的次数
+        uint64_t memPoolBlockAllocs = 0;        //!< 新内存块申请次数
+        uint64_t memPoolCurrentSkips = 0;       //!< current 跳过内存块的次数
+        uint64_t memPoolResets = 0;             //!< 重置次数
+        uint64_t memPoolGuardViolations = 0;    //!< 调试模式下检测到的越界次数
+        thp::HistogramSnapshot memPoolFootprint;//!< 每次重置（及销毁）前内存池占用的字节数
+        thp::HistogramSnapshot memPoolWaste;    //!< 每次重置（及销毁）前被跳过内存块中浪费的字节数
+
+        /**
+         * @brief 合并另一个快照
+         */
+        void merge(const LoopMetricsSnapshot &other);
+    };
+
+    /**
+     * @struct LoopActivity
+     * @brief 事件循环当前正在做什么，由事件循环线程发布，供 [LoopWatchdog] 检测卡顿
+     */
+    struct LoopActivity
+    {
+        enum Phase
+        {
+            kPolling,   //!< 阻塞在 poll 中（空闲）
+            kIoDispatch,//!< 分发 I/O 事件（含定时器）
+            kFunctors   //!< 执行异步任务
+        };
+
+        std::atomic_bool looping{false};                      //!< 是否正在运行 loop()
+        std::atomic<int64_t> busySince{0};                    //!< 本轮开始处理事件的单调时钟（纳秒），空闲时为 0
+        std::atomic_int phase{kPolling};                      //!< 当前阶段
+        std::atomic_int fd{-1};                               //!< 正在分发事件的通道
+        std::atomic<const std::type_info *> callback{nullptr};//!< 正在执行的通道回调、任务或定时器回调的类型（用于定位调用点）
+        std::atomic_bool probePending{false};                 //!< 看门狗的延迟探测任务尚未执行
+    };
+
+    /**
+     * @class LoopMetrics
+     * @brief 一个事件循环的指标分片，由 [EventLoop] 持有
+     *
+     * 所有指标只由事件循环线程写入（单写者，热路径上没有共享写入），
+     * 读取时由 [MetricsRegistry] 汇总所有分片；
+     * 例外是 stalls，由唯一的 [LoopWatchdog] 线程写入
+     */
+    class alignas(64) LoopMetrics : NonCopyable
+    {
+    public:
+        LoopMetrics(EventLoop *loop, pid_t tid);
+
+        /**
+         * @brief 将当前数据累加到快照中（任意线程调用，各字段之间不保证严格一致）
+         */
+        void snapshotInto(LoopMetricsSnapshot &snapshot) const;
+
+        /**
+         * @brief 发布内存池统计：累计计数按与上次发布的差值累加，占用情况记入直方图
+         * @param stats 内存池当前的统计信息
+         * @param published 上次发布的统计信息，发布后更新为 stats
+         */
+        void publishMemPool(const NgxPoolStats_t &stats, NgxPoolStats_t &published);
+
+        EventLoop *const loop;//!< 所属事件循环
+        const pid_t tid;      //!< 所属线程
+        LoopActivity activity;//!< 当前活动
+
+        // EventLoop
+        Counter iterations;          //!< 循环次数
+        Counter functorsRun;         //!< 执行的异步任务数
+        Counter wakeups;             //!< 处理的唤醒事件数
+        thp::Histogram eventsPerPoll;//!< 每次 poll 返回的事件数
+        Counter ioDispatchNs;        //!< I/O 事件分发累计耗时（纳秒）
+        Counter functorsNs;          //!< 异步任务执行累计耗时（纳秒）
+        thp::Histogram ioDispatchUs; //!< 每轮 I/O 事件分发耗时（微秒）
+        thp::Histogram functorsUs;   //!< 每轮异步任务执行耗时（微秒）
+        thp::Histogram lagUs;        //!< 看门狗探测任务从入队到执行的延迟（微秒）
+        Counter stalls;              //!< 看门狗检测到的卡顿次数
+        // EPollPoller
+        Counter epollCtls;       //!< epoll_ctl 调用次数
+        Counter eventListResizes;//!< 事件数组扩容次数
+        // TcpConnection
+        Counter bytesRead;   //!< 读取的字节数
+        Counter bytesWritten;//!< 写出的字节数
+        Counter eagain;      //!< 读写遇到 EAGAIN 的次数
+        Gauge bufferBytes;   //!< 连接缓冲区已分配的字节数
+        Gauge outputPending; //!< 输出缓冲区中等待发送的字节数
+        // TcpServer
+        Counter accepts;        //!< 接受的连接数
+        Gauge activeConnections;//!< 当前连接数
+        // NgxMemPool
+        Gauge memPools;                 //!< 当前内存池数量
+        Counter memPoolSmallAllocs;     //!< 小块内存分配次数
+        Counter memPoolLargeAllocs;     //!< 大块内存分配次数
+        Counter memPoolLargeCacheHits;  //!< 大块内存命中规格缓存的次数
+        Counter memPoolBlockAllocs;     //!< 新内存块申请次数
+        Counter memPoolCurrentSkips;    //!< current 跳过内存块的次数
+        Counter memPoolResets;          //!< 重置次数
+        Counter memPoolGuardViolations; //!< 调试模式下检测到的越界次数
+        thp::Histogram memPoolFootprint;//!< 内存池占用的字节数
+        thp::Histogram memPoolWaste;    //!< 被跳过内存块中浪费的字节数
+    };
+
+    /**
+     * @class MetricsRegistry
+     * @brief 指标注册表：登记所有事件循环的指标分片，读取时汇总
+     *
+     * 事件循环销毁时其分片的数据并入已退出部分，汇总结果中的计数器保持单调递增。
+     *
+     * 使用方式：
+     * @code
+     * LoopMetricsSnapshot total = MetricsRegistry::getInstance().snapshot();
+     * LOG_INFO("bytes in %lu, p99 events/poll %lu", total.bytesRead, total.eventsPerPoll.percentile(0.99));
+     * @endcode
+     */
+    class MetricsRegistry : NonCopyable
+    {
+    public:
+        /**
+         * @brief 获取单例
+         */
+        static MetricsRegistry &getInstance();
+
+        /**
+         * @brief 登记事件循环的指标分片（[EventLoop] 构造时调用）
+         */
+        void registerLoop(LoopMetrics *metrics);
+
+        /**
+         * @brief 注销事件循环的指标分片，数据并入已退出部分（[EventLoop] 析构时调用）
+         */
+        void unregisterLoop(LoopMetrics *metrics);
+
+        /**
+         * @brief 汇总所有事件循环（含已退出的）的指标
+         */
+        [[nodiscard]] LoopMetricsSnapshot snapshot() const;
+
+        /**
+         * @brief 各个存活事件循环的指标
+         */
+        [[nodiscard]] std::vector<LoopMetricsSnapshot> snapshotLoops() const;
+
+        /**
+         * @brief 各个存活事件循环的指标，写入调用方复用的数组（容量足够时不分配内存）
+         * @param out 输出数组，原有内容被替换
+         */
+        void snapshotLoops(std::vector<LoopMetricsSnapshot> &out) const;
+
+        /**
+         * @brief 在持有注册表锁的情况下访问每个存活的分片（期间事件循环不会析构）
+         * @param func 访问函数，不应阻塞
+         */
+        void forEachLoop(const std::function<void(LoopMetrics &)> &func);
+
+    private:
+        MetricsRegistry() = default;
+
+        mutable std::mutex mutex_;        //!< 保护以下成员
+        std::vector<LoopMetrics *> loops_;//!< 存活的事件循环分片
+        LoopMetricsSnapshot retired_;     //!< 已退出事件循环的数据
+    };
+}// namespace net
+
+#endif//MY_MUDUO_METRICS_H
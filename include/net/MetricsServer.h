@@ -0,0 +1,107 @@
+//
+// Created by shuzeyong on 2025/5/26.
+//
+
+#ifndef MY_MUDUO_METRICSSERVER_H
+#define MY_MUDUO_METRICSSERVER_H
+
+#include "Buffer.h"
+#include "Callbacks.h"
+#include "Metrics.h"
+#include "NonCopyable.h"
+#include "TcpServer.h"
+#include "../thp/ThreadPool.h"
+
+namespace net
+{
+    /**
+     * @class MetricsServer
+     * @brief 内置的管理端口：基于 [TcpServer] 的最小 HTTP 服务，以 Prometheus 文本格式提供 GET /metrics
+     *
+     * 导出的指标：
+     * - 事件循环（标签 loop="线程ID"）：循环次数、异步任务、唤醒、每次 poll 的事件数、I/O 分发与异步任务耗时、
+     *   延迟、卡顿、epoll_ctl 与事件数组扩容（[LoopMetrics]）
+     * - 连接：读写字节数、EAGAIN 次数、接受的连接数与当前连接数
+     * - 缓冲区：连接缓冲区已分配字节数、输出缓冲区待发送字节数
+     * - 内存池：连接请求内存池（[NgxMemPool]）的分配计数与占用分布
+     * - 线程池（标签 pool="名称"）：通过 [addThreadPool()] 登记的 [thp::ThreadPool] 的 [thp::PoolStats]
+     *
+     * 所有连接都在 loop 中处理，响应渲染到复用的 [Buffer] 中，逐行格式化到栈上再追加，
+     * 缓冲区容量稳定后抓取不再分配内存。支持 keep-alive；HTTP/1.0 或 Connection: close 时响应后关闭连接。
+     *
+     * 使用方式：
+     * @code
+     * MetricsServer metrics(&loop, InetAddress(9100));
+     * metrics.addThreadPool("compute", &pool);
+     * metrics.start();
+     * // curl http://127.0.0.1:9100/metrics
+     * @endcode
+     *
+     * @note 只应在 loop 线程中构造、启动和销毁；登记的线程池必须比本对象活得久
+     */
+    class MetricsServer : NonCopyable
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param loop 处理管理端口连接的事件循环
+         * @param listenAddr 监听地址
+         * @param name 服务器名称
+         */
+        MetricsServer(EventLoop *loop, const InetAddress &listenAddr, std::string name = "MetricsServer");
+
+        /**
+         * @brief 开始监听
+         */
+        void start();
+
+        /**
+         * @brief 登记需要导出统计信息的线程池
+         * @param name 线程池名称（用作标签值，不应包含引号、反斜杠或换行）
+         * @param pool 线程池
+         * @note 需在 [start()] 之前调用
+         */
+        void addThreadPool(std::string name, thp::ThreadPool *pool);
+
+        /**
+         * @brief 以 Prometheus 文本格式把所有指标追加到缓冲区
+         * @param buf 目标缓冲区
+         */
+        void render(Buffer *buf);
+
+    private:
+        /**
+         * @brief 解析缓冲区中的完整请求并逐个响应
+         */
+        void onMessage(const TcpConnectionPtr &conn, Buffer *buf, Timestamp receiveTime);
+
+        /**
+         * @brief 发送一个响应
+         * @param conn 连接
+         * @param found 请求的是否为 /metrics
+         * @param close 响应后是否关闭连接
+         */
+        void respond(const TcpConnectionPtr &conn, bool found, bool close);
+
+        /**
+         * @brief 渲染事件循环、连接、缓冲区与内存池指标
+         */
+        void renderLoops(Buffer *buf);
+
+        /**
+         * @brief 渲染线程池指标
+         */
+        void renderThreadPools(Buffer *buf);
+
+        static const size_t kMaxRequestSize = 8192;//!< 请求头的最大长度，超过后关闭连接
+
+        TcpServer server_;                                                  //!< 管理端口服务器
+        std::vector<std::pair<std::string, thp::ThreadPool *>> threadPools_;//!< 登记的线程池
+        std::vector<thp::PoolStats> poolStats_;                             //!< 复用的线程池统计快照（与 threadPools_ 一一对应）
+        std::vector<LoopMetricsSnapshot> loops_;                            //!< 复用的事件循环指标快照
+        Buffer body_;                                                       //!< 复用的响应体
+        Buffer response_;                                                   //!< 复用的完整响应（响应头 + 响应体）
+    };
+}// namespace net
+
+#endif//MY_MUDUO_METRICSSERVER_H
@@ -0,0 +1,194 @@
+//
+// Created by shuzeyong on 2025/5/23.
+//
+
+#ifndef NGINX_MEMORY_POOL_NGX_BLOCK_SOURCE_H
+#define NGINX_MEMORY_POOL_NGX_BLOCK_SOURCE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+/*透明大页 / 显式大页的大小 2MB*/
+const size_t NGX_HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+/*NgxBlockAllocator 交给内存来源的最小申请大小（一个大页），更小的容器存储直接 malloc/free*/
+const size_t NGX_BLOCK_ALLOCATOR_MIN_SOURCE_SIZE = NGX_HUGE_PAGE_SIZE;
+
+/**
+ * @class NgxBlockSource
+ * @brief 大块内存来源：内存池的内存块、大块内存以及 Buffer 的大容量存储都通过它向系统申请
+ *
+ * 默认来源为 malloc/free（[mallocSource()]），可替换为 [NgxMmapBlockSource] 以使用大页减少 TLB 缺失。
+ * 释放时必须传入与申请时相同的大小。
+ *
+ * @note 实现必须是线程安全的，同一个来源可以被多个内存池和缓冲区共享
+ */
+class NgxBlockSource
+{
+public:
+    virtual ~NgxBlockSource() = default;
+
+    /**
+     * @brief 申请内存块
+     * @param size 大小
+     * @return 内存块（至少按 max_align_t 对齐），失败时返回 nullptr
+     */
+    virtual void *allocate(size_t size) = 0;
+
+    /**
+     * @brief 释放内存块
+     * @param p [allocate()] 返回的内存块
+     * @param size 申请时的大小
+     */
+    virtual void deallocate(void *p, size_t size) = 0;
+
+    /**
+     * @brief 释放内存块，并让其占用的物理内存立即归还给系统（用于归还长期空闲的内存）
+     * @param p [allocate()] 返回的内存块
+     * @param size 申请时的大小
+     *
+     * 默认等同于 [deallocate()]，适用于释放即解除映射的来源
+     */
+    virtual void purge(void *p, size_t size)
+    {
+        deallocate(p, size);
+    }
+
+    /**
+     * @brief 默认来源（malloc/free），全局唯一
+     */
+    static NgxBlockSource *mallocSource();
+};
+
+/**
+ * @class NgxMallocBlockSource
+ * @brief 基于 malloc/free 的内存来源
+ *
+ * 小于 glibc mmap 阈值的内存块 free 后仍留在 malloc 的空闲链表中，
+ * [purge()] 先对其中完整的页面 madvise(MADV_DONTNEED) 再 free，物理内存立即归还
+ */
+class NgxMallocBlockSource : public NgxBlockSource
+{
+public:
+    void *allocate(size_t size) override;
+    void deallocate(void *p, size_t size) override;
+    void purge(void *p, size_t size) override;
+};
+
+/**
+ * @class NgxMmapBlockSource
+ * @brief 基于 mmap 的内存来源，可使用大页并预先缺页
+ *
+ * - kNormalPages：普通页面，大小按页面取整
+ * - kTransparentHugePages：不小于 2MB 的内存块按 2MB 对齐映射并 madvise(MADV_HUGEPAGE)，由内核透明大页合并
+ * - kExplicitHugePages：不小于 2MB 的内存块使用 MAP_HUGETLB（需预留 hugetlbfs 大页），大小按 2MB 取整，
+ *   大页不足时退回透明大页方式，并计入 [hugePageFallbacks()]；更小的内存块使用普通页面，不占用大页
+ *
+ * 开启预缺页（prefault）时使用 MAP_POPULATE，在申请时一次性建立页表，避免首次访问时逐页缺页。
+ *
+ * @note 每次申请都是一次 mmap 系统调用，适合内存池的内存块、大对象与大缓冲区这类低频的大块申请
+ */
+class NgxMmapBlockSource : public NgxBlockSource
+{
+public:
+    enum HugePageMode
+    {
+        kNormalPages,          //!< 普通页面
+        kTransparentHugePages, //!< 透明大页（madvise）
+        kExplicitHugePages     //!< 显式大页（MAP_HUGETLB），不可用时退回透明大页
+    };
+
+    /**
+     * @brief 构造函数
+     * @param mode 大页模式
+     * @param prefault 是否在申请时预先缺页
+     */
+    explicit NgxMmapBlockSource(HugePageMode mode = kTransparentHugePages, bool prefault = false);
+
+    void *allocate(size_t size) override;
+    void deallocate(void *p, size_t size) override;
+
+    /**
+     * @brief 显式大页申请失败、退回普通映射的次数
+     */
+    [[nodiscard]] uint64_t hugePageFallbacks() const;
+
+private:
+    /*该大小的请求是否使用显式大页*/
+    [[nodiscard]] bool useHugeTlb(size_t size) const;
+    /*申请大小按映射粒度取整（申请与释放必须一致）*/
+    [[nodiscard]] size_t mappedSize(size_t size) const;
+    /*按 2MB 对齐映射，并建议内核使用透明大页*/
+    void *mapTransparent(size_t length) const;
+
+    const HugePageMode mode_;                //!< 大页模式
+    const bool prefault_;                    //!< 是否预先缺页
+    std::atomic<uint64_t> hugePageFallbacks_;//!< 显式大页退回次数
+};
+
+/**
+ * @class NgxBlockAllocator
+ * @brief 基于 [NgxBlockSource] 的标准分配器，用于 Buffer 等容器的存储
+ *
+ * 只有不小于 [NGX_BLOCK_ALLOCATOR_MIN_SOURCE_SIZE] 的申请交给内存来源，更小的申请直接 malloc/free：
+ * 连接缓冲区通常只有 1KB 左右且会反复扩容，交给 NgxMmapBlockSource 会让每次申请与扩容都变成
+ * 至少 4KB 的 mmap/munmap，而不足 2MB 的存储本来也用不上大页。申请与释放按同一大小判断，两者的去向总是一致
+ */
+template<typename T>
+class NgxBlockAllocator
+{
+public:
+    using value_type = T;
+    // 赋值与交换时内存来源随内容一起转移
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit NgxBlockAllocator(NgxBlockSource *source = NgxBlockSource::mallocSource()) noexcept
+        : source_(source)
+    {}
+
+    template<typename U>
+    NgxBlockAllocator(const NgxBlockAllocator<U> &other) noexcept// NOLINT(google-explicit-constructor)
+        : source_(other.source())
+    {}
+
+    T *allocate(size_t n)
+    {
+        void *p = sourceFor(n)->allocate(n * sizeof(T));
+        if (p == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(p);
+    }
+
+    void deallocate(T *p, size_t n) noexcept
+    {
+        sourceFor(n)->deallocate(p, n * sizeof(T));
+    }
+
+    [[nodiscard]] NgxBlockSource *source() const noexcept
+    {
+        return source_;
+    }
+
+    template<typename U>
+    bool operator==(const NgxBlockAllocator<U> &other) const noexcept
+    {
+        return source_ == other.source();
+    }
+
+private:
+    /*n 个元素的存储实际使用的内存来源*/
+    [[nodiscard]] NgxBlockSource *sourceFor(size_t n) const noexcept
+    {
+        return n * sizeof(T) >= NGX_BLOCK_ALLOCATOR_MIN_SOURCE_SIZE ? source_ : NgxBlockSource::mallocSource();
+    }
+
+    NgxBlockSource *source_;//!< 内存来源（用于不小于 NGX_BLOCK_ALLOCATOR_MIN_SOURCE_SIZE 的申请）
+};
+
+#endif//NGINX_MEMORY_POOL_NGX_BLOCK_SOURCE_H
@@ -0,0 +1,54 @@
+//
+// Created by shuzeyong on 2025/5/21.
+//
+
+#ifndef NGINX_MEMORY_POOL_NGX_MEMORY_RESOURCE_H
+#define NGINX_MEMORY_POOL_NGX_MEMORY_RESOURCE_H
+
+#include "MenoryPool.h"
+
+#include <memory_resource>
+
+/**
+ * @class NgxMemoryResource
+ * @brief 将 [NgxMemPool] 适配为 std::pmr::memory_resource，
+ *        使 pmr::vector、pmr::string、pmr::unordered_map 等容器直接从连接级或请求级内存池中分配
+ *
+ * - 小块内存：从内存池顺序分配，释放为空操作，在 [NgxMemPool::resetPool()] 或内存池销毁时整体回收
+ * - 大块内存：释放时调用 [NgxMemPool::pfree()] 立即归还给内存池，供之后相近大小的请求复用
+ * - 超过 max_align_t 的对齐要求：多分配对齐余量后手动对齐，这类内存只在重置或销毁时回收
+ *
+ * 使用示例：
+ * @code
+ * NgxMemoryResource resource(conn->getMemPool());
+ * std::pmr::vector<std::pmr::string> headers(&resource);
+ * @endcode
+ *
+ * @note 与 [NgxMemPool] 一样不是线程安全的；资源不拥有内存池，内存池必须比使用它的容器活得久
+ */
+class NgxMemoryResource : public std::pmr::memory_resource
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param pool 提供内存的内存池（不转移所有权）
+     */
+    explicit NgxMemoryResource(NgxMemPool *pool);
+
+    /**
+     * @brief 获取底层内存池
+     */
+    NgxMemPool *getPool() const;
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    /*判断请求能否直接由内存池满足对齐要求（否则需要多分配并手动对齐）*/
+    bool alignedByPool(size_t bytes, size_t alignment) const;
+
+    NgxMemPool *pool_;// 底层内存池
+};
+
+#endif//NGINX_MEMORY_POOL_NGX_MEMORY_RESOURCE_H
@@ -0,0 +1,75 @@
+//
+// Created by shuzeyong on 2025/5/22.
+//
+
+#ifndef NGINX_MEMORY_POOL_NGX_THREAD_CACHE_ALLOCATOR_H
+#define NGINX_MEMORY_POOL_NGX_THREAD_CACHE_ALLOCATOR_H
+
+#include "NgxBlockSource.h"
+#include "NonCopyable.h"
+
+#include <memory>
+#include <memory_resource>
+
+/*由线程缓存管理的最大对象大小，更大的请求直接从内存来源分配*/
+const size_t NGX_TC_MAX_SIZE = 64 * 1024;
+/*对象规格数量：16 ~ 128 字节每 16 字节一档，之后 128B ~ 64KB 的 9 个 2 的幂区间各 4 档*/
+const int NGX_TC_CLASS_COUNT = 8 + 9 * 4;
+/*span（一次向内存来源申请、切分为同一规格对象的连续内存）的最小大小*/
+const size_t NGX_TC_SPAN_MIN = 64 * 1024;
+/*每个规格在中心保留的完整批次数量上限，超过后对象逐个归还到所属 span*/
+const size_t NGX_TC_TRANSFER_BATCHES = 32;
+/*每个规格最多保留的完全空闲 span 数量，超过后立即交还内存来源*/
+const uint32_t NGX_TC_MAX_EMPTY_SPANS = 8;
+/*周期性归还的间隔（毫秒）：每个周期把各规格的完全空闲 span 减少到一个*/
+const int64_t NGX_TC_SCAVENGE_INTERVAL_MS = 1000;
+
+class NgxCentralHeap;
+
+/**
+ * @class NgxThreadCacheAllocator
+ * @brief 以 [NgxBlockSource] 为后端的线程安全分配器（tcmalloc 风格），实现 std::pmr::memory_resource
+ *
+ * 三层结构：
+ * - 线程缓存：每个线程每个规格一条空闲链表，分配与释放都不加锁；
+ *   链表为空时从中心批量取一批，超过两批时批量归还一批
+ * - 中心空闲链表：每个规格一把锁，缓存整批对象（转移缓存），并管理该规格的 span
+ * - 内存来源：span 和超过 NGX_TC_MAX_SIZE 的大对象直接向线程安全的 [NgxBlockSource] 申请，
+ *   不经过全局锁；只有由对象地址查找所属 span 的地址表加读写锁（新建、释放 span 时加写锁）
+ *
+ * 内存归还：每个规格最多保留 NGX_TC_MAX_EMPTY_SPANS 个完全空闲的 span，超出的立即交还内存来源；
+ * 每隔 NGX_TC_SCAVENGE_INTERVAL_MS，归还对象的线程顺带把各规格的空闲 span 减少到一个；
+ * 也可以调用 [releaseFreeMemory()] 主动归还。交还的 span 经由 [NgxBlockSource::purge()] 释放，
+ * 物理内存立即归还系统（mmap 来源 munmap，malloc 来源先 madvise(MADV_DONTNEED) 再 free）。
+ *
+ * 适合在 [thp::ThreadPool] 的工作线程之间传递消息：生产者线程分配、消费者线程释放，
+ * 对象经由各自的线程缓存与中心空闲链表流转，热路径上没有全局锁。
+ *
+ * @note 分配器销毁时立即释放全部内存，各线程残留的线程缓存在该线程下次创建线程缓存或退出时丢弃；
+ *       分配器销毁前必须释放所有由它分配的内存，内存来源必须比分配器活得久
+ */
+class NgxThreadCacheAllocator : public std::pmr::memory_resource, net::NonCopyable
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param source span 与大对象的内存来源（须线程安全），默认 malloc/free
+     */
+    explicit NgxThreadCacheAllocator(NgxBlockSource *source = NgxBlockSource::mallocSource());
+    ~NgxThreadCacheAllocator() override;
+
+    /**
+     * @brief 归还空闲内存：清空当前线程的线程缓存与中心的转移缓存，释放所有完全空闲的 span
+     * @note 其他线程的线程缓存不受影响；可由定时器周期性调用
+     */
+    void releaseFreeMemory();
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    std::shared_ptr<NgxCentralHeap> central_;// 中心堆（线程缓存也持有引用，分配器销毁后仍可安全地丢弃缓存）
+};
+
+#endif//NGINX_MEMORY_POOL_NGX_THREAD_CACHE_ALLOCATOR_H
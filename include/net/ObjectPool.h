@@ -0,0 +1,186 @@
+//
+// Created by shuzeyong on 2025/5/20.
+//
+
+#ifndef MY_MUDUO_OBJECTPOOL_H
+#define MY_MUDUO_OBJECTPOOL_H
+
+#include "NonCopyable.h"
+#include "SysHeadFile.h"
+
+#include <cstddef>
+
+namespace net
+{
+    /**
+     * @class SlabPool
+     * @brief 定长内存块池：从成批申请的大块内存（slab）中切分等长的内存块，释放后放回空闲链表循环使用
+     *
+     * - 块大小在第一次分配时确定，之后大小不同的请求由调用方回退到全局 operator new
+     * - 所属线程（第一次分配的线程，通常是某个 EventLoop 线程）的分配路径没有任何原子操作；
+     *   其他线程偶尔分配时单独向系统申请一块并登记，释放后同样进入池中复用
+     * - 任意线程都可以释放：所属线程直接放回本地空闲链表；其他线程压入无锁的远程释放栈，
+     *   所属线程在本地链表为空时一次性取回
+     * - slab 只在池析构时归还给系统，因此稳定状态下分配与释放都不会进入 malloc
+     *
+     * @note 池通过 [create()] 创建，带侵入式引用计数：返回的 shared_ptr 持有一个引用，[SlabAllocator] 分配的
+     *       每个块各持有一个引用，池一定比其中的块活得久。分配器的拷贝不计数——allocate_shared 会多次拷贝分配器，
+     *       若每次拷贝都增减 shared_ptr 的原子计数，多线程进程中池化分配反而比 malloc 慢数倍
+     */
+    class SlabPool : NonCopyable
+    {
+    public:
+        /**
+         * @brief 创建内存块池
+         * @param blocksPerSlab 每次向系统申请的块数量
+         * @return 池的句柄；句柄全部释放且所有块都已归还时池才析构
+         */
+        static std::shared_ptr<SlabPool> create(size_t blocksPerSlab = 64);
+
+        /**
+         * @brief 增加一个引用（[SlabAllocator] 每分配一个块调用一次）
+         */
+        void retain() { refs_.fetch_add(1, std::memory_order_relaxed); }
+
+        /**
+         * @brief 释放一个引用，最后一个引用释放时析构池
+         */
+        void release();
+
+        /**
+         * @brief 分配一个内存块
+         * @param size 请求大小，第一次调用时确定块大小
+         * @return 内存块；大小与第一次请求不符时返回 nullptr，由调用方回退到 operator new
+         */
+        void *allocate(size_t size);
+
+        /**
+         * @brief 释放一个内存块（任意线程调用）
+         * @param p 由 [allocate()] 返回的内存块
+         */
+        void deallocate(void *p);
+
+        /**
+         * @brief 判断给定大小的请求是否由本池服务
+         * @param size 请求大小
+         */
+        [[nodiscard]] bool owns(size_t size) const;
+
+        /**
+         * @brief 已申请的 slab 数量
+         */
+        [[nodiscard]] size_t slabCount() const;
+
+        /**
+         * @brief 块大小（尚未分配过时为 0）
+         */
+        [[nodiscard]] size_t blockSize() const;
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock *next;//!< 空闲链表中的下一块
+        };
+
+        /**
+         * @brief 构造函数（通过 [create()] 调用）
+         * @param blocksPerSlab 每次向系统申请的块数量
+         */
+        explicit SlabPool(size_t blocksPerSlab);
+
+        /**
+         * @brief 析构函数，释放所有 slab（由最后一次 [release()] 调用）
+         */
+        ~SlabPool();
+
+        /**
+         * @brief 本地空闲链表为空时补充：优先取回远程释放的块，否则申请新的 slab
+         */
+        void refill();
+
+        pid_t ownerTid_;                     //!< 所属线程（第一次分配时确定）
+        size_t blockSize_;                   //!< 块大小（第一次分配时确定，按 max_align_t 对齐）
+        size_t requestSize_;                 //!< 第一次分配时的请求大小，用于匹配后续请求
+        const size_t blocksPerSlab_;         //!< 每个 slab 的块数
+        FreeBlock *freeList_;                //!< 本地空闲链表（仅所属线程访问）
+        std::atomic<FreeBlock *> remoteFree_;//!< 其他线程释放的块（Treiber 栈）
+        std::vector<void *> slabs_;          //!< 已申请的 slab（仅所属线程访问）
+        std::mutex strayMtx_;                //!< 保护 strays_
+        std::vector<void *> strays_;         //!< 其他线程分配时单独申请的块
+        std::atomic<size_t> refs_;           //!< 引用计数（句柄 + 未归还的块）
+    };
+
+    /**
+     * @class SlabAllocator
+     * @brief 基于 [SlabPool] 的标准分配器，配合 std::allocate_shared 使用
+     *
+     * allocate_shared 会把分配器 rebind 到控制块类型，对象与控制块一起放在一个池化的块里：
+     * @code
+     * auto pool = SlabPool::create();
+     * auto conn = std::allocate_shared<TcpConnection>(SlabAllocator<TcpConnection>(pool), ...);
+     * @endcode
+     * 单个对象且大小与池的块大小一致时走池，否则回退到 operator new
+     *
+     * @note 分配器只保存池的裸指针，拷贝不涉及原子操作；每个分配出的块（含回退到 operator new 的块）持有池的一个引用，
+     *       因此控制块中的分配器在块释放前始终有效。单独持有的分配器在使用期间需要有池的句柄存活
+     */
+    template<typename T>
+    class SlabAllocator
+    {
+    public:
+        using value_type = T;
+
+        explicit SlabAllocator(const std::shared_ptr<SlabPool> &pool) noexcept
+            : pool_(pool.get())
+        {}
+
+        template<typename U>
+        SlabAllocator(const SlabAllocator<U> &other) noexcept// NOLINT(google-explicit-constructor)
+            : pool_(other.pool())
+        {}
+
+        T *allocate(size_t n)
+        {
+            if (n == 1 && alignof(T) <= alignof(std::max_align_t))
+            {
+                if (void *p = pool_->allocate(sizeof(T)))
+                {
+                    pool_->retain();
+                    return static_cast<T *>(p);
+                }
+            }
+            auto *p = static_cast<T *>(::operator new(n * sizeof(T)));
+            pool_->retain();
+            return p;
+        }
+
+        void deallocate(T *p, size_t n) noexcept
+        {
+            if (n == 1 && alignof(T) <= alignof(std::max_align_t) && pool_->owns(sizeof(T)))
+            {
+                pool_->deallocate(p);
+            }
+            else
+            {
+                ::operator delete(p);
+            }
+            pool_->release();
+        }
+
+        [[nodiscard]] SlabPool *pool() const noexcept
+        {
+            return pool_;
+        }
+
+        template<typename U>
+        bool operator==(const SlabAllocator<U> &other) const noexcept
+        {
+            return pool_ == other.pool();
+        }
+
+    private:
+        SlabPool *pool_;//!< 内存块池（不持有引用）
+    };
+}// namespace net
+
+#endif//MY_MUDUO_OBJECTPOOL_H
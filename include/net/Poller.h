@@ -79,8 +79,6 @@ namespace net
     protected:
         using ChannelMap = std::unordered_map<int, Channel *>;
         ChannelMap channels_;//!< 所有注册的 [Channel]，键为文件描述符（fd），值为对应的 [Channel] 指针
-
-    private:
         EventLoop *ownerLoop_;//!< 所属的 [EventLoop]，用于确保线程安全性
     };
 }// namespace net
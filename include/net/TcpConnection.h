@@ -8,7 +8,10 @@
 #include "Buffer.h"
 #include "Callbacks.h"
 #include "Channel.h"
+#include "EventLoop.h"
 #include "InetAddress.h"
+#include "MenoryPool.h"
+#include "NgxMemoryResource.h"
 #include "NonCopyable.h"
 #include "Socket.h"
 #include "SysHeadFile.h"
@@ -29,6 +32,9 @@ namespace net
      * - 数据缓冲：使用双缓冲区（[inputBuffer_] 和 [outputBuffer_]）实现高效的非阻塞 IO 操作。
      * - 流量控制：通过高水位标记（[highWaterMark_]）防止发送缓冲区过度膨胀。
      * - 线程安全：通过事件循环（[EventLoop]）确保跨线程操作的安全性。
+     * - 请求内存池：可选地持有一个 [NgxMemPool]，供协议解析等按消息分配的场景使用，
+     *   在消息边界通过 [resetMemPool()] 整体回收，连接关闭时一次性释放；
+     *   [getMemoryResource()] 以 std::pmr 接口暴露同一个内存池，供 pmr 容器使用。
      */
     class TcpConnection : NonCopyable, public std::enable_shared_from_this<TcpConnection>
     {
@@ -89,6 +95,42 @@ namespace net
          */
         Buffer *getOutputBuffer();
 
+        /**
+         * @brief 设置输入/输出缓冲区与请求内存池的内存来源（如使用大页的 NgxMmapBlockSource）
+         * @param source 内存来源，需比连接活得久
+         * @note 会以新来源重建两个缓冲区，需在 [connectEstablished()] 与 [enableMemPool()] 之前调用
+         * @note 缓冲区只有扩容到 2MB 及以上时才从该来源申请存储，平常的小缓冲区仍使用 malloc/free
+         */
+        void setBlockSource(NgxBlockSource *source);
+
+        //------------------------- 请求内存池接口 -------------------------
+        /**
+         * @brief 为连接创建请求内存池（已创建时不做任何事）
+         * @param size 内存池每个内存块的大小（默认为一个页面）
+         * @note 需在 [connectEstablished()] 之前或在连接所属的事件循环线程中调用
+         */
+        void enableMemPool(size_t size = ngx_pagesize);
+
+        /**
+         * @brief 获取请求内存池
+         * @return 内存池指针；未启用或连接已销毁时返回 nullptr
+         * @note 只能在连接所属的事件循环线程中使用，分配的内存在 [resetMemPool()] 或连接关闭后失效
+         */
+        NgxMemPool *getMemPool() const;
+
+        /**
+         * @brief 获取基于请求内存池的 pmr 内存资源
+         * @return 内存资源指针；未启用内存池或连接已销毁时返回 nullptr
+         * @note 使用限制与 [getMemPool()] 相同，pmr 容器须在 [resetMemPool()] 之前销毁
+         */
+        std::pmr::memory_resource *getMemoryResource() const;
+
+        /**
+         * @brief 在消息边界重置请求内存池：执行已注册的清理操作，释放大块内存，小块内存复用
+         * @note 只能在连接所属的事件循环线程中调用
+         */
+        void resetMemPool();
+
         //------------------------- 连接状态判断接口 -------------------------
         /**
          * @brief 判断是否处于已连接状态
@@ -109,11 +151,150 @@ namespace net
          */
         void send(const std::string &buf);
 
+        /**
+         * @brief 发送数据（线程安全）
+         * @param data 待发送的数据，在事件循环线程中调用时直接发送，否则先拷贝一份
+         * @param len 数据长度
+         */
+        void send(const void *data, size_t len);
+
+        /**
+         * @brief 发送缓冲区中的全部可读数据并清空缓冲区（线程安全）
+         * @param buf 待发送的缓冲区；在事件循环线程中调用时不产生中间拷贝，缓冲区可反复使用
+         */
+        void send(Buffer *buf);
+
         /**
          * @brief 主动关闭连接（半关闭模式）
          */
         void shutdown();
 
+        /**
+         * @brief 将 work 交给线程池执行，完成后在本连接所属的事件循环线程中调用 cont
+         * @param pool 线程池（如 thp::ThreadPool）
+         * @param work 在线程池中执行的任务，签名为 R()
+         * @param cont 后续操作，签名为 void(const TcpConnectionPtr &, R)（R 为 void 时省略第二个参数）
+         * @return 任务已入队返回 true；队列已满或线程池已停止返回 false（不阻塞、不在事件循环线程内联执行 work）
+         *
+         * 任务只持有连接的弱引用，不会延长连接的生命周期；任务完成前连接已销毁时 cont 不会执行。
+         *
+         * 使用方式：
+         * @code
+         * void onMessage(const TcpConnectionPtr &conn, Buffer *buf, Timestamp) {
+         *     conn->offload(pool, [req = buf->retrieveAllAsString()]() { return handle(req); },
+         *                   [](const TcpConnectionPtr &c, std::string resp) { c->send(resp); });
+         * }
+         * @endcode
+         *
+         * @note 线程池使用 DISCARD_OLDEST 策略时，已入队的任务可能被后来的提交挤掉，cont 将永远不会执行，
+         *       连接上等待响应的请求也就不会被应答；用于 offload 的线程池不应使用该策略
+         */
+        template<typename Pool, typename Work, typename Cont>
+        bool offload(Pool &pool, Work &&work, Cont &&cont)
+        {
+            std::weak_ptr<TcpConnection> weakConn = shared_from_this();
+            return loop_->offload(pool, std::forward<Work>(work),
+                                  [weakConn, cont = std::forward<Cont>(cont)](auto &&...result) mutable {
+                                      if (TcpConnectionPtr conn = weakConn.lock())
+                                      {
+                                          cont(conn, std::forward<decltype(result)>(result)...);
+                                      }
+                                  });
+        }
+
+        //------------------------- 协程接口 -------------------------
+        /**
+         * @class ReadAwaiter
+         * @brief [read()] / [readUntil()] 返回的可等待对象
+         *
+         * 结果为指向输入缓冲区的 string_view，在协程下一次挂起前有效；
+         * 连接关闭且剩余数据不足时结果为 std::nullopt
+         */
+        class ReadAwaiter
+        {
+        public:
+            ReadAwaiter(TcpConnection *conn, size_t n, std::string_view delim)
+                : conn_(conn),
+                  n_(n),
+                  delim_(delim)
+            {}
+
+            bool await_ready() { return conn_->tryCompleteRead(this); }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                handle_ = handle;
+                conn_->readWaiter_ = this;
+            }
+
+            std::optional<std::string_view> await_resume() const noexcept { return result_; }
+
+        private:
+            friend class TcpConnection;
+
+            TcpConnection *conn_;                  //!< 所属连接
+            size_t n_;                             //!< 需要读取的字节数（按长度读取时）
+            std::string_view delim_;               //!< 分隔符（按分隔符读取时，非空）
+            std::coroutine_handle<> handle_;       //!< 等待中的协程
+            std::optional<std::string_view> result_;//!< 读取结果
+        };
+
+        /**
+         * @class WriteAwaiter
+         * @brief [write()] 返回的可等待对象，数据全部写入内核后恢复，结果表示是否成功
+         */
+        class WriteAwaiter
+        {
+        public:
+            WriteAwaiter(TcpConnection *conn, std::string_view data)
+                : conn_(conn),
+                  data_(data)
+            {}
+
+            bool await_ready() const noexcept { return false; }
+
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                handle_ = handle;
+                return conn_->startWrite(this);
+            }
+
+            bool await_resume() const noexcept { return ok_; }
+
+        private:
+            friend class TcpConnection;
+
+            TcpConnection *conn_;           //!< 所属连接
+            std::string_view data_;         //!< 待发送数据
+            std::coroutine_handle<> handle_;//!< 等待中的协程
+            bool ok_ = false;               //!< 是否发送成功
+        };
+
+        /**
+         * @brief 协程中读取恰好 n 字节
+         * @param n 字节数
+         * @return 可等待对象，结果为读取的数据（连接关闭时为 std::nullopt）
+         *
+         * @note 首次调用后连接进入协程模式，不再触发 [messageCallback_]；
+         *       只能在连接所属的事件循环线程中调用，同一时刻最多一个协程等待读
+         */
+        ReadAwaiter read(size_t n);
+
+        /**
+         * @brief 协程中读取到分隔符为止（结果包含分隔符）
+         * @param delim 分隔符（需在 co_await 完成前保持有效）
+         * @return 可等待对象，结果为读取的数据（连接关闭时为 std::nullopt）
+         */
+        ReadAwaiter readUntil(std::string_view delim);
+
+        /**
+         * @brief 协程中发送数据，全部写入内核发送缓冲区后恢复
+         * @param data 待发送数据（未能立即发送的部分会拷贝到输出缓冲区）
+         * @return 可等待对象，结果为是否发送成功（连接已断开时为 false）
+         * @note 只能在连接所属的事件循环线程中调用，同一时刻最多一个协程等待写
+         */
+        WriteAwaiter write(std::string_view data);
+
         //------------------------- 回调设置接口 -------------------------
         /**
          * @brief 设置连接状态变化回调
@@ -198,8 +379,39 @@ namespace net
          * @brief 在事件循环线程中实际发送数据
          * @param data 待发送的数据
          * @param len 数据长度
+         * @return 连接已断开或发生致命写错误时返回 false
          */
-        void sendInLoop(const void *data, size_t len);
+        bool sendInLoop(const void *data, size_t len);
+
+        /**
+         * @brief 将缓冲区占用的变化发布到事件循环指标（只在事件循环线程中调用）
+         */
+        void publishBufferMetrics();
+
+        /**
+         * @brief 检查输入缓冲区能否满足等待中的读请求，能满足（或连接已断开）时填写结果
+         * @param awaiter 读请求
+         * @return 读请求已完成返回 true
+         */
+        bool tryCompleteRead(ReadAwaiter *awaiter);
+
+        /**
+         * @brief 发送写请求的数据，未能全部写入内核时登记为等待中的写请求
+         * @param awaiter 写请求
+         * @return 需要挂起等待返回 true
+         */
+        bool startWrite(WriteAwaiter *awaiter);
+
+        /**
+         * @brief 等待中的读请求可以完成时恢复对应协程
+         */
+        void resumeReader();
+
+        /**
+         * @brief 恢复等待中的写请求对应的协程
+         * @param ok 写入是否成功
+         */
+        void resumeWriter(bool ok);
 
         /**
          * @brief 在事件循环线程中实际关闭连接
@@ -218,8 +430,8 @@ namespace net
         std::atomic_int state_; //!< 原子连接状态（StateE 枚举值）
         bool reading_;          //!< 读事件监听标志位
 
-        std::unique_ptr<Socket> socket_;  //!< 套接字资源管理（RAII）
-        std::unique_ptr<Channel> channel_;//!< 事件通道管理（绑定 socket 和事件回调）
+        Socket socket_;  //!< 套接字资源管理（RAII，与连接对象一起分配）
+        Channel channel_;//!< 事件通道管理（绑定 socket 和事件回调，与连接对象一起分配）
 
         const InetAddress localAddr_;//!< 本地地址信息（IP+Port）
         const InetAddress peerAddr_; //!< 对端地址信息（IP+Port）
@@ -235,6 +447,18 @@ namespace net
 
         Buffer inputBuffer_; //!< 输入缓冲区（存储接收数据）
         Buffer outputBuffer_;//!< 输出缓冲区（存储待发送数据）
+
+        NgxBlockSource *blockSource_;                   //!< 缓冲区与请求内存池的内存来源
+        std::unique_ptr<NgxMemPool> memPool_;           //!< 请求内存池（未启用时为空）
+        std::unique_ptr<NgxMemoryResource> memResource_;//!< 请求内存池的 pmr 适配器（与 memPool_ 同时存在）
+        NgxPoolStats_t memPoolPublished_{};             //!< 上次发布到事件循环指标的内存池统计
+        int64_t bufferBytesPublished_ = 0;              //!< 上次发布的缓冲区已分配字节数
+        int64_t outputPendingPublished_ = 0;            //!< 上次发布的输出缓冲区待发送字节数
+
+        //------------------------- 协程状态 -------------------------
+        bool coroutineMode_ = false;          //!< 是否由协程读取数据（此时不再触发消息回调）
+        ReadAwaiter *readWaiter_ = nullptr;   //!< 等待中的读请求
+        WriteAwaiter *writeWaiter_ = nullptr; //!< 等待中的写请求
     };
 }// namespace net
 
@@ -12,6 +12,7 @@
 #include "InetAddress.h"
 #include "Logger.h"
 #include "NonCopyable.h"
+#include "ObjectPool.h"
 #include "SysHeadFile.h"
 #include "TcpConnection.h"
 
@@ -61,6 +62,19 @@ namespace net
          */
         void setThreadNum(int numThreads);
 
+        /**
+         * @brief 设置为每个新连接创建的请求内存池大小
+         * @param size 内存池每个内存块的大小，0 表示不创建（默认）
+         */
+        void setConnectionMemPoolSize(size_t size);
+
+        /**
+         * @brief 设置新连接的缓冲区与请求内存池的内存来源（默认 malloc/free）
+         * @param source 内存来源（如使用大页的 NgxMmapBlockSource），需比服务器及其所有连接活得久
+         * @note 请求内存池的内存块与大块内存都从该来源申请；缓冲区只有不小于 2MB 的存储才从该来源申请
+         */
+        void setBlockSource(NgxBlockSource *source);
+
         /**
          * @brief 启动服务器，开始监听端口
          */
@@ -124,6 +138,55 @@ namespace net
          */
         void newConnection(int sockfd, const InetAddress &peerAddr);
 
+        /**
+         * @struct AcceptedSocket
+         * @brief 已接受、等待 ioLoop 创建连接对象的套接字
+         */
+        struct AcceptedSocket
+        {
+            int sockfd;           //!< 新连接的套接字文件描述符
+            int connId;           //!< 连接ID
+            InetAddress localAddr;//!< 本端地址
+            InetAddress peerAddr; //!< 对端地址
+        };
+
+        /**
+         * @struct LoopHandoff
+         * @brief baseloop 与一个 ioLoop 之间的连接交接队列
+         *
+         * 每个方向只在队列由空变为非空时投递一个只捕获 this 与 ioLoop 的任务（放得进 std::function 的内联存储），
+         * 取走时与备用 vector 交换，稳定状态下交接本身不分配内存
+         */
+        struct LoopHandoff
+        {
+            std::mutex mutex;                           //!< 保护 accepted 与 created
+            std::vector<AcceptedSocket> accepted;       //!< baseloop -> ioLoop：待创建连接的套接字
+            std::vector<TcpConnectionPtr> created;      //!< ioLoop -> baseloop：待加入 [connections_] 的连接
+            std::vector<AcceptedSocket> acceptedBatch;  //!< ioLoop 取走 accepted 时交换用（仅 ioLoop 线程访问）
+            std::vector<TcpConnectionPtr> establishing; //!< 本批新建、尚未建立的连接（仅 ioLoop 线程访问）
+            std::vector<TcpConnectionPtr> createdBatch; //!< baseloop 取走 created 时交换用（仅 baseloop 线程访问）
+        };
+
+        /**
+         * @brief 在 ioLoop 线程中为交接队列中的套接字创建连接，交给 baseloop 登记后建立连接
+         * @param ioLoop 当前线程的事件循环
+         */
+        void createConnectionsInLoop(EventLoop *ioLoop);
+
+        /**
+         * @brief 从 ioLoop 的连接对象池创建连接并设置回调
+         * @param ioLoop 连接所属的事件循环（当前线程）
+         * @param accepted 已接受的套接字
+         * @return 新连接（尚未建立）
+         */
+        TcpConnectionPtr createConnection(EventLoop *ioLoop, const AcceptedSocket &accepted);
+
+        /**
+         * @brief 在 baseloop 线程中将 ioLoop 新建的连接加入 [connections_]
+         * @param ioLoop 创建连接的事件循环
+         */
+        void addConnectionsInLoop(EventLoop *ioLoop);
+
         /**
          * @brief 移除连接（供 TcpConnection 回调）
          * @param conn 需要移除的连接对象
@@ -150,9 +213,12 @@ namespace net
         WriteCompleteCallback writeCompleteCallback_;//!< 数据完全写入时回调
         ThreadInitCallback threadInitCallback_;      //!< 时间循环线程的初始化回调
 
-        std::atomic_int started_;  //!< 服务器启动状态标记
-        int nextConnId_;           //!< 下一个连接的序列号（用于生成连接名称）
-        ConnectionMap connections_;//!< 当前维护的所有连接集合（线程安全需保障）
+        std::atomic_int started_;    //!< 服务器启动状态标记
+        int nextConnId_;             //!< 下一个连接的序列号（用于生成连接名称）
+        size_t connMemPoolSize_;     //!< 新连接的请求内存池大小（0 表示不创建）
+        NgxBlockSource *blockSource_;//!< 新连接的缓冲区与请求内存池的内存来源
+        ConnectionMap connections_;  //!< 当前维护的所有连接集合（只在 baseloop 线程访问）
+        std::unordered_map<EventLoop *, std::unique_ptr<LoopHandoff>> handoffs_;//!< 各 ioLoop 的交接队列（start() 后只读）
     };
 }// namespace net
 
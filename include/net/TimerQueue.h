@@ -0,0 +1,111 @@
+//
+// Created by shuzeyong on 2025/5/18.
+//
+
+#ifndef MY_MUDUO_TIMERQUEUE_H
+#define MY_MUDUO_TIMERQUEUE_H
+
+#include "NonCopyable.h"
+#include "SysHeadFile.h"
+
+namespace net
+{
+    class Channel;
+    class EventLoop;
+
+    using TimerId = uint64_t;//!< 定时器标识（0 表示无效）
+
+    /**
+     * @class TimerQueue
+     * @brief 基于 timerfd 的定时器队列，定时器回调在所属事件循环线程中执行
+     *
+     * - 所有定时器按到期时间（CLOCK_MONOTONIC）组织为最小堆，timerfd 始终设置为堆顶的到期时间
+     * - 到期定时器在 timerfd 可读时批量取出执行，周期定时器执行后重新入堆
+     * - 堆存储区稳定后复用，添加定时器不再分配内存（回调本身的分配除外）
+     *
+     * @note 由 [EventLoop] 持有，用户通过 [EventLoop::runAfter()] 等接口使用
+     */
+    class TimerQueue : NonCopyable
+    {
+    public:
+        using TimerCallback = std::function<void()>;//!< 定时器回调类型
+
+        /**
+         * @brief 构造函数，创建 timerfd 并注册到事件循环
+         * @param loop 所属事件循环
+         */
+        explicit TimerQueue(EventLoop *loop);
+
+        /**
+         * @brief 析构函数，注销并关闭 timerfd
+         */
+        ~TimerQueue();
+
+        /**
+         * @brief 添加定时器（线程安全）
+         * @param cb 定时器回调
+         * @param expiration 到期时间（CLOCK_MONOTONIC 纳秒）
+         * @param interval 重复间隔（纳秒），0 表示只执行一次
+         * @return 定时器标识
+         */
+        TimerId addTimer(TimerCallback cb, int64_t expiration, int64_t interval);
+
+        /**
+         * @brief 取消定时器（线程安全），定时器已执行或已取消时无效果
+         * @param timerId 定时器标识
+         */
+        void cancel(TimerId timerId);
+
+    private:
+        /**
+         * @struct Timer
+         * @brief 定时器条目
+         */
+        struct Timer
+        {
+            int64_t expiration;//!< 到期时间（CLOCK_MONOTONIC 纳秒）
+            int64_t interval;  //!< 重复间隔（纳秒），0 表示只执行一次
+            TimerId id;        //!< 定时器标识
+            TimerCallback cb;  //!< 定时器回调
+            bool cancelled;    //!< 是否已取消
+        };
+
+        /**
+         * @brief 最小堆比较函数：到期时间早的在堆顶，相同时按添加顺序
+         */
+        static bool later(const Timer &lhs, const Timer &rhs)
+        {
+            return lhs.expiration != rhs.expiration ? lhs.expiration > rhs.expiration : lhs.id > rhs.id;
+        }
+
+        /**
+         * @brief 在事件循环线程中添加定时器
+         */
+        void addTimerInLoop(Timer &&timer);
+
+        /**
+         * @brief 在事件循环线程中取消定时器
+         */
+        void cancelInLoop(TimerId timerId);
+
+        /**
+         * @brief 处理 timerfd 可读事件：执行所有到期定时器
+         */
+        void handleRead();
+
+        /**
+         * @brief 按堆顶到期时间重新设置 timerfd
+         */
+        void resetTimerfd();
+
+        EventLoop *loop_;                        //!< 所属事件循环
+        const int timerfd_;                      //!< timerfd 文件描述符
+        std::unique_ptr<Channel> timerfdChannel_;//!< timerfd 事件通道
+        std::vector<Timer> timers_;              //!< 定时器最小堆
+        std::vector<Timer> expired_;             //!< 正在执行的到期定时器（复用存储区）
+        int64_t armedExpiration_;                //!< timerfd 当前设置的到期时间（0 表示未设置）
+        std::atomic<TimerId> nextId_;            //!< 下一个定时器标识
+    };
+}// namespace net
+
+#endif//MY_MUDUO_TIMERQUEUE_H
@@ -12,10 +12,18 @@ namespace net
     /**
      * @class Timestamp
      * @brief 时间戳类，用于表示从 Epoch（1970-01-01 00:00:00 UTC）开始的微秒数
+     *
+     * - [now()] 基于 CLOCK_REALTIME，可格式化为日历时间
+     * - [monotonic()] 基于 CLOCK_MONOTONIC，不受系统时间调整影响，只用于计算时间间隔
+     *
+     * 两种时间戳的起点不同，不可相互比较或相减
      */
     class Timestamp
     {
     public:
+        static const int kMicroSecondsPerSecond = 1000 * 1000;//!< 每秒的微秒数
+        static const int kNanoSecondsPerMicroSecond = 1000;    //!< 每微秒的纳秒数
+
         /**
          * @brief 默认构造函数，初始化时间为 0
          */
@@ -28,20 +36,100 @@ namespace net
         explicit Timestamp(int64_t microSecondsSinceEpoch);
 
         /**
-         * @brief 获取当前时间的时间戳
+         * @brief 获取当前时间的时间戳（CLOCK_REALTIME，微秒精度）
          * @return 返回当前时间的时间戳
          */
         static Timestamp now();
 
         /**
-         * @brief 将时间戳转换为字符串
+         * @brief 获取单调时钟的时间戳（CLOCK_MONOTONIC，微秒精度）
+         * @return 返回单调时钟的时间戳，起点为系统启动时刻
+         */
+        static Timestamp monotonic();
+
+        /**
+         * @brief 获取单调时钟的纳秒数，用于需要亚微秒精度的计时
+         * @return 从系统启动开始的纳秒数
+         */
+        static int64_t monotonicNanoseconds();
+
+        /**
+         * @brief 获取无效时间戳（值为 0）
+         * @return 无效时间戳
+         */
+        static Timestamp invalid() { return {}; }
+
+        /**
+         * @brief 判断时间戳是否有效
+         * @return 大于 0 时返回 true
+         */
+        [[nodiscard]] bool valid() const { return microSecondsSinceEpoch_ > 0; }
+
+        /**
+         * @brief 将时间戳转换为字符串（秒精度，"YYYY/MM/DD HH:MM:SS"）
          * @return 返回时间戳的字符串表示
          */
-        std::string toString();
+        [[nodiscard]] std::string toString() const;
+
+        /**
+         * @brief 将时间戳转换为字符串
+         * @param showMicroseconds 是否附带 ".微秒" 部分
+         * @return 返回 "YYYY/MM/DD HH:MM:SS[.uuuuuu]" 格式的字符串
+         */
+        [[nodiscard]] std::string toFormattedString(bool showMicroseconds = true) const;
+
+        /**
+         * @brief 获取从 Epoch 开始的微秒数
+         * @return 微秒数
+         */
+        [[nodiscard]] int64_t microSecondsSinceEpoch() const;
+
+        /**
+         * @brief 获取从 Epoch 开始的秒数
+         * @return 秒数
+         */
+        [[nodiscard]] time_t secondsSinceEpoch() const;
+
+        auto operator<=>(const Timestamp &) const = default;
 
     private:
         int64_t microSecondsSinceEpoch_; //!< 从 Epoch 开始的微秒数
     };
+
+    /**
+     * @brief 计算两个时间戳之差
+     * @param high 较晚的时间戳
+     * @param low 较早的时间戳
+     * @return 相差的秒数
+     */
+    inline double timeDifference(Timestamp high, Timestamp low)
+    {
+        int64_t diff = high.microSecondsSinceEpoch() - low.microSecondsSinceEpoch();
+        return static_cast<double>(diff) / Timestamp::kMicroSecondsPerSecond;
+    }
+
+    /**
+     * @brief 计算两个时间戳之差
+     * @param high 较晚的时间戳
+     * @param low 较早的时间戳
+     * @return 相差的微秒数
+     */
+    inline int64_t microSecondsDifference(Timestamp high, Timestamp low)
+    {
+        return high.microSecondsSinceEpoch() - low.microSecondsSinceEpoch();
+    }
+
+    /**
+     * @brief 在时间戳上增加一段时间
+     * @param timestamp 原时间戳
+     * @param seconds 增加的秒数（可为小数或负数）
+     * @return 新的时间戳
+     */
+    inline Timestamp addTime(Timestamp timestamp, double seconds)
+    {
+        auto delta = static_cast<int64_t>(seconds * Timestamp::kMicroSecondsPerSecond);
+        return Timestamp(timestamp.microSecondsSinceEpoch() + delta);
+    }
 }// namespace net
 
 #endif//MY_MUDUO_TIMESTAMP_H
@@ -0,0 +1,137 @@
+#ifndef THREADPOOL_EVENT_COUNT_H
+#define THREADPOOL_EVENT_COUNT_H
+
+#include "../net/NonCopyable.h"
+#include "../net/SysHeadFile.h"
+
+#include <climits>
+#include <linux/futex.h>
+
+namespace thp
+{
+    /**
+     * @class EventCount
+     * @brief 基于 futex 的事件计数器，让无锁数据结构的消费者在条件不满足时休眠
+     *
+     * 使用方式（消费者）：
+     * @code
+     * while (!queue.tryPop(item))
+     * {
+     *     EventCount::Key key = ec.prepareWait();
+     *     if (queue.tryPop(item)) { ec.cancelWait(); break; }   // 登记后必须复查条件
+     *     ec.wait(key);
+     * }
+     * @endcode
+     * 生产者在使条件成立后调用 [notifyOne()] / [notifyAll()]；没有等待者时只是一次原子读，不进入内核
+     *
+     * @note 登记等待者（seq_cst）与生产者“修改条件 -> seq_cst 栅栏 -> 读取等待者数”构成 Dekker 式同步，
+     *       因此复查条件之后的通知不会丢失
+     */
+    class EventCount : net::NonCopyable
+    {
+    public:
+        using Key = uint32_t;//!< 登记等待时的纪元
+
+        EventCount()
+            : epoch_(0),
+              waiters_(0)
+        {}
+
+        /**
+         * @brief 登记为等待者，之后必须复查条件，再调用 [cancelWait()] 或 [wait()]
+         * @return 当前纪元
+         */
+        Key prepareWait()
+        {
+            waiters_.fetch_add(1, std::memory_order_seq_cst);
+            return epoch_.load(std::memory_order_seq_cst);
+        }
+
+        /**
+         * @brief 复查发现条件已满足，取消等待
+         */
+        void cancelWait()
+        {
+            waiters_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+
+        /**
+         * @brief 休眠直到纪元变化（有通知）
+         * @param key [prepareWait()] 返回的纪元
+         */
+        void wait(Key key)
+        {
+            while (epoch_.load(std::memory_order_acquire) == key)
+            {
+                futexWait(key, nullptr);
+            }
+            waiters_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+
+        /**
+         * @brief 休眠直到纪元变化或超时
+         * @param key [prepareWait()] 返回的纪元
+         * @param deadline 截止时间
+         * @return 被通知返回 true，超时返回 false
+         */
+        bool waitUntil(Key key, std::chrono::steady_clock::time_point deadline)
+        {
+            bool notified = true;
+            while (epoch_.load(std::memory_order_acquire) == key)
+            {
+                auto remaining = deadline - std::chrono::steady_clock::now();
+                if (remaining <= std::chrono::steady_clock::duration::zero())
+                {
+                    notified = false;
+                    break;
+                }
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+                timespec timeout{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+                futexWait(key, &timeout);
+            }
+            waiters_.fetch_sub(1, std::memory_order_seq_cst);
+            return notified;
+        }
+
+        /**
+         * @brief 唤醒一个等待者
+         */
+        void notifyOne()
+        {
+            notify(1);
+        }
+
+        /**
+         * @brief 唤醒所有等待者
+         */
+        void notifyAll()
+        {
+            notify(INT_MAX);
+        }
+
+    private:
+        void notify(int count)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters_.load(std::memory_order_seq_cst) == 0)
+            {
+                return;
+            }
+            epoch_.fetch_add(1, std::memory_order_seq_cst);
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+        }
+
+        void futexWait(Key key, const timespec *timeout)
+        {
+            // 纪元已变化时内核立即返回 EAGAIN；被信号中断或超时由调用方循环处理
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_), FUTEX_WAIT_PRIVATE, key, timeout, nullptr, 0);
+        }
+
+        static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32 bits");
+
+        alignas(64) std::atomic<uint32_t> epoch_;//!< 纪元，每次有等待者时的通知加一（futex 字）
+        std::atomic<uint32_t> waiters_;          //!< 已登记的等待者数量
+    };
+}// namespace thp
+
+#endif//THREADPOOL_EVENT_COUNT_H
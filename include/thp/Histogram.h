@@ -0,0 +1,169 @@
+#ifndef THREADPOOL_HISTOGRAM_H
+#define THREADPOOL_HISTOGRAM_H
+
+#include "../net/NonCopyable.h"
+#include "../net/SysHeadFile.h"
+
+#include <array>
+#include <cmath>
+
+namespace thp
+{
+    const int HISTOGRAM_SUB_BUCKET_BITS = 3;                                //!< 每个 2 的幂区间细分的位数
+    const size_t HISTOGRAM_SUB_BUCKETS = size_t(1) << HISTOGRAM_SUB_BUCKET_BITS;//!< 每个 2 的幂区间的桶数
+    const int HISTOGRAM_MAX_BITS = 44;                                      //!< 可区分的最大值位数，更大的值计入最后一个桶
+    const size_t HISTOGRAM_BUCKET_COUNT =
+            (HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS;//!< 桶数量
+
+    /**
+     * @struct HistogramSnapshot
+     * @brief 直方图快照，可合并多个线程的直方图并计算分位数
+     *
+     * 桶按对数-线性划分（HDR 风格）：小于 8 的值各占一个桶，之后每个 2 的幂区间均分为 8 个桶，
+     * 相对误差不超过 12.5%
+     */
+    struct HistogramSnapshot
+    {
+        std::array<uint64_t, HISTOGRAM_BUCKET_COUNT> buckets{};//!< 各桶计数
+        uint64_t count = 0;                                   //!< 样本数
+        uint64_t sum = 0;                                     //!< 样本总和
+        uint64_t max = 0;                                     //!< 最大样本
+
+        /**
+         * @brief 计算值所在的桶
+         */
+        static size_t bucketIndex(uint64_t value)
+        {
+            if (value < HISTOGRAM_SUB_BUCKETS)
+            {
+                return static_cast<size_t>(value);
+            }
+            int msb = 63 - __builtin_clzll(value);
+            if (msb >= HISTOGRAM_MAX_BITS)
+            {
+                return HISTOGRAM_BUCKET_COUNT - 1;
+            }
+            int shift = msb - HISTOGRAM_SUB_BUCKET_BITS;
+            size_t sub = static_cast<size_t>(value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1);
+            return static_cast<size_t>(shift + 1) * HISTOGRAM_SUB_BUCKETS + sub;
+        }
+
+        /**
+         * @brief 桶内的最大值（桶的上界）
+         */
+        static uint64_t bucketUpperBound(size_t index)
+        {
+            if (index < HISTOGRAM_SUB_BUCKETS)
+            {
+                return index;
+            }
+            size_t shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+            size_t sub = index % HISTOGRAM_SUB_BUCKETS;
+            return ((HISTOGRAM_SUB_BUCKETS + sub + 1) << shift) - 1;
+        }
+
+        /**
+         * @brief 合并另一个快照
+         */
+        void merge(const HistogramSnapshot &other)
+        {
+            for (size_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i)
+            {
+                buckets[i] += other.buckets[i];
+            }
+            count += other.count;
+            sum += other.sum;
+            max = std::max(max, other.max);
+        }
+
+        /**
+         * @brief 计算分位数
+         * @param q 分位（0 ~ 1），例如 0.99
+         * @return 分位数所在桶的上界（不超过最大样本），无样本时返回 0
+         */
+        [[nodiscard]] uint64_t percentile(double q) const
+        {
+            if (count == 0)
+            {
+                return 0;
+            }
+            auto rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(count)));
+            rank = std::clamp<uint64_t>(rank, 1, count);
+            uint64_t seen = 0;
+            for (size_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i)
+            {
+                seen += buckets[i];
+                if (seen >= rank)
+                {
+                    return std::min(bucketUpperBound(i), max);
+                }
+            }
+            return max;
+        }
+
+        /**
+         * @brief 平均值
+         */
+        [[nodiscard]] double mean() const
+        {
+            return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+        }
+    };
+
+    /**
+     * @class Histogram
+     * @brief 单写者直方图：记录时只有普通的原子读写（无锁前缀指令），其他线程可随时读取快照
+     *
+     * 每个线程持有自己的直方图，需要时通过 [snapshotInto()] 汇总，热路径上没有共享写入
+     *
+     * @note 同一时刻只能有一个线程调用 [record()]
+     */
+    class Histogram : net::NonCopyable
+    {
+    public:
+        Histogram() = default;
+
+        /**
+         * @brief 记录一个样本（仅所属线程调用）
+         * @param value 样本值
+         */
+        void record(uint64_t value)
+        {
+            increment(buckets_[HistogramSnapshot::bucketIndex(value)], 1);
+            increment(count_, 1);
+            increment(sum_, value);
+            if (value > max_.load(std::memory_order_relaxed))
+            {
+                max_.store(value, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief 将当前数据累加到快照中（任意线程调用，各字段之间不保证严格一致）
+         * @param snapshot 快照
+         */
+        void snapshotInto(HistogramSnapshot &snapshot) const
+        {
+            for (size_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i)
+            {
+                snapshot.buckets[i] += buckets_[i].load(std::memory_order_relaxed);
+            }
+            snapshot.count += count_.load(std::memory_order_relaxed);
+            snapshot.sum += sum_.load(std::memory_order_relaxed);
+            snapshot.max = std::max(snapshot.max, max_.load(std::memory_order_relaxed));
+        }
+
+    private:
+        static void increment(std::atomic<uint64_t> &counter, uint64_t delta)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+
+        std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKET_COUNT> buckets_{};//!< 各桶计数
+        std::atomic<uint64_t> count_{0};                                    //!< 样本数
+        std::atomic<uint64_t> sum_{0};                                      //!< 样本总和
+        std::atomic<uint64_t> max_{0};                                      //!< 最大样本
+    };
+}// namespace thp
+
+#endif//THREADPOOL_HISTOGRAM_H
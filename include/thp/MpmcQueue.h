@@ -0,0 +1,167 @@
+#ifndef THREADPOOL_MPMC_QUEUE_H
+#define THREADPOOL_MPMC_QUEUE_H
+
+#include "../net/NonCopyable.h"
+#include "../net/SysHeadFile.h"
+
+namespace thp
+{
+    /**
+     * @class MpmcQueue
+     * @brief 有界无锁多生产者多消费者队列（Dmitry Vyukov 的环形数组算法）
+     * @tparam T 元素类型，需可默认构造、可移动赋值
+     *
+     * - 每个槽位带一个序号，生产者/消费者各自通过一次 CAS 抢占位置，之后只访问自己抢到的槽位
+     * - 队列满时 [tryPush()] 失败、为空时 [tryPop()] 失败，均不阻塞
+     * - 槽位按缓存行对齐，相邻槽位上的并发读写不会伪共享
+     */
+    template<typename T>
+    class MpmcQueue : net::NonCopyable
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 容量（向上取整为 2 的幂，至少为 2）
+         */
+        explicit MpmcQueue(size_t capacity)
+            : mask_(roundUpPowerOfTwo(capacity) - 1),
+              cells_(new Cell[mask_ + 1]),
+              enqueuePos_(0),
+              dequeuePos_(0)
+        {
+            for (size_t i = 0; i <= mask_; ++i)
+            {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief 尝试入队
+         * @param item 元素（仅在成功时被移走）
+         * @return 队列已满返回 false
+         */
+        bool tryPush(T &item)
+        {
+            size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+            Cell *cell;
+            while (true)
+            {
+                cell = &cells_[pos & mask_];
+                size_t seq = cell->sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0)
+                {
+                    // 槽位空闲，抢占该位置
+                    if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // 槽位仍被上一轮的元素占用：队列已满
+                    return false;
+                }
+                else
+                {
+                    pos = enqueuePos_.load(std::memory_order_relaxed);
+                }
+            }
+            cell->data = std::move(item);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief 尝试出队
+         * @param item 接收元素
+         * @return 队列为空返回 false
+         */
+        bool tryPop(T &item)
+        {
+            size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+            Cell *cell;
+            while (true)
+            {
+                cell = &cells_[pos & mask_];
+                size_t seq = cell->sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0)
+                {
+                    // 槽位已写入，抢占该位置
+                    if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // 槽位尚未写入：队列为空
+                    return false;
+                }
+                else
+                {
+                    pos = dequeuePos_.load(std::memory_order_relaxed);
+                }
+            }
+            item = std::move(cell->data);
+            cell->data = T();
+            cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief 估算当前元素数量（并发下仅供参考）
+         */
+        [[nodiscard]] size_t size() const
+        {
+            size_t enq = enqueuePos_.load(std::memory_order_relaxed);
+            size_t deq = dequeuePos_.load(std::memory_order_relaxed);
+            return enq > deq ? enq - deq : 0;
+        }
+
+        /**
+         * @brief 判断队列是否为空（并发下仅供参考）
+         */
+        [[nodiscard]] bool empty() const
+        {
+            return size() == 0;
+        }
+
+        /**
+         * @brief 获取容量
+         */
+        [[nodiscard]] size_t capacity() const
+        {
+            return mask_ + 1;
+        }
+
+    private:
+        /**
+         * @struct Cell
+         * @brief 槽位：序号等于位置时可写，等于位置 + 1 时可读
+         */
+        struct alignas(64) Cell
+        {
+            std::atomic<size_t> sequence;//!< 槽位序号
+            T data;                      //!< 元素
+        };
+
+        static size_t roundUpPowerOfTwo(size_t n)
+        {
+            size_t size = 2;
+            while (size < n)
+            {
+                size <<= 1;
+            }
+            return size;
+        }
+
+        const size_t mask_;                          //!< 容量 - 1
+        std::unique_ptr<Cell[]> cells_;              //!< 槽位数组
+        alignas(64) std::atomic<size_t> enqueuePos_; //!< 下一个入队位置
+        alignas(64) std::atomic<size_t> dequeuePos_; //!< 下一个出队位置
+    };
+}// namespace thp
+
+#endif//THREADPOOL_MPMC_QUEUE_H
@@ -0,0 +1,217 @@
+#ifndef THREADPOOL_PARALLEL_H
+#define THREADPOOL_PARALLEL_H
+
+#include "ThreadPool.h"
+
+namespace thp
+{
+    namespace detail
+    {
+        /**
+         * @class ParallelLoop
+         * @brief 并行循环的共享状态：按块下标原子领取任务，最后完成的块负责唤醒调用线程
+         */
+        class ParallelLoop : net::NonCopyable
+        {
+        public:
+            using ChunkFunc = void (*)(void *ctx, size_t chunk, size_t lo, size_t hi);
+
+            ParallelLoop(size_t begin, size_t end, size_t grain, ChunkFunc run, void *ctx)
+                : begin_(begin),
+                  end_(end),
+                  grain_(grain),
+                  numChunks_((end - begin + grain - 1) / grain),
+                  run_(run),
+                  ctx_(ctx),
+                  nextChunk_(0),
+                  doneChunks_(0),
+                  finished_(false)
+            {}
+
+            /**
+             * @brief 循环领取并执行剩余的块，直到没有未领取的块
+             *
+             * 领取失败（块已全部领完）时不访问 [ctx_]，因此调用线程返回后迟到的辅助任务也是安全的
+             */
+            void work()
+            {
+                while (true)
+                {
+                    size_t chunk = nextChunk_.fetch_add(1, std::memory_order_relaxed);
+                    if (chunk >= numChunks_)
+                    {
+                        return;
+                    }
+
+                    size_t lo = begin_ + chunk * grain_;
+                    size_t hi = std::min(end_, lo + grain_);
+                    try
+                    {
+                        run_(ctx_, chunk, lo, hi);
+                    } catch (...)
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        if (!error_)
+                        {
+                            error_ = std::current_exception();
+                        }
+                    }
+
+                    if (doneChunks_.fetch_add(1, std::memory_order_acq_rel) + 1 == numChunks_)
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        finished_ = true;
+                        cond_.notify_all();
+                    }
+                }
+            }
+
+            /**
+             * @brief 等待所有块执行完毕，有块抛出异常时重新抛出第一个异常
+             */
+            void wait()
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait(lock, [this]() { return finished_; });
+                if (error_)
+                {
+                    std::rethrow_exception(error_);
+                }
+            }
+
+            [[nodiscard]] size_t numChunks() const { return numChunks_; }
+
+        private:
+            const size_t begin_;             //!< 起始下标
+            const size_t end_;               //!< 结束下标（不含）
+            const size_t grain_;             //!< 每块的元素数
+            const size_t numChunks_;         //!< 块数
+            const ChunkFunc run_;            //!< 块执行函数
+            void *const ctx_;                //!< 块执行函数的上下文（位于调用线程栈上）
+            std::atomic_size_t nextChunk_;   //!< 下一个待领取的块
+            std::atomic_size_t doneChunks_;  //!< 已完成的块数
+            std::mutex mutex_;               //!< 保护下方状态
+            std::condition_variable cond_;   //!< 全部完成时通知调用线程
+            bool finished_;                  //!< 是否全部完成
+            std::exception_ptr error_;       //!< 第一个异常
+        };
+
+        /**
+         * @brief 计算块大小：未指定时按线程数切分，每个线程约 4 块，兼顾负载均衡与调度开销
+         */
+        inline size_t resolveGrain(const ThreadPool &pool, size_t n, size_t grain)
+        {
+            if (grain > 0)
+            {
+                return grain;
+            }
+            size_t chunks = (pool.threadSize() + 1) * 4;
+            return std::max<size_t>(1, (n + chunks - 1) / chunks);
+        }
+
+        /**
+         * @brief 将 [begin, end) 按 grain 切块并行执行，调用线程也参与执行，返回时所有块均已完成
+         * @param chunkFunc 块执行函数，签名为 void(size_t chunk, size_t lo, size_t hi)
+         */
+        template<typename ChunkFunc>
+        void runParallel(ThreadPool &pool, size_t begin, size_t end, size_t grain, ChunkFunc &chunkFunc)
+        {
+            auto loop = std::make_shared<ParallelLoop>(
+                    begin, end, grain,
+                    [](void *ctx, size_t chunk, size_t lo, size_t hi) {
+                        (*static_cast<ChunkFunc *>(ctx))(chunk, lo, hi);
+                    },
+                    &chunkFunc);
+
+            // 辅助任务数不超过线程数，也不超过调用线程之外还需要的块数
+            size_t helpers = std::min<size_t>(pool.threadSize(), loop->numChunks() - 1);
+            if (helpers > 0)
+            {
+                auto helper = [loop]() { loop->work(); };
+                std::vector<decltype(helper)> helperTasks(helpers, helper);
+                pool.postBulk(helperTasks);
+            }
+
+            // 调用线程同样领取块执行，即使所有工作线程都在忙（或在工作线程中嵌套调用）也能完成
+            loop->work();
+            loop->wait();
+        }
+    }// namespace detail
+
+    /**
+     * @brief 并行执行 for (i = begin; i < end; ++i) body(i)
+     * @param pool 线程池
+     * @param begin 起始下标
+     * @param end 结束下标（不含）
+     * @param body 循环体，签名为 void(size_t i)
+     * @param grain 每块的元素数，0 表示自动选择
+     *
+     * 使用方式：
+     * @code
+     * thp::parallelFor(pool, 0, blocks.size(), [&](size_t i) { crc[i] = crc32(blocks[i]); });
+     * @endcode
+     *
+     * @note 阻塞直到全部完成；循环体抛出的第一个异常会在调用线程中重新抛出
+     */
+    template<typename Func>
+    void parallelFor(ThreadPool &pool, size_t begin, size_t end, Func &&body, size_t grain = 0)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+        grain = detail::resolveGrain(pool, end - begin, grain);
+        auto chunkFunc = [&body](size_t, size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i)
+            {
+                body(i);
+            }
+        };
+        detail::runParallel(pool, begin, end, grain, chunkFunc);
+    }
+
+    /**
+     * @brief 并行归约
+     * @param pool 线程池
+     * @param begin 起始下标
+     * @param end 结束下标（不含）
+     * @param identity 归约的单位元
+     * @param reduce 块归约函数，签名为 T(size_t lo, size_t hi, T init)
+     * @param combine 合并函数，签名为 T(T lhs, T rhs)
+     * @param grain 每块的元素数，0 表示自动选择
+     * @return 归约结果
+     *
+     * 各块结果按块顺序合并，combine 只需满足结合律，不要求交换律
+     *
+     * 使用方式：
+     * @code
+     * uint64_t sum = thp::parallelReduce(pool, 0, data.size(), uint64_t(0),
+     *         [&](size_t lo, size_t hi, uint64_t acc) { for (; lo < hi; ++lo) acc += data[lo]; return acc; },
+     *         std::plus<>());
+     * @endcode
+     */
+    template<typename T, typename Reduce, typename Combine>
+    T parallelReduce(ThreadPool &pool, size_t begin, size_t end, T identity, Reduce &&reduce, Combine &&combine,
+                     size_t grain = 0)
+    {
+        if (begin >= end)
+        {
+            return identity;
+        }
+        grain = detail::resolveGrain(pool, end - begin, grain);
+        std::vector<T> partials((end - begin + grain - 1) / grain, identity);
+        auto chunkFunc = [&](size_t chunk, size_t lo, size_t hi) {
+            partials[chunk] = reduce(lo, hi, identity);
+        };
+        detail::runParallel(pool, begin, end, grain, chunkFunc);
+
+        T result = identity;
+        for (T &partial: partials)
+        {
+            result = combine(std::move(result), std::move(partial));
+        }
+        return result;
+    }
+}// namespace thp
+
+#endif//THREADPOOL_PARALLEL_H
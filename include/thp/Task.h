@@ -0,0 +1,423 @@
+#ifndef THREADPOOL_TASK_H
+#define THREADPOOL_TASK_H
+
+#include "../net/SysHeadFile.h"
+
+#include <cstddef>
+
+namespace thp
+{
+    /**
+     * @class Task
+     * @brief 只可移动的 void() 可调用对象包装，小对象内联存储
+     *
+     * 与 std::function 相比：
+     * - 只要求可调用对象可移动（可以捕获 std::promise、std::unique_ptr 等）
+     * - 不超过 [kInlineSize] 字节且 noexcept 可移动的可调用对象直接存放在内部缓冲区，不分配堆内存
+     * - 对象大小恰好为一个缓存行（64 字节）
+     */
+    class Task
+    {
+    public:
+        static constexpr size_t kInlineSize = 64 - sizeof(void *);//!< 内联存储的最大字节数
+
+        Task() noexcept = default;
+
+        Task(std::nullptr_t) noexcept {}// NOLINT(google-explicit-constructor)
+
+        /**
+         * @brief 由任意 void() 可调用对象构造
+         * @tparam F 可调用对象类型
+         * @param f 可调用对象
+         */
+        template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task> &&
+                                                          std::is_invocable_v<std::decay_t<F> &>>>
+        Task(F &&f)// NOLINT(google-explicit-constructor)
+        {
+            using Fn = std::decay_t<F>;
+            if constexpr (fitsInline<Fn>())
+            {
+                ::new (static_cast<void *>(storage_)) Fn(std::forward<F>(f));
+                ops_ = &kInlineOps<Fn>;
+            }
+            else
+            {
+                *reinterpret_cast<Fn **>(storage_) = new Fn(std::forward<F>(f));
+                ops_ = &kHeapOps<Fn>;
+            }
+        }
+
+        Task(Task &&other) noexcept
+        {
+            moveFrom(other);
+        }
+
+        Task &operator=(Task &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                moveFrom(other);
+            }
+            return *this;
+        }
+
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+
+        ~Task()
+        {
+            reset();
+        }
+
+        /**
+         * @brief 执行任务
+         */
+        void operator()()
+        {
+            ops_->invoke(storage_);
+        }
+
+        /**
+         * @brief 是否持有可调用对象
+         */
+        explicit operator bool() const noexcept
+        {
+            return ops_ != nullptr;
+        }
+
+        /**
+         * @brief 销毁持有的可调用对象
+         */
+        void reset() noexcept
+        {
+            if (ops_)
+            {
+                ops_->destroy(storage_);
+                ops_ = nullptr;
+            }
+        }
+
+    private:
+        /**
+         * @struct Ops
+         * @brief 类型擦除的操作表，每种可调用对象类型一份
+         */
+        struct Ops
+        {
+            void (*invoke)(void *storage);
+            void (*move)(void *dst, void *src) noexcept;// 移动到 dst 并销毁 src
+            void (*destroy)(void *storage) noexcept;
+        };
+
+        template<typename Fn>
+        static constexpr bool fitsInline()
+        {
+            return sizeof(Fn) <= kInlineSize && alignof(Fn) <= alignof(std::max_align_t) &&
+                   std::is_nothrow_move_constructible_v<Fn>;
+        }
+
+        template<typename Fn>
+        static constexpr Ops kInlineOps = {
+                [](void *storage) { (*static_cast<Fn *>(storage))(); },
+                [](void *dst, void *src) noexcept {
+                    ::new (dst) Fn(std::move(*static_cast<Fn *>(src)));
+                    static_cast<Fn *>(src)->~Fn();
+                },
+                [](void *storage) noexcept { static_cast<Fn *>(storage)->~Fn(); }};
+
+        template<typename Fn>
+        static constexpr Ops kHeapOps = {
+                [](void *storage) { (**static_cast<Fn **>(storage))(); },
+                [](void *dst, void *src) noexcept { *static_cast<Fn **>(dst) = *static_cast<Fn **>(src); },
+                [](void *storage) noexcept { delete *static_cast<Fn **>(storage); }};
+
+        void moveFrom(Task &other) noexcept
+        {
+            if (other.ops_)
+            {
+                other.ops_->move(storage_, other.storage_);
+                ops_ = other.ops_;
+                other.ops_ = nullptr;
+            }
+        }
+
+        alignas(std::max_align_t) unsigned char storage_[kInlineSize];//!< 内联存储区（或堆对象指针）
+        const Ops *ops_ = nullptr;                                     //!< 操作表，为空表示不持有任务
+    };
+
+    /**
+     * @class RingQueue
+     * @brief 基于环形数组的 FIFO 队列（std::queue 接口子集）
+     * @tparam T 元素类型，需可默认构造、可移动
+     *
+     * 容量按需翻倍且不收缩，稳定运行后入队出队不再分配内存
+     * （std::deque 每跨过一个分块就要申请/释放一次内存）
+     */
+    template<typename T>
+    class RingQueue
+    {
+    public:
+        RingQueue()
+            : slots_(16),
+              head_(0),
+              size_(0)
+        {}
+
+        template<typename... Args>
+        void emplace(Args &&...args)
+        {
+            if (size_ == slots_.size())
+            {
+                grow();
+            }
+            slots_[(head_ + size_) & (slots_.size() - 1)] = T(std::forward<Args>(args)...);
+            ++size_;
+        }
+
+        void push(T item)
+        {
+            emplace(std::move(item));
+        }
+
+        T &front()
+        {
+            return slots_[head_];
+        }
+
+        /**
+         * @brief 弹出队头（同时销毁其中残留的对象，如任务捕获的资源）
+         */
+        void pop()
+        {
+            slots_[head_] = T();
+            head_ = (head_ + 1) & (slots_.size() - 1);
+            --size_;
+        }
+
+        [[nodiscard]] size_t size() const { return size_; }
+        [[nodiscard]] bool empty() const { return size_ == 0; }
+
+    private:
+        void grow()
+        {
+            std::vector<T> bigger(slots_.size() * 2);
+            for (size_t i = 0; i < size_; ++i)
+            {
+                bigger[i] = std::move(slots_[(head_ + i) & (slots_.size() - 1)]);
+            }
+            slots_.swap(bigger);
+            head_ = 0;
+        }
+
+        std::vector<T> slots_;//!< 环形存储区，大小为 2 的幂
+        size_t head_;         //!< 队头下标
+        size_t size_;         //!< 元素数量
+    };
+
+    using TaskQueue = RingQueue<Task>;//!< 任务队列
+
+    namespace detail
+    {
+        /**
+         * @class SharedStateCache
+         * @brief 分级空闲块缓存，供 [SharedStateAllocator] 使用
+         *
+         * 两级结构：
+         * - 线程本地缓存：无锁，命中时直接复用
+         * - 全局中心链表（加锁）：线程缓存过多时批量归还，为空时批量取回
+         *
+         * 共享状态通常在提交线程分配、在工作线程释放，块会单向流动，
+         * 批量归还/取回使这种情况下平均每 [kBatchSize] 次分配才加一次锁
+         */
+        class SharedStateCache
+        {
+        public:
+            static constexpr size_t kGranularity = 64;                          //!< 分级粒度
+            static constexpr size_t kNumClasses = 8;                            //!< 分级数量
+            static constexpr size_t kMaxPooledSize = kGranularity * kNumClasses;//!< 池化的最大块
+            static constexpr size_t kBatchSize = 32;                            //!< 与中心链表交换的批量大小
+            static constexpr size_t kMaxLocalPerClass = 2 * kBatchSize;         //!< 线程缓存每个分级的上限
+            static constexpr size_t kMaxCentralPerClass = 4096;                 //!< 中心链表每个分级的上限
+
+            ~SharedStateCache()
+            {
+                // 线程退出时把缓存的块全部还给中心链表（已清空时不访问中心链表）
+                flush();
+            }
+
+            /**
+             * @brief 把本线程缓存的块全部还给中心链表
+             */
+            void flush() noexcept
+            {
+                for (size_t cls = 0; cls < kNumClasses; ++cls)
+                {
+                    while (heads_[cls])
+                    {
+                        releaseBatch(cls);
+                    }
+                }
+            }
+
+            void *allocate(size_t bytes)
+            {
+                size_t cls = sizeClass(bytes);
+                if (!heads_[cls])
+                {
+                    fetchBatch(cls);
+                }
+                if (FreeBlock *block = heads_[cls])
+                {
+                    heads_[cls] = block->next;
+                    --counts_[cls];
+                    return block;
+                }
+                return ::operator new((cls + 1) * kGranularity);
+            }
+
+            void deallocate(void *p, size_t bytes) noexcept
+            {
+                size_t cls = sizeClass(bytes);
+                auto *block = static_cast<FreeBlock *>(p);
+                block->next = heads_[cls];
+                heads_[cls] = block;
+                if (++counts_[cls] > kMaxLocalPerClass)
+                {
+                    releaseBatch(cls);
+                }
+            }
+
+            static SharedStateCache &local()
+            {
+                thread_local SharedStateCache cache;
+                return cache;
+            }
+
+        private:
+            struct FreeBlock
+            {
+                FreeBlock *next;
+            };
+
+            /**
+             * @struct Central
+             * @brief 全局中心链表
+             */
+            struct Central
+            {
+                std::mutex mutex;
+                FreeBlock *heads[kNumClasses] = {};
+                size_t counts[kNumClasses] = {};
+            };
+
+            static Central &central()
+            {
+                // 有意不析构：分离线程的线程局部缓存可能在静态对象析构之后才归还块
+                static Central *instance = new Central;
+                return *instance;
+            }
+
+            static size_t sizeClass(size_t bytes)
+            {
+                return (bytes - 1) / kGranularity;
+            }
+
+            /**
+             * @brief 从中心链表取回至多 kBatchSize 个块
+             */
+            void fetchBatch(size_t cls)
+            {
+                Central &c = central();
+                std::unique_lock<std::mutex> lock(c.mutex);
+                for (size_t i = 0; i < kBatchSize && c.heads[cls]; ++i)
+                {
+                    FreeBlock *block = c.heads[cls];
+                    c.heads[cls] = block->next;
+                    --c.counts[cls];
+                    block->next = heads_[cls];
+                    heads_[cls] = block;
+                    ++counts_[cls];
+                }
+            }
+
+            /**
+             * @brief 归还至多 kBatchSize 个块给中心链表，中心链表已满时释放给系统
+             */
+            void releaseBatch(size_t cls) noexcept
+            {
+                Central &c = central();
+                std::unique_lock<std::mutex> lock(c.mutex);
+                for (size_t i = 0; i < kBatchSize && heads_[cls]; ++i)
+                {
+                    FreeBlock *block = heads_[cls];
+                    heads_[cls] = block->next;
+                    --counts_[cls];
+                    if (c.counts[cls] >= kMaxCentralPerClass)
+                    {
+                        ::operator delete(block);
+                        continue;
+                    }
+                    block->next = c.heads[cls];
+                    c.heads[cls] = block;
+                    ++c.counts[cls];
+                }
+            }
+
+            FreeBlock *heads_[kNumClasses] = {};//!< 各分级的空闲链表
+            size_t counts_[kNumClasses] = {};   //!< 各分级的空闲块数量
+        };
+    }// namespace detail
+
+    /**
+     * @class SharedStateAllocator
+     * @brief std::promise 共享状态的池化分配器
+     * @tparam T 分配的对象类型
+     *
+     * 按 64 字节向上取整分级，由 [detail::SharedStateCache] 缓存空闲块，
+     * 稳定运行后共享状态的分配不再访问全局堆
+     */
+    template<typename T>
+    class SharedStateAllocator
+    {
+    public:
+        using value_type = T;
+
+        SharedStateAllocator() noexcept = default;
+
+        template<typename U>
+        SharedStateAllocator(const SharedStateAllocator<U> &) noexcept {}// NOLINT(google-explicit-constructor)
+
+        T *allocate(size_t n)
+        {
+            size_t bytes = n * sizeof(T);
+            if (!pooled(bytes))
+            {
+                return static_cast<T *>(::operator new(bytes));
+            }
+            return static_cast<T *>(detail::SharedStateCache::local().allocate(bytes));
+        }
+
+        void deallocate(T *p, size_t n) noexcept
+        {
+            size_t bytes = n * sizeof(T);
+            if (!pooled(bytes))
+            {
+                ::operator delete(p);
+                return;
+            }
+            detail::SharedStateCache::local().deallocate(p, bytes);
+        }
+
+        template<typename U>
+        bool operator==(const SharedStateAllocator<U> &) const noexcept { return true; }
+
+    private:
+        static constexpr bool pooled(size_t bytes)
+        {
+            return alignof(T) <= alignof(std::max_align_t) && bytes <= detail::SharedStateCache::kMaxPooledSize;
+        }
+    };
+}// namespace thp
+
+#endif//THREADPOOL_TASK_H
@@ -3,12 +3,23 @@
 
 #include "../net/NonCopyable.h"
 #include "../net/SysHeadFile.h"
+#include "EventCount.h"
+#include "Histogram.h"
+#include "MpmcQueue.h"
+#include "Task.h"
+#include "WorkStealingDeque.h"
+
+#include <coroutine>
+#include <limits>
 
 namespace thp
 {
     const size_t DEFAULT_TASK_QUE_MAX_SIZE = 200;  //!< 任务队列最大任务数量
     const size_t DEFAULT_THREAD_MAX_SIZE = 2048;   //!< 线程池最大线程数量
     const size_t DEFAULT_THREAD_MAX_IDLE_TIME = 60;//!< 线程最大空闲时间
+    const size_t DEFAULT_SCALE_UP_WAIT_US = 1000;  //!< CACHED 模式下排队等待超过该值（微秒）时扩容
+    const size_t DEFAULT_THREAD_SPAWN_RATE = 100;  //!< CACHED 模式下每秒最多创建的线程数
+    const size_t DEFAULT_THREAD_SPAWN_BURST = 8;   //!< CACHED 模式下可连续创建的线程数
 
     /**
      * @enum PoolMode
@@ -16,8 +27,120 @@ namespace thp
      */
     enum class PoolMode
     {
-        MODE_FIXED,//!< 固定数量的线程
-        MODE_CACHED//!< 线程数量可动态增长
+        MODE_FIXED,        //!< 固定数量的线程
+        MODE_CACHED,       //!< 线程数量可动态增长
+        MODE_WORK_STEALING //!< 固定数量的线程，每个线程拥有本地队列，空闲时相互窃取任务
+    };
+
+    /**
+     * @enum RejectPolicy
+     * @brief 任务队列已满时的拒绝策略
+     */
+    enum class RejectPolicy
+    {
+        ABORT,         //!< 立即拒绝
+        CALLER_RUNS,   //!< 在提交线程中直接执行任务
+        DISCARD_OLDEST,//!< 丢弃队列中最早的任务，再放入新任务
+        BLOCK          //!< 阻塞等待队列出现空位，超时后拒绝（trySubmit 不等待，直接拒绝）
+    };
+
+    /**
+     * @enum TaskPriority
+     * @brief 任务优先级，每个优先级对应一条独立的任务队列（lane）
+     */
+    enum class TaskPriority
+    {
+        HIGH,  //!< 延迟敏感的请求处理
+        NORMAL,//!< 默认优先级
+        LOW    //!< 后台批处理
+    };
+
+    const size_t TASK_PRIORITY_COUNT = 3;                 //!< 优先级数量
+    const size_t DEFAULT_STARVATION_THRESHOLD_MS = 100;   //!< 低优先级任务等待超过该时间后优先执行
+
+    /**
+     * @struct LaneStats
+     * @brief 单个优先级队列的统计信息
+     */
+    struct LaneStats
+    {
+        size_t depth;          //!< 当前排队任务数
+        uint64_t submitted;    //!< 累计入队任务数
+        uint64_t executed;     //!< 累计出队执行的任务数
+        uint64_t discarded;    //!< 累计因 DISCARD_OLDEST 被丢弃的任务数（submitted = depth + executed + discarded）
+        uint64_t promoted;     //!< 因等待超时而越过高优先级任务被执行的次数
+        uint64_t totalWaitUs;  //!< 累计排队等待时间（微秒，只含执行的任务）
+        uint64_t maxWaitUs;    //!< 最长排队等待时间（微秒，只含执行的任务）
+
+        /**
+         * @brief 平均排队等待时间（微秒）
+         */
+        [[nodiscard]] double avgWaitUs() const
+        {
+            return executed ? static_cast<double>(totalWaitUs) / static_cast<double>(executed) : 0.0;
+        }
+    };
+
+    /**
+     * @struct ScalingStats
+     * @brief CACHED 模式伸缩控制器的统计信息
+     */
+    struct ScalingStats
+    {
+        size_t threads;          //!< 当前线程数
+        size_t idleThreads;      //!< 空闲线程数
+        double avgQueueWaitUs;   //!< 排队等待时间的指数滑动平均（微秒）
+        double dispatchRate;     //!< 每秒出队的任务数
+        uint64_t threadsCreated; //!< 累计因扩容创建的线程数
+        uint64_t threadsReaped;  //!< 累计因空闲超时回收的线程数
+    };
+
+    /**
+     * @struct PoolStats
+     * @brief 线程池运行统计快照，由 [ThreadPool::stats()] 汇总各工作线程的计数器得到
+     */
+    struct PoolStats
+    {
+        size_t threads;                //!< 当前线程数
+        size_t idleThreads;            //!< 空闲线程数
+        size_t queueDepth;             //!< 排队中的任务数
+        uint64_t executed;             //!< 累计执行的任务数
+        uint64_t steals;               //!< 累计窃取成功的次数（工作窃取模式）
+        uint64_t rejected;             //!< 累计被拒绝的任务数
+        uint64_t callerRuns;           //!< 累计在提交线程中执行的任务数
+        uint64_t discarded;            //!< 累计被丢弃的最早任务数
+        HistogramSnapshot queueWaitNs; //!< 排队等待时间分布（纳秒）
+        HistogramSnapshot runTimeNs;   //!< 执行时间分布（纳秒）
+    };
+
+    /**
+     * @enum SubmitStatus
+     * @brief 任务提交结果
+     */
+    enum class SubmitStatus
+    {
+        OK,         //!< 任务已放入队列
+        CALLER_RUNS,//!< 队列已满，任务已在提交线程中执行完毕
+        REJECTED    //!< 队列已满，任务被拒绝
+    };
+
+    /**
+     * @struct SubmitResult
+     * @brief [ThreadPool::trySubmit()] 的返回值
+     * @tparam R 任务返回值类型
+     *
+     * 任务被拒绝时 future 中保存 std::future_error（broken_promise）
+     */
+    template<typename R>
+    struct SubmitResult
+    {
+        SubmitStatus status;  //!< 提交结果
+        std::future<R> future;//!< 任务结果
+
+        /**
+         * @brief 任务是否被接受（已入队或已由提交线程执行）
+         */
+        [[nodiscard]] bool accepted() const { return status != SubmitStatus::REJECTED; }
     };
 
     /**
@@ -78,10 +201,45 @@ namespace thp
      * 2. 设置线程池模式（可选，默认为固定模式）
      * 3. 设置任务队列最大大小（可选，默认为1024）
      * 4. 设置线程池最大线程数（可选，默认为1024）
+     *    设置拒绝策略（可选，默认为 BLOCK，最长等待 1 秒）
      * 5. 启动线程池，默认线程数为系统支持的并发线程数
      * 6. 提交任务到线程池
      * 7. 获取任务执行结果（可选）
      * 8. 线程池会在析构时自动回收所有线程资源
+     *
+     * MODE_WORK_STEALING 模式：
+     * - 每个工作线程拥有一个 [WorkStealingDeque]，工作线程内提交的任务直接压入自己的队列，不加锁
+     * - 外部线程提交的任务进入全局注入队列（即各优先级队列 [lanes_]，仍受 [taskQueMaxSize_] 限制）
+     * - 工作线程取任务的顺序：本地队列 -> 注入队列 -> 随机选择其他线程窃取
+     * - 无任务时在 [parkCond_] 上休眠；提交任务只在有休眠线程时唤醒其中一个
+     * - 高优先级队列非空时，工作线程先取高优先级任务，再取本地队列
+     *
+     * 优先级：
+     * - 共享任务队列分为 HIGH / NORMAL / LOW 三条，每条各自受 [taskQueMaxSize_] 限制，
+     *   批处理任务占满 LOW 队列不会阻塞或拒绝 HIGH 任务
+     * - 工作线程按优先级取任务；低优先级队首任务等待超过 [starvationThreshold_] 时优先执行，避免饿死
+     * - 通过 [laneStats()] 获取各队列的深度、吞吐与排队延迟
+     *
+     * CACHED 模式的弹性伸缩：
+     * - 扩容依据排队等待时间：取实测等待的指数滑动平均与“积压任务数 / 出队速率”预测值中的较大者，
+     *   超过 [scaleUpWait_] 且积压任务多于空闲线程时才创建线程
+     * - 线程创建受令牌桶限速（[setThreadSpawnRate()]），避免突发流量下线程数爆炸
+     * - 可保留若干备用空闲线程（[setSpareThreads()]），在积压出现前预先创建
+     * - 空闲线程按后进先出唤醒，负载下降后多余的线程持续空闲，到期即被回收；
+     *   空闲线程直接等待到回收期限，不再每秒轮询
+     * - 回收需满足：空闲时间达到 [threadMaxIdleTime]，且距上次扩容也已超过该时间（滞回，避免抖动）
+     *
+     * FIXED 模式的无锁任务队列（[setLockFreeQueue()]，默认关闭）：
+     * - 各优先级队列改为有界无锁 [MpmcQueue]，容量为 [taskQueMaxSize_] 向上取整的 2 的幂，
+     *   提交与取任务都不再竞争 [taskQueMtx_]，消除大量生产者提交小任务时的锁护航
+     * - 工作线程无任务时先短暂自旋，再在 [EventCount]（futex）上休眠；提交任务只在有休眠线程时进入内核唤醒
+     * - 仍按 HIGH -> NORMAL -> LOW 取任务，但不做饥饿保护；[laneStats()] 只统计队列深度
+     *
+     * 运行统计：
+     * - 每个工作线程持有自己的统计块（执行数、窃取数、排队等待与执行时间直方图），只由本线程写入，
+     *   热路径上没有锁和共享写入
+     * - [stats()] 不持有任务队列锁，遍历所有统计块汇总为 [PoolStats]，供指标导出使用；
+     *   快照只含累计值，吞吐等速率由调用方对两次快照的差值自行计算（如 Prometheus 的 rate()）
      */
     class ThreadPool : net::NonCopyable
     {
@@ -98,7 +256,13 @@ namespace thp
               currentTaskSize_(0),
               taskQueMaxSize_(DEFAULT_TASK_QUE_MAX_SIZE),
               poolMode_(PoolMode::MODE_CACHED),
-              poolIsRunning_(false)
+              poolIsRunning_(false),
+              rejectPolicy_(RejectPolicy::BLOCK),
+              blockTimeout_(std::chrono::seconds(1)),
+              rejectedTasks_(0),
+              callerRunsTasks_(0),
+              discardedTasks_(0),
+              starvationThreshold_(std::chrono::milliseconds(DEFAULT_STARVATION_THRESHOLD_MS))
         {}
 
         /**
@@ -107,9 +271,24 @@ namespace thp
         inline ~ThreadPool()
         {
             poolIsRunning_ = false;
+            // 唤醒所有在无锁队列上休眠的工作线程与生产者
+            notEmptyEvent_.notifyAll();
+            for (EventCount &notFull: notFullEvents_)
+            {
+                notFull.notifyAll();
+            }
+            {
+                // 唤醒所有休眠的工作窃取线程
+                std::unique_lock<std::mutex> parkLock(parkMtx_);
+                parkCond_.notify_all();
+            }
             std::unique_lock<std::mutex> lock(taskQueMtx_);
             // 唤醒所有因任务队列为空而阻塞的线程
             taskQueNotEmpty_.notify_all();
+            while (!idleWaiters_.empty())
+            {
+                wakeIdleThreadLocked();
+            }
             // 等待所有线程退出，直到线程列表为空
             exitCond_.wait(lock, [this]() { return threads_.empty(); });
         }
@@ -142,6 +321,25 @@ namespace thp
             taskQueMaxSize_ = size;
         }
 
+        /**
+         * @brief 设置是否使用无锁任务队列（仅 FIXED 模式有效）
+         * @param enable 是否启用，默认关闭
+         *
+         * 启用后各优先级队列改为有界无锁环形队列，工作线程空闲时自旋后在 futex 上休眠；
+         * 适合大量线程并发提交小任务的场景
+         *
+         * @note 启用后不做低优先级任务的饥饿提升，[laneStats()] 只提供队列深度
+         */
+        void setLockFreeQueue(bool enable)
+        {
+            // 如果线程池已经启动，则不予设置
+            if (checkRunningState())
+            {
+                return;
+            }
+            lockFreeQueue_ = enable;
+        }
+
         /**
          * @brief 设置线程最大空闲时间
          * @param size 线程最大空闲时间
@@ -174,248 +372,1755 @@ namespace thp
         }
 
         /**
-         * @brief 提交任务到线程池
-         * @tparam Func 任务函数类型
-         * @tparam Args 任务函数参数类型
-         * @param func 任务函数
-         * @param args 任务函数参数
-         * @return std::future<decltype(func(args...))> 返回一个 std::future 对象，用于获取任务执行结果
+         * @brief 设置 CACHED 模式的扩容阈值
+         * @param wait 排队等待时间超过该值时扩容，默认为 1 毫秒
          */
-        template<typename Func, typename... Args>
-        auto submitTask(Func &&func, Args &&...args) -> std::future<decltype(func(args...))>
+        void setScaleUpWait(std::chrono::microseconds wait)
         {
-            // 使用std::packaged_task将任务函数和参数打包，并获取std::future对象
-            using RType = decltype(func(args...));
-            auto task = std::make_shared<std::packaged_task<RType()>>(
-                    std::bind(std::forward<Func>(func), std::forward<Args>(args)...));
-            std::future<RType> result = task->get_future();
-
-            // 获取锁，确保对任务队列的访问是线程安全的
-            std::unique_lock<std::mutex> lock(taskQueMtx_);
-
-            // 等待任务队列有空余位置，最长等待时间为1秒
-            // 如果1秒后任务队列仍然满，则返回提交失败
-            if (!taskQueNotFull_.wait_for(lock, std::chrono::seconds(1),
-                                          [this]() { return taskQue_.size() < taskQueMaxSize_; }))
+            // 如果线程池已经启动，则不予设置
+            if (checkRunningState())
             {
-                std::cerr << "task queue is full, submit task fail" << std::endl;
-
-                // 返回一个空的std::future对象，表示任务提交失败
-                auto tempTask = std::make_shared<std::packaged_task<RType()>>(
-                        []() -> RType { return RType(); });
-                (*tempTask)();
-                return tempTask->get_future();
+                return;
             }
+            scaleUpWait_ = wait;
+        }
 
-            // 将任务放入任务队列，并更新当前任务数量
-            taskQue_.emplace([task]() { (*task)(); });
-            currentTaskSize_++;
-
-            // 通知所有等待的线程，任务队列中有新任务可以处理
-            taskQueNotEmpty_.notify_all();
-
-            // 在CACHED模式下，如果任务数量超过空闲线程数量且当前线程数量未达到上限，则创建新线程
-            if (poolMode_ == PoolMode::MODE_CACHED && currentTaskSize_ > idleThreadSize_ &&
-                currentThreadSize_ < threadMaxSize_)
+        /**
+         * @brief 设置 CACHED 模式的线程创建速率上限（令牌桶）
+         * @param perSecond 每秒最多创建的线程数
+         * @param burst 可连续创建的线程数
+         */
+        void setThreadSpawnRate(size_t perSecond, size_t burst)
+        {
+            // 如果线程池已经启动，则不予设置
+            if (checkRunningState())
             {
-                try
-                {
-                    // 创建新的线程对象，并启动线程
-                    auto ptr = std::make_unique<Thread>([this](auto &&PH1) {
-                        this->threadFunc(std::forward<decltype(PH1)>(PH1));
-                    });
-                    size_t threadId = ptr->getThreadId();
-                    threads_.emplace(threadId, std::move(ptr));
-                    threads_[threadId]->start();
-                    // 更新线程相关成员变量
-                    currentThreadSize_++;
-                    idleThreadSize_++;
-                } catch (const std::system_error &e)
-                {
-                    // 可以根据实际情况进行其他处理，比如记录日志、返回错误信息等
-                    std::cerr << "Failed to create a new thread: " << e.what() << std::endl;
-                }
+                return;
             }
-
-            // 返回任务的std::future对象，表示任务提交成功
-            return result;
+            spawnRate_ = std::max<size_t>(perSecond, 1);
+            spawnBurst_ = std::max<size_t>(burst, 1);
         }
 
         /**
-         * @brief 启动线程池
-         * @param initThreadSize 初始线程数量，默认为系统支持的并发线程数
+         * @brief 设置 CACHED 模式下保留的备用空闲线程数
+         * @param size 备用线程数，默认为 0
          */
-        void start(size_t initThreadSize = std::thread::hardware_concurrency())
+        void setSpareThreads(size_t size)
         {
-            // 若线程池已启动，直接返回
-            if (poolIsRunning_)
+            // 如果线程池已经启动，则不予设置
+            if (checkRunningState())
             {
                 return;
             }
+            spareThreads_ = size;
+        }
 
-            // 设置线程池的运行状态为 true，表示线程池已启动
-            poolIsRunning_ = true;
-
-            // 初始化线程数量，设置初始线程数和当前线程数
-            initThreadSize_ = initThreadSize;
-            currentThreadSize_ = initThreadSize;
+        /**
+         * @brief 获取 CACHED 模式伸缩控制器的统计信息
+         * @return 统计信息快照
+         */
+        [[nodiscard]] ScalingStats scalingStats()
+        {
+            std::unique_lock<std::mutex> lock(taskQueMtx_);
+            return ScalingStats{currentThreadSize_, idleThreadSize_, queueWaitEwmaUs_,
+                                currentDispatchRate(std::chrono::steady_clock::now()), threadsCreated_,
+                                threadsReaped_};
+        }
 
-            // 创建线程对象，每个线程对象绑定到线程池的线程函数
-            for (int i = 0; i < initThreadSize_; ++i)
+        /**
+         * @brief 设置任务队列已满时的拒绝策略
+         * @param policy 拒绝策略，默认为 BLOCK
+         * @param blockTimeout BLOCK 策略下的最长等待时间，默认为 1 秒
+         */
+        void setRejectPolicy(RejectPolicy policy,
+                             std::chrono::milliseconds blockTimeout = std::chrono::seconds(1))
+        {
+            // 如果线程池已经启动，则不予设置
+            if (checkRunningState())
             {
-                try
-                {
-                    // 使用 std::bind 将线程函数绑定到线程对象，并使用 std::make_unique 创建线程对象
-                    auto ptr = std::make_unique<Thread>([this](auto &&PH1) {
-                        threadFunc(std::forward<decltype(PH1)>(PH1));
-                    });
-
-                    // 将线程对象移动到线程池的线程容器中，使用线程 ID 作为键
-                    this->threads_.emplace(ptr->getThreadId(), std::move(ptr));
-                } catch (const std::system_error &e)
-                {
-                    // 可以根据实际情况进行其他处理，比如减少初始线程数量、记录日志等
-                    std::cerr << "Failed to create a new thread during startup: " << e.what() << std::endl;
-                }
+                return;
             }
+            rejectPolicy_ = policy;
+            blockTimeout_ = blockTimeout;
+        }
 
-            // 启动所有线程，并记录初始空闲线程数量
-            for (int i = 0; i < initThreadSize_; ++i)
+        /**
+         * @brief 设置低优先级任务的饥饿阈值
+         * @param threshold 队首任务等待超过该时间后，优先于更高优先级的任务执行
+         */
+        void setStarvationThreshold(std::chrono::milliseconds threshold)
+        {
+            // 如果线程池已经启动，则不予设置
+            if (checkRunningState())
             {
-                threads_[i]->start();// 启动线程，使其开始执行线程函数
-                idleThreadSize_++;   // 增加空闲线程计数
+                return;
             }
+            starvationThreshold_ = threshold;
         }
 
-    private:
         /**
-         * @brief 线程函数，用于从任务队列中取出任务并执行
-         * @param threadId 线程ID
+         * @brief 获取某个优先级队列的统计信息
+         * @param priority 优先级
+         * @return 统计信息快照
+         *
+         * @note 无锁队列模式（[setLockFreeQueue()]）下只有 depth 有效（且为估算值），其余字段恒为 0：
+         *       该模式不做饥饿提升（低优先级任务在高优先级持续积压时可能一直得不到执行），
+         *       也不统计各队列的入队/执行/丢弃数与排队等待时间；排队等待分布仍可从 [stats()] 获取
          */
-        void threadFunc(size_t threadId)
+        [[nodiscard]] LaneStats laneStats(TaskPriority priority)
         {
-            // 记录线程第一次执行任务的时间
-            auto lastTime = std::chrono::high_resolution_clock::now();
-
-            // 线程循环工作，不断从任务队列中取出任务并执行
-            while (true)
+            if (useLockFreeQueue_)
             {
-                // 用于临时存储从任务队列中取出的任务
-                Task task;
-                {
-                    // 获取锁以访问任务队列
-                    std::unique_lock<std::mutex> lock(taskQueMtx_);
-
-                    // 如果任务队列为空，线程进入等待状态
-                    while (taskQue_.empty())
-                    {
-                        // 如果没有任务了，则判断线程池是否需要销毁：
-                        // 否 -> 继续阻塞
-                        // 是 -> 回收当前线程
-                        if (!poolIsRunning_)
-                        {
-                            // 当线程池停止运行时，回收正在执行任务的线程
-                            threads_.erase(threadId);
-                            // 每回收一个线程唤醒一次主线程，让其重新判断线程是否全部退出完毕：
-                            // 是 -> 停止阻塞，线程池销毁完毕
-                            // 否 -> 继续阻塞，等待所有线程回收
-                            exitCond_.notify_all();
-                            return;// 结束线程函数，即结束当前线程
-                        }
-
-                        // 在CACHED模式下，等待任务队列非空并每隔1s检查线程空闲时间是否超过60s
-                        if (poolMode_ == PoolMode::MODE_CACHED)
-                        {
-                            // 等待任务队列非空，超时时间为1秒，如果超时则需要判断是否需要回收线程
-                            if (std::cv_status::timeout == taskQueNotEmpty_.wait_for(lock, std::chrono::seconds(1)))
-                            {
-                                auto now = std::chrono::high_resolution_clock::now();// 当前时间
-                                // 计算线程空闲时间
-                                auto dur = std::chrono::duration_cast<std::chrono::seconds>(now - lastTime);
-                                // 如果线程空闲时间超过60秒且当前线程数超过初始线程数，则回收该线程
-                                if (dur.count() >= threadMaxIdleTime && currentThreadSize_ > initThreadSize_)
-                                {
-                                    // 回收线程
-                                    threads_.erase(threadId);
-                                    // 更新线程池相关变量
-                                    currentThreadSize_--;
-                                    idleThreadSize_--;
-                                    return;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            // 在非CACHED模式下，等待任务队列非空
-                            taskQueNotEmpty_.wait(lock);
-                        }
-                    }
-
-                    // 从任务队列中取出任务
-                    task = taskQue_.front();
-                    taskQue_.pop();
-                    currentTaskSize_--;
-
-                    // 如果任务队列中还有任务，通知其他线程
-                    if (!taskQue_.empty())
-                    {
-                        taskQueNotEmpty_.notify_all();
-                    }
-
-                    // 通知生产者，可以继续往任务队列放任务
-                    taskQueNotFull_.notify_all();
-                }// 释放锁，允许其他线程访问任务队列
+                // 无锁队列模式下不维护共享计数器，避免生产者之间争用同一缓存行
+                return LaneStats{lockFreeLanes_[static_cast<size_t>(priority)]->size(), 0, 0, 0, 0, 0, 0};
+            }
+            std::unique_lock<std::mutex> lock(taskQueMtx_);
+            const Lane &lane = lanes_[static_cast<size_t>(priority)];
+            return LaneStats{lane.queue.size(), lane.submitted, lane.executed, lane.discarded, lane.promoted,
+                             lane.totalWaitUs, lane.maxWaitUs};
+        }
 
-                // 执行任务前，空闲线程数量减少
-                idleThreadSize_--;
+        /**
+         * @brief 汇总各工作线程的运行统计
+         * @return 统计快照
+         *
+         * 线程退出后其统计块保留（由新线程复用），累计值不会因 CACHED 模式回收线程而减少。
+         * 不持有 [taskQueMtx_]，也不修改线程池状态，可被多个线程并发调用
+         */
+        [[nodiscard]] PoolStats stats() const
+        {
+            PoolStats result{};
 
-                // 执行任务
-                if (task)//保守判断
+            // 统计块在线程池析构前不会释放，只需在锁内复制指针，遍历直方图时不持锁
+            std::vector<const WorkerStats *> blocks;
+            {
+                std::unique_lock<std::mutex> lock(statsMtx_);
+                blocks.reserve(workerStats_.size());
+                for (const auto &workerStats: workerStats_)
                 {
-                    task();
+                    blocks.push_back(workerStats.get());
                 }
-
-                // 任务完成，空闲线程数量增加
-                idleThreadSize_++;
-
-                // 更新线程执行完任务的时间
-                lastTime = std::chrono::high_resolution_clock::now();
             }
+            for (const WorkerStats *workerStats: blocks)
+            {
+                workerStats->queueWaitNs.snapshotInto(result.queueWaitNs);
+                workerStats->runTimeNs.snapshotInto(result.runTimeNs);
+                result.executed += workerStats->executed.load(std::memory_order_relaxed);
+                result.steals += workerStats->steals.load(std::memory_order_relaxed);
+            }
+            result.threads = currentThreadSize_;
+            result.idleThreads = idleThreadSize_;
+            result.queueDepth = queueDepth();
+            result.rejected = rejectedTasks_.load(std::memory_order_relaxed);
+            result.callerRuns = callerRunsTasks_.load(std::memory_order_relaxed);
+            result.discarded = discardedTasks_.load(std::memory_order_relaxed);
+            return result;
         }
 
         /**
-         * @brief 检查线程池是否正在运行
-         * @return 如果线程池正在运行，返回 true；否则返回 false
+         * @brief 获取被拒绝的任务数
          */
-        bool checkRunningState() const
+        [[nodiscard]] uint64_t rejectedTaskCount() const
         {
-            return poolIsRunning_;
+            return rejectedTasks_.load(std::memory_order_relaxed);
         }
 
-    private:
-        /*====================线程相关变量====================*/
-        std::unordered_map<size_t, std::unique_ptr<Thread>> threads_;//!< 线程列表
-        size_t initThreadSize_;                                      //!< 初始化线程数量
-        size_t threadMaxSize_;                                       //!< 线程上限数量
-        size_t threadMaxIdleTime;                                    //!< 线程最大空闲时间
-        std::atomic_uint idleThreadSize_;                            //!< 空闲线程数量
-        std::atomic_uint currentThreadSize_;                         //!< 当前线程数量
+        /**
+         * @brief 获取因队列已满而在提交线程中执行的任务数
+         */
+        [[nodiscard]] uint64_t callerRunsTaskCount() const
+        {
+            return callerRunsTasks_.load(std::memory_order_relaxed);
+        }
 
-        /*====================任务相关变量====================*/
-        using Task = std::function<void()>;
-        std::queue<Task> taskQue_;        //!< 任务队列
-        size_t taskQueMaxSize_;           //!< 任务队列最大大小
-        std::atomic_uint currentTaskSize_;//!< 当前任务数量
+        /**
+         * @brief 获取因 DISCARD_OLDEST 策略被丢弃的任务数
+         */
+        [[nodiscard]] uint64_t discardedTaskCount() const
+        {
+            return discardedTasks_.load(std::memory_order_relaxed);
+        }
 
-        /*====================线程通信相关变量====================*/
-        std::mutex taskQueMtx_;                  //!< 任务队列互斥锁
-        std::condition_variable taskQueNotFull_; //!< 任务队列非满条件变量
-        std::condition_variable taskQueNotEmpty_;//!< 任务队列非空条件变量
-        std::condition_variable exitCond_;       //!< 线程资源回收条件变量
+        /**
+         * @brief 提交任务到线程池
+         * @tparam Func 任务函数类型
+         * @tparam Args 任务函数参数类型
+         * @param func 任务函数
+         * @param args 任务函数参数
+         * @return std::future<decltype(func(args...))> 返回一个 std::future 对象，用于获取任务执行结果
+         *
+         * 任务函数和参数直接按值捕获进 [Task]（不经过 std::bind），
+         * future 的共享状态由 [SharedStateAllocator] 分配，小任务全程不访问全局堆
+         */
+        template<typename Func, typename... Args>
+        auto submitTask(Func &&func, Args &&...args) -> std::future<decltype(func(args...))>
+        {
+            auto [task, result] = packageTask(std::forward<Func>(func), std::forward<Args>(args)...);
+            enqueue(std::move(task), true);
+            // 任务被拒绝时 task 随之销毁，future 中保存 broken_promise 异常，调用 get() 时抛出
+            return std::move(result);
+        }
 
-        /*====================线程池属性相关变量====================*/
-        PoolMode poolMode_;             //!< 线程池工作模式
+        /**
+         * @brief 按指定优先级提交任务到线程池
+         * @param priority 任务优先级
+         * @param func 任务函数
+         * @param args 任务函数参数
+         * @return 任务的 future
+         */
+        template<typename Func, typename... Args>
+        auto submitTaskWithPriority(TaskPriority priority, Func &&func, Args &&...args)
+                -> std::future<decltype(func(args...))>
+        {
+            auto [task, result] = packageTask(std::forward<Func>(func), std::forward<Args>(args)...);
+            enqueue(std::move(task), true, priority);
+            return std::move(result);
+        }
+
+        /**
+         * @brief 非阻塞地提交任务
+         * @tparam Func 任务函数类型
+         * @tparam Args 任务函数参数类型
+         * @param func 任务函数
+         * @param args 任务函数参数
+         * @return 提交结果及任务的 future
+         *
+         * 队列已满时按拒绝策略处理，BLOCK 策略不等待而是直接拒绝，适合在 IO 线程中调用
+         */
+        template<typename Func, typename... Args>
+        auto trySubmit(Func &&func, Args &&...args) -> SubmitResult<decltype(func(args...))>
+        {
+            auto [task, result] = packageTask(std::forward<Func>(func), std::forward<Args>(args)...);
+            SubmitStatus status = enqueue(std::move(task), false);
+            return {status, std::move(result)};
+        }
+
+        /**
+         * @brief 按指定优先级非阻塞地提交任务
+         * @param priority 任务优先级
+         * @param func 任务函数
+         * @param args 任务函数参数
+         * @return 提交结果及任务的 future
+         */
+        template<typename Func, typename... Args>
+        auto trySubmitWithPriority(TaskPriority priority, Func &&func, Args &&...args)
+                -> SubmitResult<decltype(func(args...))>
+        {
+            auto [task, result] = packageTask(std::forward<Func>(func), std::forward<Args>(args)...);
+            SubmitStatus status = enqueue(std::move(task), false, priority);
+            return {status, std::move(result)};
+        }
+
+        /**
+         * @brief 提交不需要返回值的任务（fire-and-forget）
+         * @tparam Func 任务函数类型
+         * @tparam Args 任务函数参数类型
+         * @param func 任务函数
+         * @param args 任务函数参数
+         * @return 任务被接受（已入队或已由提交线程执行）返回 true；被拒绝返回 false
+         *
+         * 不创建 future，小任务不分配任何堆内存；任务抛出的异常会被捕获并打印
+         */
+        template<typename Func, typename... Args>
+        bool post(Func &&func, Args &&...args)
+        {
+            return SubmitStatus::REJECTED != enqueue(makePostTask(std::forward<Func>(func), std::forward<Args>(args)...),
+                                                     true);
+        }
+
+        /**
+         * @brief 协程切换到线程池中执行
+         * @param priority 任务优先级
+         *
+         * 使用方式：
+         * @code
+         * co_await pool.schedule();        // 以下代码在工作线程中执行
+         * auto resp = compute(req);
+         * co_await conn->getLoop()->schedule();// 回到连接所属的事件循环
+         * @endcode
+         *
+         * @note 队列已满时不挂起、也不等待，协程继续在当前线程执行：拒绝策略中的 BLOCK、CALLER_RUNS、
+         *       DISCARD_OLDEST 对恢复任务均按 ABORT 处理（在 await_suspend 中内联恢复会嵌套调用栈，
+         *       丢弃恢复任务会使协程永远挂起）
+         * @note 其他提交者在 DISCARD_OLDEST 策略下仍可能丢弃已排队的恢复任务，与 schedule() 共用的线程池不应使用该策略
+         * @note 线程池析构时会先执行完已排队的任务；但从未 [start()] 的线程池析构时，已排队的恢复任务被直接丢弃，
+         *       对应协程既不会恢复也不会销毁
+         */
+        auto schedule(TaskPriority priority = TaskPriority::NORMAL)
+        {
+            struct Awaiter
+            {
+                ThreadPool *pool;
+                TaskPriority priority;
+
+                bool await_ready() const noexcept { return false; }
+
+                bool await_suspend(std::coroutine_handle<> handle)
+                {
+                    // 被拒绝时返回 false，协程不挂起而在当前线程继续执行
+                    return pool->tryPostWithPriority(priority, [handle]() { handle.resume(); });
+                }
+
+                void await_resume() const noexcept {}
+            };
+            return Awaiter{this, priority};
+        }
+
+        /**
+         * @brief 按指定优先级提交不需要返回值的任务
+         * @param priority 任务优先级
+         * @param func 任务函数
+         * @param args 任务函数参数
+         * @return 任务被接受返回 true；被拒绝返回 false
+         */
+        template<typename Func, typename... Args>
+        bool postWithPriority(TaskPriority priority, Func &&func, Args &&...args)
+        {
+            return SubmitStatus::REJECTED != enqueue(makePostTask(std::forward<Func>(func), std::forward<Args>(args)...),
+                                                     true, priority);
+        }
+
+        /**
+         * @brief 非阻塞地提交不需要返回值的任务，且不使用任何回退行为
+         * @param func 任务函数
+         * @param args 任务函数参数
+         * @return 任务已入队返回 true；队列已满或线程池已停止返回 false
+         *
+         * 与 [post()] 不同，队列已满时 BLOCK、CALLER_RUNS、DISCARD_OLDEST 均按 ABORT 处理：
+         * 不等待、不在提交线程执行、也不丢弃已排队的任务。适用于事件循环线程等不能阻塞、也不能执行耗时任务的提交者
+         */
+        template<typename Func, typename... Args>
+        bool tryPost(Func &&func, Args &&...args)
+        {
+            return tryPostWithPriority(TaskPriority::NORMAL, std::forward<Func>(func), std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief 按指定优先级执行 [tryPost()]
+         * @param priority 任务优先级
+         * @param func 任务函数
+         * @param args 任务函数参数
+         * @return 任务已入队返回 true；被拒绝返回 false
+         */
+        template<typename Func, typename... Args>
+        bool tryPostWithPriority(TaskPriority priority, Func &&func, Args &&...args)
+        {
+            return SubmitStatus::REJECTED != enqueue(makePostTask(std::forward<Func>(func), std::forward<Args>(args)...),
+                                                     false, priority, false);
+        }
+
+        /**
+         * @brief 批量提交任务，一次加锁入队并按任务数唤醒工作线程
+         * @tparam Range 可调用对象的容器（元素以无参方式调用）
+         * @param funcs 任务列表
+         * @param priority 任务优先级
+         * @return 每个任务的 future，顺序与 funcs 相同（被拒绝的任务 future 中保存 broken_promise 异常）
+         */
+        template<typename Range>
+        auto submitBulk(Range &&funcs, TaskPriority priority = TaskPriority::NORMAL)
+        {
+            using Func = std::decay_t<decltype(*std::begin(funcs))>;
+            using RType = std::invoke_result_t<Func &>;
+
+            std::vector<Task> tasks;
+            std::vector<std::future<RType>> results;
+            tasks.reserve(std::size(funcs));
+            results.reserve(std::size(funcs));
+            for (auto &&func: funcs)
+            {
+                auto [task, result] = packageTask(std::forward<decltype(func)>(func));
+                tasks.push_back(std::move(task));
+                results.push_back(std::move(result));
+            }
+            enqueueBulk(tasks, priority);
+            return results;
+        }
+
+        /**
+         * @brief 批量提交不需要返回值的任务
+         * @tparam Range 可调用对象的容器（元素以无参方式调用）
+         * @param funcs 任务列表
+         * @param priority 任务优先级
+         * @return 被接受的任务数
+         */
+        template<typename Range>
+        size_t postBulk(Range &&funcs, TaskPriority priority = TaskPriority::NORMAL)
+        {
+            std::vector<Task> tasks;
+            tasks.reserve(std::size(funcs));
+            for (auto &&func: funcs)
+            {
+                tasks.push_back(makePostTask(std::forward<decltype(func)>(func)));
+            }
+            return enqueueBulk(tasks, priority);
+        }
+
+        /**
+         * @brief 获取当前线程数量
+         * @return 当前线程数量
+         */
+        [[nodiscard]] size_t threadSize() const
+        {
+            return currentThreadSize_;
+        }
+
+        /**
+         * @brief 启动线程池
+         * @param initThreadSize 初始线程数量，默认为系统支持的并发线程数
+         */
+        void start(size_t initThreadSize = std::thread::hardware_concurrency())
+        {
+            // 若线程池已启动，直接返回
+            if (poolIsRunning_)
+            {
+                return;
+            }
+
+            // 设置线程池的运行状态为 true，表示线程池已启动
+            poolIsRunning_ = true;
+
+            // 初始化线程数量，设置初始线程数和当前线程数
+            initThreadSize_ = initThreadSize;
+            currentThreadSize_ = initThreadSize;
+
+            // 无锁队列模式：创建各优先级的无锁队列，启动前已提交的任务一并转入
+            if (lockFreeQueue_ && poolMode_ == PoolMode::MODE_FIXED)
+            {
+                std::unique_lock<std::mutex> lock(taskQueMtx_);
+                for (size_t i = 0; i < TASK_PRIORITY_COUNT; ++i)
+                {
+                    lockFreeLanes_[i] = std::make_unique<MpmcQueue<QueuedTask>>(taskQueMaxSize_);
+                    while (!lanes_[i].queue.empty())
+                    {
+                        lockFreeLanes_[i]->tryPush(lanes_[i].queue.front());
+                        lanes_[i].queue.pop();
+                    }
+                }
+                currentTaskSize_ = 0;
+                highLaneDepth_ = 0;
+                useLockFreeQueue_ = true;
+            }
+
+            // 工作窃取模式：先创建全部本地队列，线程启动后即可相互窃取
+            if (poolMode_ == PoolMode::MODE_WORK_STEALING)
+            {
+                for (size_t i = 0; i < initThreadSize_; ++i)
+                {
+                    workers_.push_back(std::make_unique<Worker>(this));
+                }
+            }
+
+            // 创建线程对象，每个线程对象绑定到线程池的线程函数
+            for (size_t i = 0; i < initThreadSize_; ++i)
+            {
+                try
+                {
+                    // 使用 std::bind 将线程函数绑定到线程对象，并使用 std::make_unique 创建线程对象
+                    std::unique_ptr<Thread> ptr;
+                    if (poolMode_ == PoolMode::MODE_WORK_STEALING)
+                    {
+                        ptr = std::make_unique<Thread>([this, i](size_t threadId) {
+                            workStealingThreadFunc(threadId, workers_[i].get());
+                        });
+                    }
+                    else if (useLockFreeQueue_)
+                    {
+                        ptr = std::make_unique<Thread>([this](size_t threadId) {
+                            lockFreeThreadFunc(threadId);
+                        });
+                    }
+                    else
+                    {
+                        ptr = std::make_unique<Thread>([this](auto &&PH1) {
+                            threadFunc(std::forward<decltype(PH1)>(PH1));
+                        });
+                    }
+
+                    // 将线程对象移动到线程池的线程容器中，使用线程 ID 作为键
+                    this->threads_.emplace(ptr->getThreadId(), std::move(ptr));
+                } catch (const std::system_error &e)
+                {
+                    // 可以根据实际情况进行其他处理，比如减少初始线程数量、记录日志等
+                    std::cerr << "Failed to create a new thread during startup: " << e.what() << std::endl;
+                }
+            }
+
+            // 启动所有线程，并记录初始空闲线程数量
+            // 线程 ID 由全局计数器生成，不一定从 0 开始，需遍历容器而非按下标访问
+            // 持锁启动，避免线程退出时并发修改 threads_
+            std::unique_lock<std::mutex> lock(taskQueMtx_);
+            spawnTokens_ = static_cast<double>(spawnBurst_);
+            lastRefill_ = dispatchWindowStart_ = std::chrono::steady_clock::now();
+            currentThreadSize_ = threads_.size();
+            for (auto &[threadId, thread]: threads_)
+            {
+                thread->start();  // 启动线程，使其开始执行线程函数
+                idleThreadSize_++;// 增加空闲线程计数
+            }
+        }
+
+    private:
+        /**
+         * @struct QueuedTask
+         * @brief 队列中的任务及其入队时间
+         */
+        struct QueuedTask
+        {
+            QueuedTask() = default;
+            QueuedTask(Task &&t, std::chrono::steady_clock::time_point time)
+                : task(std::move(t)),
+                  enqueueTime(time)
+            {}
+
+            Task task;                                      //!< 任务
+            std::chrono::steady_clock::time_point enqueueTime;//!< 入队时间
+        };
+
+        /**
+         * @struct WorkerStats
+         * @brief 单个工作线程的运行统计（只由持有它的线程写入，[stats()] 随时读取）
+         */
+        struct alignas(64) WorkerStats
+        {
+            /**
+             * @brief 记录任务的排队等待时间
+             */
+            void recordWait(std::chrono::steady_clock::time_point enqueueTime,
+                            std::chrono::steady_clock::time_point now)
+            {
+                queueWaitNs.record(elapsedNs(enqueueTime, now));
+            }
+
+            /**
+             * @brief 记录任务的执行时间
+             */
+            void recordRun(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+            {
+                runTimeNs.record(elapsedNs(begin, end));
+                executed.store(executed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief 记录一次成功的窃取
+             */
+            void recordSteal()
+            {
+                steals.store(steals.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+
+            static uint64_t elapsedNs(std::chrono::steady_clock::time_point from,
+                                      std::chrono::steady_clock::time_point to)
+            {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+                return ns > 0 ? static_cast<uint64_t>(ns) : 0;
+            }
+
+            Histogram queueWaitNs;           //!< 排队等待时间（纳秒）
+            Histogram runTimeNs;             //!< 执行时间（纳秒）
+            std::atomic<uint64_t> executed{0};//!< 执行的任务数
+            std::atomic<uint64_t> steals{0};  //!< 窃取成功的次数
+        };
+
+        /**
+         * @struct Worker
+         * @brief 工作窃取线程的本地队列
+         */
+        struct Worker
+        {
+            explicit Worker(ThreadPool *owner)
+                : pool(owner)
+            {}
+
+            ~Worker()
+            {
+                for (QueuedTask *node: freeNodes)
+                {
+                    delete node;
+                }
+            }
+
+            /**
+             * @brief 从本线程的节点缓存取出一个节点存放任务（仅所属线程调用）
+             */
+            QueuedTask *makeNode(Task &&task, std::chrono::steady_clock::time_point now)
+            {
+                if (freeNodes.empty())
+                {
+                    return new QueuedTask(std::move(task), now);
+                }
+                QueuedTask *node = freeNodes.back();
+                freeNodes.pop_back();
+                node->task = std::move(task);
+                node->enqueueTime = now;
+                return node;
+            }
+
+            /**
+             * @brief 取出节点中的任务，节点归还本线程的缓存（仅所属线程调用）
+             *
+             * 被窃取的节点归还给窃取者，各线程缓存只由自己访问，无需同步
+             */
+            QueuedTask takeNode(QueuedTask *node)
+            {
+                QueuedTask task = std::move(*node);
+                if (freeNodes.size() < kMaxFreeNodes)
+                {
+                    freeNodes.push_back(node);
+                }
+                else
+                {
+                    delete node;
+                }
+                return task;
+            }
+
+            static constexpr size_t kMaxFreeNodes = 1024;//!< 节点缓存上限
+
+            ThreadPool *pool;                //!< 所属线程池
+            WorkStealingDeque<QueuedTask *> deque;//!< 本地任务队列
+            std::vector<QueuedTask *> freeNodes;  //!< 空闲任务节点缓存
+        };
+
+        /**
+         * @struct Lane
+         * @brief 单个优先级的任务队列及其统计信息（均由 [taskQueMtx_] 保护）
+         */
+        struct Lane
+        {
+            RingQueue<QueuedTask> queue;     //!< 任务队列
+            std::condition_variable notFull; //!< 队列非满条件变量
+            uint64_t submitted = 0;          //!< 累计入队任务数
+            uint64_t executed = 0;           //!< 累计出队任务数
+            uint64_t discarded = 0;          //!< 累计被丢弃的任务数
+            uint64_t promoted = 0;           //!< 因饥饿保护被提前执行的次数
+            uint64_t totalWaitUs = 0;        //!< 累计排队等待时间（微秒）
+            uint64_t maxWaitUs = 0;          //!< 最长排队等待时间（微秒）
+        };
+
+        /**
+         * @brief 将函数及参数打包为任务，结果通过 future 返回
+         * @return 任务及其 future
+         *
+         * 任务函数和参数直接按值捕获进 [Task]（不经过 std::bind），
+         * future 的共享状态由 [SharedStateAllocator] 分配
+         */
+        template<typename Func, typename... Args>
+        static auto packageTask(Func &&func, Args &&...args)
+        {
+            using RType = std::invoke_result_t<std::decay_t<Func> &, std::decay_t<Args> &...>;
+            std::promise<RType> promise(std::allocator_arg, SharedStateAllocator<RType>());
+            std::future<RType> result = promise.get_future();
+
+            Task task([promise = std::move(promise),
+                       func = std::forward<Func>(func),
+                       ... args = std::forward<Args>(args)]() mutable {
+                try
+                {
+                    if constexpr (std::is_void_v<RType>)
+                    {
+                        std::invoke(func, args...);
+                        promise.set_value();
+                    }
+                    else
+                    {
+                        promise.set_value(std::invoke(func, args...));
+                    }
+                } catch (...)
+                {
+                    promise.set_exception(std::current_exception());
+                }
+            });
+            return std::make_pair(std::move(task), std::move(result));
+        }
+
+        /**
+         * @brief 将函数及参数打包为不需要返回值的任务，任务抛出的异常会被捕获并打印
+         * @return 任务
+         */
+        template<typename Func, typename... Args>
+        static Task makePostTask(Func &&func, Args &&...args)
+        {
+            return Task([func = std::forward<Func>(func), ... args = std::forward<Args>(args)]() mutable {
+                try
+                {
+                    std::invoke(func, args...);
+                } catch (const std::exception &e)
+                {
+                    std::cerr << "thread pool task threw: " << e.what() << std::endl;
+                } catch (...)
+                {
+                    std::cerr << "thread pool task threw an unknown exception" << std::endl;
+                }
+            });
+        }
+
+        /**
+         * @brief 将任务放入队列，队列已满时按 [rejectPolicy_] 处理
+         * @param task 任务（被拒绝时销毁）
+         * @param mayBlock BLOCK 策略下是否允许等待
+         * @param priority 任务优先级
+         * @param allowFallback 是否允许 CALLER_RUNS / DISCARD_OLDEST 处理；为 false 时这两种策略按 ABORT 处理
+         * @return 提交结果
+         */
+        SubmitStatus enqueue(Task task, bool mayBlock, TaskPriority priority = TaskPriority::NORMAL,
+                             bool allowFallback = true)
+        {
+            // 工作窃取模式下，本池工作线程提交的普通优先级任务直接压入自己的本地队列
+            if (priority == TaskPriority::NORMAL && poolMode_ == PoolMode::MODE_WORK_STEALING && currentWorker_ &&
+                currentWorker_->pool == this)
+            {
+                currentWorker_->deque.push(currentWorker_->makeNode(std::move(task), std::chrono::steady_clock::now()));
+                notifyTaskAdded();
+                return SubmitStatus::OK;
+            }
+
+            if (useLockFreeQueue_)
+            {
+                return enqueueLockFree(std::move(task), mayBlock, priority, allowFallback);
+            }
+
+            Task discarded;// 被丢弃的任务在释放锁之后再销毁
+
+            // 获取锁，确保对任务队列的访问是线程安全的
+            std::unique_lock<std::mutex> lock(taskQueMtx_);
+
+            Lane &lane = lanes_[static_cast<size_t>(priority)];
+            if (lane.queue.size() >= taskQueMaxSize_)
+            {
+                switch (effectivePolicy(allowFallback))
+                {
+                    case RejectPolicy::BLOCK:
+                        // 等待任务队列有空余位置，超时后拒绝
+                        if (mayBlock && lane.notFull.wait_for(lock, blockTimeout_, [this, &lane]() {
+                                return lane.queue.size() < taskQueMaxSize_;
+                            }))
+                        {
+                            break;
+                        }
+                        [[fallthrough]];
+                    case RejectPolicy::ABORT:
+                        rejectedTasks_.fetch_add(1, std::memory_order_relaxed);
+                        return SubmitStatus::REJECTED;
+                    case RejectPolicy::CALLER_RUNS:
+                        lock.unlock();
+                        callerRunsTasks_.fetch_add(1, std::memory_order_relaxed);
+                        task();
+                        return SubmitStatus::CALLER_RUNS;
+                    case RejectPolicy::DISCARD_OLDEST:
+                        discarded = discardFrontLocked(lane);
+                        break;
+                }
+            }
+
+            // 将任务放入任务队列，并更新当前任务数量
+            pushTaskLocked(std::move(task), lane, std::chrono::steady_clock::now());
+
+            if (poolMode_ == PoolMode::MODE_WORK_STEALING)
+            {
+                lock.unlock();
+                notifyTaskAdded();
+                return SubmitStatus::OK;
+            }
+
+            // 新增一个任务只需唤醒一个等待线程
+            wakeIdleThreadLocked();
+
+            addThreadIfNeeded();
+            return SubmitStatus::OK;
+        }
+
+        /**
+         * @brief 批量将任务放入队列：一次加锁放入所有放得下的任务，并按任务数唤醒工作线程
+         * @param tasks 任务列表（被接受的任务会被移走）
+         * @param priority 任务优先级
+         * @return 被接受（已入队或已由提交线程执行）的任务数
+         *
+         * 队列放不下的剩余任务逐个按拒绝策略处理
+         */
+        size_t enqueueBulk(std::vector<Task> &tasks, TaskPriority priority)
+        {
+            size_t n = tasks.size();
+            if (n == 0)
+            {
+                return 0;
+            }
+
+            // 工作窃取模式下，本池工作线程提交的任务全部压入自己的本地队列，其他线程会来窃取
+            if (priority == TaskPriority::NORMAL && poolMode_ == PoolMode::MODE_WORK_STEALING && currentWorker_ &&
+                currentWorker_->pool == this)
+            {
+                auto now = std::chrono::steady_clock::now();
+                for (Task &task: tasks)
+                {
+                    currentWorker_->deque.push(currentWorker_->makeNode(std::move(task), now));
+                }
+                notifyTasksAdded(n);
+                return n;
+            }
+
+            // 无锁队列没有可分摊的锁开销，逐个入队即可
+            if (useLockFreeQueue_)
+            {
+                size_t accepted = 0;
+                for (Task &task: tasks)
+                {
+                    if (enqueueLockFree(std::move(task), true, priority) != SubmitStatus::REJECTED)
+                    {
+                        ++accepted;
+                    }
+                }
+                return accepted;
+            }
+
+            size_t queued = 0;
+            {
+                std::unique_lock<std::mutex> lock(taskQueMtx_);
+                Lane &lane = lanes_[static_cast<size_t>(priority)];
+                auto now = std::chrono::steady_clock::now();
+                while (queued < n && lane.queue.size() < taskQueMaxSize_)
+                {
+                    pushTaskLocked(std::move(tasks[queued++]), lane, now);
+                }
+
+                if (poolMode_ != PoolMode::MODE_WORK_STEALING)
+                {
+                    // 新增任务数不少于线程数时直接全部唤醒，否则逐个唤醒
+                    if (poolMode_ == PoolMode::MODE_CACHED)
+                    {
+                        for (size_t i = 0; i < queued && !idleWaiters_.empty(); ++i)
+                        {
+                            wakeIdleThreadLocked();
+                        }
+                    }
+                    else if (queued >= currentThreadSize_)
+                    {
+                        taskQueNotEmpty_.notify_all();
+                    }
+                    else
+                    {
+                        for (size_t i = 0; i < queued; ++i)
+                        {
+                            taskQueNotEmpty_.notify_one();
+                        }
+                    }
+                    for (size_t i = 0; i < queued; ++i)
+                    {
+                        addThreadIfNeeded();
+                    }
+                }
+            }
+            if (poolMode_ == PoolMode::MODE_WORK_STEALING)
+            {
+                notifyTasksAdded(queued);
+            }
+
+            size_t accepted = queued;
+            for (size_t i = queued; i < n; ++i)
+            {
+                if (enqueue(std::move(tasks[i]), true, priority) != SubmitStatus::REJECTED)
+                {
+                    ++accepted;
+                }
+            }
+            return accepted;
+        }
+
+        /**
+         * @brief 拒绝策略按调用方要求降级：不允许回退时 CALLER_RUNS / DISCARD_OLDEST 按 ABORT 处理
+         */
+        [[nodiscard]] RejectPolicy effectivePolicy(bool allowFallback) const
+        {
+            if (!allowFallback &&
+                (rejectPolicy_ == RejectPolicy::CALLER_RUNS || rejectPolicy_ == RejectPolicy::DISCARD_OLDEST))
+            {
+                return RejectPolicy::ABORT;
+            }
+            return rejectPolicy_;
+        }
+
+        /**
+         * @brief 将任务放入无锁队列，队列已满时按 [rejectPolicy_] 处理
+         * @param task 任务（被拒绝时销毁）
+         * @param mayBlock BLOCK 策略下是否允许等待
+         * @param priority 任务优先级
+         * @param allowFallback 是否允许 CALLER_RUNS / DISCARD_OLDEST 处理
+         * @return 提交结果
+         */
+        SubmitStatus enqueueLockFree(Task &&task, bool mayBlock, TaskPriority priority, bool allowFallback = true)
+        {
+            MpmcQueue<QueuedTask> &queue = *lockFreeLanes_[static_cast<size_t>(priority)];
+            QueuedTask item(std::move(task), std::chrono::steady_clock::now());
+            if (!queue.tryPush(item))
+            {
+                switch (effectivePolicy(allowFallback))
+                {
+                    case RejectPolicy::BLOCK:
+                        // 等待任务队列有空余位置，超时后拒绝
+                        if (mayBlock && pushUntilTimeout(queue, notFullEvents_[static_cast<size_t>(priority)], item))
+                        {
+                            break;
+                        }
+                        [[fallthrough]];
+                    case RejectPolicy::ABORT:
+                        rejectedTasks_.fetch_add(1, std::memory_order_relaxed);
+                        return SubmitStatus::REJECTED;
+                    case RejectPolicy::CALLER_RUNS:
+                        callerRunsTasks_.fetch_add(1, std::memory_order_relaxed);
+                        item.task();
+                        return SubmitStatus::CALLER_RUNS;
+                    case RejectPolicy::DISCARD_OLDEST:
+                        // 其他生产者可能抢先占用腾出的位置，循环直到放入
+                        do
+                        {
+                            QueuedTask discarded;
+                            if (queue.tryPop(discarded))
+                            {
+                                discardedTasks_.fetch_add(1, std::memory_order_relaxed);
+                            }
+                        } while (!queue.tryPush(item));
+                        break;
+                }
+            }
+
+            // 已有线程在自旋找任务时无需唤醒；否则只有存在休眠线程时才进入内核唤醒
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (spinningWorkers_.load(std::memory_order_seq_cst) == 0)
+            {
+                notEmptyEvent_.notifyOne();
+            }
+            return SubmitStatus::OK;
+        }
+
+        /**
+         * @brief 在 [blockTimeout_] 内反复尝试将任务放入已满的无锁队列
+         * @param queue 无锁队列
+         * @param notFull 该队列的非满事件
+         * @param task 任务（仅在成功时被移走）
+         * @return 放入成功返回 true，超时返回 false
+         */
+        bool pushUntilTimeout(MpmcQueue<QueuedTask> &queue, EventCount &notFull, QueuedTask &task)
+        {
+            auto deadline = std::chrono::steady_clock::now() + blockTimeout_;
+            while (true)
+            {
+                EventCount::Key key = notFull.prepareWait();
+                if (queue.tryPush(task))
+                {
+                    notFull.cancelWait();
+                    return true;
+                }
+                if (!notFull.waitUntil(key, deadline))
+                {
+                    return queue.tryPush(task);
+                }
+            }
+        }
+
+        /**
+         * @brief 按优先级从无锁队列中取出一个任务
+         * @return 取到任务返回 true
+         */
+        bool popLockFree(QueuedTask &task)
+        {
+            for (size_t i = 0; i < TASK_PRIORITY_COUNT; ++i)
+            {
+                if (lockFreeLanes_[i]->tryPop(task))
+                {
+                    // 只有生产者在等待空位时才进入内核唤醒
+                    notFullEvents_[i].notifyOne();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief 无锁队列模式下获取一个任务：先自旋，再让出几次 CPU，最后在 [notEmptyEvent_] 上休眠
+         * @return 取到任务返回 true；线程池已停止且队列为空时返回 false
+         *
+         * 自旋期间登记在 [spinningWorkers_] 中，生产者看到有线程正在找任务时不再唤醒休眠线程；
+         * 最后一个自旋线程取到任务后，若队列仍有积压则接力唤醒一个休眠线程
+         */
+        bool waitLockFreeTask(QueuedTask &task)
+        {
+            while (true)
+            {
+                spinningWorkers_.fetch_add(1, std::memory_order_seq_cst);
+                if (spinForTask(task))
+                {
+                    if (spinningWorkers_.fetch_sub(1, std::memory_order_seq_cst) == 1 && !lockFreeQueuesEmpty())
+                    {
+                        notEmptyEvent_.notifyOne();
+                    }
+                    return true;
+                }
+
+                // 先登记为等待者、再退出自旋状态，最后复查队列与运行状态，
+                // 与生产者的 notifyOne / 析构函数中的 notifyAll 不会错过
+                EventCount::Key key = notEmptyEvent_.prepareWait();
+                spinningWorkers_.fetch_sub(1, std::memory_order_seq_cst);
+                if (popLockFree(task))
+                {
+                    notEmptyEvent_.cancelWait();
+                    return true;
+                }
+                if (!poolIsRunning_)
+                {
+                    notEmptyEvent_.cancelWait();
+                    return false;
+                }
+                notEmptyEvent_.wait(key);
+            }
+        }
+
+        /**
+         * @brief 短暂自旋并让出几次 CPU 尝试取任务
+         * @return 取到任务返回 true
+         */
+        bool spinForTask(QueuedTask &task)
+        {
+            // 单核机器上自旋和让出 CPU 只会推迟生产者运行（且各工作线程相互让出），直接休眠
+            static const bool multiCore = std::thread::hardware_concurrency() > 1;
+            if (!multiCore)
+            {
+                return popLockFree(task);
+            }
+            for (int i = 0; i < kSpinCount; ++i)
+            {
+                if (popLockFree(task))
+                {
+                    return true;
+                }
+                cpuRelax();
+            }
+            for (int i = 0; i < kYieldCount; ++i)
+            {
+                std::this_thread::yield();
+                if (popLockFree(task))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief 各优先级无锁队列是否都为空（并发下仅供参考）
+         */
+        bool lockFreeQueuesEmpty() const
+        {
+            for (const auto &queue: lockFreeLanes_)
+            {
+                if (!queue->empty())
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief 自旋等待时让出流水线资源
+         */
+        static void cpuRelax()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+
+        /**
+         * @brief 将任务放入指定优先级队列（调用方需持有 [taskQueMtx_]）
+         * @param task 任务
+         * @param lane 优先级队列
+         * @param now 入队时间
+         */
+        void pushTaskLocked(Task &&task, Lane &lane, std::chrono::steady_clock::time_point now)
+        {
+            lane.queue.emplace(std::move(task), now);
+            lane.submitted++;
+            currentTaskSize_++;
+            if (&lane == &lanes_[static_cast<size_t>(TaskPriority::HIGH)])
+            {
+                highLaneDepth_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief 按优先级取出一个任务，并记录排队延迟（调用方需持有 [taskQueMtx_]，且队列非空）
+         * @return 任务及其入队时间
+         *
+         * 默认取最高优先级的非空队列；较低优先级队列的队首任务等待超过 [starvationThreshold_]
+         * 且比当前选中的任务更早入队时，改为取该任务
+         */
+        QueuedTask popTaskLocked()
+        {
+            auto now = std::chrono::steady_clock::now();
+            Lane *chosen = nullptr;
+            bool promoted = false;
+            for (Lane &lane: lanes_)
+            {
+                if (lane.queue.empty())
+                {
+                    continue;
+                }
+                if (chosen == nullptr)
+                {
+                    chosen = &lane;
+                }
+                else if (now - lane.queue.front().enqueueTime >= starvationThreshold_ &&
+                         lane.queue.front().enqueueTime < chosen->queue.front().enqueueTime)
+                {
+                    chosen = &lane;
+                    promoted = true;
+                }
+            }
+
+            auto waitUs = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(now - chosen->queue.front().enqueueTime)
+                            .count());
+            QueuedTask task = removeFrontLocked(*chosen);
+
+            chosen->executed++;
+            chosen->promoted += promoted ? 1 : 0;
+            chosen->totalWaitUs += waitUs;
+            chosen->maxWaitUs = std::max(chosen->maxWaitUs, waitUs);
+            recordDispatchLocked(now, waitUs);
+
+            // 通知一个该优先级的生产者，可以继续往任务队列放任务
+            chosen->notFull.notify_one();
+            return task;
+        }
+
+        /**
+         * @brief 移除队首任务并更新队列深度计数（调用方需持有 [taskQueMtx_]，且队列非空）
+         * @param lane 优先级队列
+         * @return 队首任务及其入队时间
+         *
+         * 出队与丢弃共用：[currentTaskSize_]、[highLaneDepth_] 在这里统一维护，
+         * 否则 HIGH 队列的计数残留会让工作窃取线程始终加锁检查共享队列
+         */
+        QueuedTask removeFrontLocked(Lane &lane)
+        {
+            QueuedTask task = std::move(lane.queue.front());
+            lane.queue.pop();
+            currentTaskSize_--;
+            if (&lane == &lanes_[static_cast<size_t>(TaskPriority::HIGH)])
+            {
+                highLaneDepth_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            return task;
+        }
+
+        /**
+         * @brief DISCARD_OLDEST：丢弃队首任务并记账（调用方需持有 [taskQueMtx_]，且队列非空）
+         * @param lane 优先级队列
+         * @return 被丢弃的任务（由调用方在释放锁之后销毁）
+         */
+        Task discardFrontLocked(Lane &lane)
+        {
+            QueuedTask task = removeFrontLocked(lane);
+            if (poolMode_ == PoolMode::MODE_WORK_STEALING)
+            {
+                pendingTasks_.fetch_sub(1, std::memory_order_seq_cst);
+            }
+            lane.discarded++;
+            discardedTasks_.fetch_add(1, std::memory_order_relaxed);
+            return std::move(task.task);
+        }
+
+        /**
+         * @brief 记录一次出队，更新排队等待时间的滑动平均与出队速率（调用方需持有 [taskQueMtx_]）
+         * @param now 当前时间
+         * @param waitUs 该任务的排队等待时间（微秒）
+         */
+        void recordDispatchLocked(std::chrono::steady_clock::time_point now, uint64_t waitUs)
+        {
+            queueWaitEwmaUs_ += (static_cast<double>(waitUs) - queueWaitEwmaUs_) * kWaitEwmaAlpha;
+
+            // 出队速率按固定窗口统计，窗口之间再做指数滑动平均
+            dispatchedInWindow_++;
+            double elapsed = std::chrono::duration<double>(now - dispatchWindowStart_).count();
+            if (elapsed >= kDispatchWindowSeconds)
+            {
+                double rate = static_cast<double>(dispatchedInWindow_) / elapsed;
+                dispatchRate_ = dispatchRate_ == 0 ? rate : dispatchRate_ + (rate - dispatchRate_) * 0.5;
+                dispatchedInWindow_ = 0;
+                dispatchWindowStart_ = now;
+            }
+        }
+
+        /**
+         * @brief 当前的出队速率（任务/秒）；长时间没有出队时按当前窗口的实际速率下调（调用方需持有 [taskQueMtx_]）
+         */
+        double currentDispatchRate(std::chrono::steady_clock::time_point now) const
+        {
+            double elapsed = std::chrono::duration<double>(now - dispatchWindowStart_).count();
+            if (elapsed >= 2 * kDispatchWindowSeconds)
+            {
+                return std::min(dispatchRate_, static_cast<double>(dispatchedInWindow_) / elapsed);
+            }
+            return dispatchRate_;
+        }
+
+        /**
+         * @brief 估计当前的排队等待时间（微秒）：实测滑动平均与按出队速率预测的积压等待时间中的较大者
+         *
+         * 工作线程都被长任务占用时没有出队，实测值不再更新，预测值仍能反映积压
+         */
+        double queueWaitSignalUs(std::chrono::steady_clock::time_point now) const
+        {
+            double backlog = currentTaskSize_;
+            double rate = currentDispatchRate(now);
+            double predicted = backlog == 0 ? 0
+                               : rate > 0   ? backlog * 1e6 / rate
+                                            : std::numeric_limits<double>::infinity();
+            return std::max(queueWaitEwmaUs_, predicted);
+        }
+
+        /**
+         * @brief 从令牌桶中取一个线程创建令牌
+         * @return 取到令牌返回 true
+         */
+        bool takeSpawnToken(std::chrono::steady_clock::time_point now)
+        {
+            double elapsed = std::chrono::duration<double>(now - lastRefill_).count();
+            spawnTokens_ = std::min(static_cast<double>(spawnBurst_),
+                                    spawnTokens_ + elapsed * static_cast<double>(spawnRate_));
+            lastRefill_ = now;
+            if (spawnTokens_ < 1)
+            {
+                return false;
+            }
+            spawnTokens_ -= 1;
+            return true;
+        }
+
+        /**
+         * @brief CACHED 模式下按需扩容（调用方需持有 [taskQueMtx_]）
+         *
+         * 积压任务多于空闲线程且估计的排队等待超过 [scaleUpWait_]，或备用空闲线程不足时，
+         * 在令牌桶允许的前提下创建一个新线程
+         */
+        void addThreadIfNeeded()
+        {
+            if (poolMode_ != PoolMode::MODE_CACHED || currentThreadSize_ >= threadMaxSize_)
+            {
+                return;
+            }
+
+            size_t backlog = currentTaskSize_;
+            size_t idle = idleThreadSize_;
+            size_t spare = idle > backlog ? idle - backlog : 0;// 空闲线程接走积压任务后剩余的备用线程
+            auto now = std::chrono::steady_clock::now();
+            bool overloaded = backlog > idle && queueWaitSignalUs(now) >= static_cast<double>(scaleUpWait_.count());
+            if ((!overloaded && spare >= spareThreads_) || !takeSpawnToken(now))
+            {
+                return;
+            }
+
+            try
+            {
+                // 创建新的线程对象，并启动线程
+                auto ptr = std::make_unique<Thread>([this](auto &&PH1) {
+                    this->threadFunc(std::forward<decltype(PH1)>(PH1));
+                });
+                size_t threadId = ptr->getThreadId();
+                threads_.emplace(threadId, std::move(ptr));
+                threads_[threadId]->start();
+                // 更新线程相关成员变量
+                currentThreadSize_++;
+                idleThreadSize_++;
+                threadsCreated_++;
+                lastScaleUp_ = now;
+            } catch (const std::system_error &e)
+            {
+                // 可以根据实际情况进行其他处理，比如记录日志、返回错误信息等
+                std::cerr << "Failed to create a new thread: " << e.what() << std::endl;
+            }
+        }
+
+        /**
+         * @brief 唤醒一个等待任务的线程（调用方需持有 [taskQueMtx_]）
+         *
+         * CACHED 模式唤醒最近进入空闲的线程（后进先出），让长时间空闲的线程能够到期回收
+         */
+        void wakeIdleThreadLocked()
+        {
+            if (poolMode_ != PoolMode::MODE_CACHED)
+            {
+                taskQueNotEmpty_.notify_one();
+                return;
+            }
+            if (!idleWaiters_.empty())
+            {
+                IdleWaiter *waiter = idleWaiters_.back();
+                idleWaiters_.pop_back();
+                waiter->notified = true;
+                waiter->cond.notify_one();
+            }
+        }
+
+        /**
+         * @brief CACHED 模式下空闲超时的线程是否应当回收（调用方需持有 [taskQueMtx_]）
+         */
+        bool shouldReapLocked(std::chrono::steady_clock::time_point now) const
+        {
+            return currentThreadSize_ > initThreadSize_ && idleThreadSize_ > spareThreads_ &&
+                   now - lastScaleUp_ >= std::chrono::seconds(threadMaxIdleTime);
+        }
+
+        /**
+         * @brief 为当前线程取一个统计块，优先复用已退出线程留下的
+         */
+        WorkerStats *acquireWorkerStats()
+        {
+            std::unique_lock<std::mutex> lock(statsMtx_);
+            if (!freeWorkerStats_.empty())
+            {
+                WorkerStats *stats = freeWorkerStats_.back();
+                freeWorkerStats_.pop_back();
+                return stats;
+            }
+            workerStats_.push_back(std::make_unique<WorkerStats>());
+            return workerStats_.back().get();
+        }
+
+        /**
+         * @brief 线程退出时归还统计块，累计值保留（调用方持有 [taskQueMtx_]，其后加 [statsMtx_]）
+         *
+         * 同时把本线程缓存的共享状态块还给中心链表：工作线程是分离的，
+         * 其线程局部缓存的析构可能晚于线程池乃至进程的静态对象析构，必须在通知线程池退出之前清空
+         */
+        void releaseWorkerStatsLocked(WorkerStats *stats)
+        {
+            detail::SharedStateCache::local().flush();
+            std::unique_lock<std::mutex> lock(statsMtx_);
+            freeWorkerStats_.push_back(stats);
+        }
+
+        /**
+         * @brief 执行任务，并记录其排队等待时间与执行时间
+         * @param task 任务及其入队时间
+         * @param stats 当前线程的统计块
+         */
+        static void runTask(QueuedTask &task, WorkerStats *stats)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            stats->recordWait(task.enqueueTime, begin);
+            task.task();
+            stats->recordRun(begin, std::chrono::steady_clock::now());
+        }
+
+        /**
+         * @brief 当前排队中的任务数（只读原子计数，无需加锁）
+         */
+        size_t queueDepth() const
+        {
+            if (poolMode_ == PoolMode::MODE_WORK_STEALING)
+            {
+                return pendingTasks_.load(std::memory_order_relaxed);
+            }
+            if (useLockFreeQueue_)
+            {
+                size_t depth = 0;
+                for (const auto &queue: lockFreeLanes_)
+                {
+                    depth += queue->size();
+                }
+                return depth;
+            }
+            return currentTaskSize_;
+        }
+
+        /**
+         * @brief 线程函数，用于从任务队列中取出任务并执行
+         * @param threadId 线程ID
+         */
+        void threadFunc(size_t threadId)
+        {
+            // 记录线程第一次执行任务的时间
+            auto lastTime = std::chrono::steady_clock::now();
+            WorkerStats *stats = acquireWorkerStats();
+
+            // 线程循环工作，不断从任务队列中取出任务并执行
+            while (true)
+            {
+                // 用于临时存储从任务队列中取出的任务
+                QueuedTask task;
+                {
+                    // 获取锁以访问任务队列
+                    std::unique_lock<std::mutex> lock(taskQueMtx_);
+
+                    // 如果任务队列为空，线程进入等待状态
+                    while (currentTaskSize_ == 0)
+                    {
+                        // 如果没有任务了，则判断线程池是否需要销毁：
+                        // 否 -> 继续阻塞
+                        // 是 -> 回收当前线程
+                        if (!poolIsRunning_)
+                        {
+                            // 当线程池停止运行时，回收正在执行任务的线程
+                            releaseWorkerStatsLocked(stats);
+                            threads_.erase(threadId);
+                            // 每回收一个线程唤醒一次主线程，让其重新判断线程是否全部退出完毕：
+                            // 是 -> 停止阻塞，线程池销毁完毕
+                            // 否 -> 继续阻塞，等待所有线程回收
+                            exitCond_.notify_all();
+                            return;// 结束线程函数，即结束当前线程
+                        }
+
+                        // 在CACHED模式下，登记为空闲线程并一直等待到回收期限，超时则判断是否需要回收线程
+                        if (poolMode_ == PoolMode::MODE_CACHED)
+                        {
+                            IdleWaiter waiter;
+                            idleWaiters_.push_back(&waiter);
+                            auto deadline = lastTime + std::chrono::seconds(threadMaxIdleTime);
+                            waiter.cond.wait_until(lock, deadline,
+                                                   [&]() { return waiter.notified || !poolIsRunning_; });
+                            if (!waiter.notified)
+                            {
+                                // 超时或线程池停止：自行从空闲栈中移除
+                                idleWaiters_.erase(std::find(idleWaiters_.begin(), idleWaiters_.end(), &waiter));
+
+                                auto now = std::chrono::steady_clock::now();
+                                if (poolIsRunning_ && currentTaskSize_ == 0 && now >= deadline)
+                                {
+                                    if (shouldReapLocked(now))
+                                    {
+                                        // 回收线程
+                                        releaseWorkerStatsLocked(stats);
+                                        threads_.erase(threadId);
+                                        // 更新线程池相关变量
+                                        currentThreadSize_--;
+                                        idleThreadSize_--;
+                                        threadsReaped_++;
+                                        return;
+                                    }
+                                    // 暂不回收，重新开始计时
+                                    lastTime = now;
+                                }
+                            }
+                        }
+                        else
+                        {
+                            // 在非CACHED模式下，等待任务队列非空
+                            taskQueNotEmpty_.wait(lock);
+                        }
+                    }
+
+                    // 从任务队列中取出任务
+                    // （每次提交都已唤醒一个消费者，无需再唤醒其他工作线程）
+                    task = popTaskLocked();
+
+                    // 执行任务前，空闲线程数量减少；积压仍在时由出队线程继续扩容
+                    idleThreadSize_--;
+                    addThreadIfNeeded();
+                }// 释放锁，允许其他线程访问任务队列
+
+                // 执行任务
+                if (task.task)//保守判断
+                {
+                    runTask(task, stats);
+                }
+
+                // 任务完成，空闲线程数量增加
+                idleThreadSize_++;
+
+                // 更新线程执行完任务的时间
+                lastTime = std::chrono::steady_clock::now();
+            }
+        }
+
+        /**
+         * @brief 无锁队列模式的线程函数
+         * @param threadId 线程ID
+         */
+        void lockFreeThreadFunc(size_t threadId)
+        {
+            WorkerStats *stats = acquireWorkerStats();
+            while (true)
+            {
+                QueuedTask task;
+                if (!waitLockFreeTask(task))
+                {
+                    break;
+                }
+                idleThreadSize_--;
+                runTask(task, stats);
+                idleThreadSize_++;
+            }
+
+            std::unique_lock<std::mutex> lock(taskQueMtx_);
+            releaseWorkerStatsLocked(stats);
+            threads_.erase(threadId);
+            exitCond_.notify_all();
+        }
+
+        /**
+         * @brief 工作窃取模式的线程函数
+         * @param threadId 线程ID
+         * @param self 当前线程的本地队列
+         */
+        void workStealingThreadFunc(size_t threadId, Worker *self)
+        {
+            currentWorker_ = self;
+            uint64_t seed = reinterpret_cast<uintptr_t>(self) | 1;
+            WorkerStats *stats = acquireWorkerStats();
+
+            while (true)
+            {
+                QueuedTask task = findTask(self, seed, stats);
+                if (task.task)
+                {
+                    pendingTasks_.fetch_sub(1, std::memory_order_seq_cst);
+
+                    // 仍有积压且有线程休眠时接力唤醒一个，让集中提交的任务尽快被分摊
+                    if (pendingTasks_.load(std::memory_order_seq_cst) > 0 &&
+                        sleepers_.load(std::memory_order_seq_cst) > 0)
+                    {
+                        wakeOneWorker();
+                    }
+
+                    idleThreadSize_--;
+                    runTask(task, stats);
+                    idleThreadSize_++;
+                    continue;
+                }
+
+                // 没有可执行的任务：先登记为休眠者，再复查任务计数（与 notifyTaskAdded 构成 Dekker 式同步，避免丢失唤醒）
+                {
+                    std::unique_lock<std::mutex> lock(parkMtx_);
+                    sleepers_.fetch_add(1, std::memory_order_seq_cst);
+                    while (pendingTasks_.load(std::memory_order_seq_cst) == 0 && poolIsRunning_)
+                    {
+                        parkCond_.wait(lock);
+                    }
+                    sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+
+                    // 线程池已停止且所有任务都已执行完毕，回收当前线程
+                    if (!poolIsRunning_ && pendingTasks_.load(std::memory_order_seq_cst) == 0)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            currentWorker_ = nullptr;
+            std::unique_lock<std::mutex> lock(taskQueMtx_);
+            releaseWorkerStatsLocked(stats);
+            threads_.erase(threadId);
+            exitCond_.notify_all();
+        }
+
+        /**
+         * @brief 按 本地队列 -> 注入队列 -> 窃取 的顺序获取一个任务
+         * @param self 当前线程的本地队列
+         * @param seed 随机数状态，用于选择窃取目标
+         * @param stats 当前线程的统计块，记录窃取次数
+         * @return 任务，没有可执行任务时返回空
+         */
+        QueuedTask findTask(Worker *self, uint64_t &seed, WorkerStats *stats)
+        {
+            // 有高优先级任务排队时先取共享队列，避免其排在本地积压之后
+            if (highLaneDepth_.load(std::memory_order_relaxed) > 0)
+            {
+                std::unique_lock<std::mutex> lock(taskQueMtx_);
+                if (currentTaskSize_ > 0)
+                {
+                    return popTaskLocked();
+                }
+            }
+
+            if (std::optional<QueuedTask *> local = self->deque.pop())
+            {
+                return self->takeNode(*local);
+            }
+
+            if (currentTaskSize_.load(std::memory_order_relaxed) > 0)
+            {
+                std::unique_lock<std::mutex> lock(taskQueMtx_);
+                if (currentTaskSize_ > 0)
+                {
+                    return popTaskLocked();
+                }
+            }
+
+            // 从随机位置开始轮询其他线程，避免所有窃取者集中在同一个目标上
+            size_t n = workers_.size();
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            size_t start = seed % n;
+            for (size_t i = 0; i < n; ++i)
+            {
+                Worker *victim = workers_[(start + i) % n].get();
+                if (victim == self)
+                {
+                    continue;
+                }
+                if (std::optional<QueuedTask *> stolen = victim->deque.steal())
+                {
+                    stats->recordSteal();
+                    return self->takeNode(*stolen);
+                }
+            }
+            return {};
+        }
+
+        /**
+         * @brief 工作窃取模式下，任务入队后更新计数并按需唤醒一个休眠线程
+         */
+        void notifyTaskAdded()
+        {
+            pendingTasks_.fetch_add(1, std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_seq_cst) > 0)
+            {
+                wakeOneWorker();
+            }
+        }
+
+        /**
+         * @brief 工作窃取模式下，批量任务入队后更新计数，并唤醒至多 n 个休眠线程
+         * @param n 新增任务数
+         */
+        void notifyTasksAdded(size_t n)
+        {
+            if (n == 0)
+            {
+                return;
+            }
+            pendingTasks_.fetch_add(n, std::memory_order_seq_cst);
+            size_t sleepers = sleepers_.load(std::memory_order_seq_cst);
+            if (sleepers == 0)
+            {
+                return;
+            }
+            {
+                std::unique_lock<std::mutex> lock(parkMtx_);
+            }
+            if (n >= sleepers)
+            {
+                parkCond_.notify_all();
+            }
+            else
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    parkCond_.notify_one();
+                }
+            }
+        }
+
+        /**
+         * @brief 唤醒一个休眠的工作窃取线程
+         */
+        void wakeOneWorker()
+        {
+            // 加锁后再通知：休眠线程在持锁期间完成“复查计数 -> wait”，不会错过本次通知
+            {
+                std::unique_lock<std::mutex> lock(parkMtx_);
+            }
+            parkCond_.notify_one();
+        }
+
+        /**
+         * @brief 检查线程池是否正在运行
+         * @return 如果线程池正在运行，返回 true；否则返回 false
+         */
+        bool checkRunningState() const
+        {
+            return poolIsRunning_;
+        }
+
+    private:
+        /*====================线程相关变量====================*/
+        std::unordered_map<size_t, std::unique_ptr<Thread>> threads_;//!< 线程列表
+        size_t initThreadSize_;                                      //!< 初始化线程数量
+        size_t threadMaxSize_;                                       //!< 线程上限数量
+        size_t threadMaxIdleTime;                                    //!< 线程最大空闲时间
+        std::atomic_uint idleThreadSize_;                            //!< 空闲线程数量
+        std::atomic_uint currentThreadSize_;                         //!< 当前线程数量
+
+        /*====================任务相关变量====================*/
+        Lane lanes_[TASK_PRIORITY_COUNT]; //!< 各优先级的任务队列（下标为 TaskPriority）
+        size_t taskQueMaxSize_;           //!< 任务队列最大大小
+        std::atomic_uint currentTaskSize_;//!< 当前任务数量
+
+        /*====================工作窃取相关变量====================*/
+        std::vector<std::unique_ptr<Worker>> workers_;    //!< 所有工作线程的本地队列
+        inline static thread_local Worker *currentWorker_;//!< 当前线程对应的本地队列（非工作线程为空）
+        std::atomic_size_t pendingTasks_ = 0;             //!< 所有队列中尚未被取走的任务数
+        std::atomic_size_t sleepers_ = 0;                 //!< 休眠中的工作线程数
+        std::mutex parkMtx_;                              //!< 休眠互斥锁
+        std::condition_variable parkCond_;                //!< 休眠条件变量
+
+        /*====================线程通信相关变量====================*/
+        std::mutex taskQueMtx_;                  //!< 任务队列互斥锁
+        std::condition_variable taskQueNotEmpty_;//!< 任务队列非空条件变量
+        std::condition_variable exitCond_;       //!< 线程资源回收条件变量
+
+        /*====================线程池属性相关变量====================*/
+        PoolMode poolMode_;             //!< 线程池工作模式
         std::atomic_bool poolIsRunning_;//!< 线程池是否正在运行
+
+        /*====================拒绝策略相关变量====================*/
+        RejectPolicy rejectPolicy_;              //!< 任务队列已满时的拒绝策略
+        std::chrono::milliseconds blockTimeout_; //!< BLOCK 策略下的最长等待时间
+        std::atomic<uint64_t> rejectedTasks_;    //!< 被拒绝的任务数
+        std::atomic<uint64_t> callerRunsTasks_;  //!< 在提交线程中执行的任务数
+        std::atomic<uint64_t> discardedTasks_;   //!< 被丢弃的最早任务数
+
+        /*====================CACHED 模式伸缩相关变量（由 taskQueMtx_ 保护）====================*/
+        /**
+         * @struct IdleWaiter
+         * @brief CACHED 模式下等待任务的空闲线程（位于该线程栈上）
+         */
+        struct IdleWaiter
+        {
+            std::condition_variable cond;//!< 该线程专用的条件变量
+            bool notified = false;       //!< 是否已被分配唤醒
+        };
+
+        static constexpr double kWaitEwmaAlpha = 0.125;        //!< 排队等待滑动平均的平滑系数
+        static constexpr double kDispatchWindowSeconds = 0.1;  //!< 出队速率的统计窗口（秒）
+
+        std::vector<IdleWaiter *> idleWaiters_;                            //!< 空闲线程栈（栈顶为最近空闲的线程）
+        std::chrono::microseconds scaleUpWait_{DEFAULT_SCALE_UP_WAIT_US};  //!< 扩容的排队等待阈值
+        size_t spawnRate_ = DEFAULT_THREAD_SPAWN_RATE;                     //!< 每秒最多创建的线程数
+        size_t spawnBurst_ = DEFAULT_THREAD_SPAWN_BURST;                   //!< 令牌桶容量
+        size_t spareThreads_ = 0;                                          //!< 保留的备用空闲线程数
+        double spawnTokens_ = 0;                                           //!< 当前可用的线程创建令牌
+        std::chrono::steady_clock::time_point lastRefill_;                 //!< 上次补充令牌的时间
+        std::chrono::steady_clock::time_point lastScaleUp_;                //!< 上次扩容的时间
+        double queueWaitEwmaUs_ = 0;                                       //!< 排队等待时间的滑动平均（微秒）
+        double dispatchRate_ = 0;                                          //!< 出队速率的滑动平均（任务/秒）
+        uint64_t dispatchedInWindow_ = 0;                                  //!< 当前统计窗口内的出队数
+        std::chrono::steady_clock::time_point dispatchWindowStart_;        //!< 当前统计窗口的起始时间
+        uint64_t threadsCreated_ = 0;                                      //!< 累计因扩容创建的线程数
+        uint64_t threadsReaped_ = 0;                                       //!< 累计回收的线程数
+
+        /*====================优先级相关变量====================*/
+        std::chrono::milliseconds starvationThreshold_;//!< 低优先级任务的饥饿阈值
+        std::atomic_size_t highLaneDepth_ = 0;          //!< HIGH 队列中的任务数（供工作窃取线程无锁判断）
+
+        /*====================运行统计相关变量（由 statsMtx_ 保护）====================*/
+        mutable std::mutex statsMtx_;                          //!< 保护统计块列表，不与任务队列共用
+        std::vector<std::unique_ptr<WorkerStats>> workerStats_;//!< 所有统计块（线程退出后保留）
+        std::vector<WorkerStats *> freeWorkerStats_;           //!< 未被线程持有的统计块
+
+        /*====================无锁队列相关变量====================*/
+        static constexpr int kSpinCount = 128;//!< 工作线程休眠前自旋尝试取任务的次数
+        static constexpr int kYieldCount = 8; //!< 自旋之后、休眠之前让出 CPU 的次数
+
+        bool lockFreeQueue_ = false;                                        //!< 是否请求使用无锁任务队列
+        bool useLockFreeQueue_ = false;                                     //!< 是否正在使用无锁任务队列（启动时确定）
+        std::unique_ptr<MpmcQueue<QueuedTask>> lockFreeLanes_[TASK_PRIORITY_COUNT];//!< 各优先级的无锁任务队列
+        EventCount notEmptyEvent_;                                          //!< 工作线程等待任务
+        std::atomic_size_t spinningWorkers_ = 0;                            //!< 正在自旋找任务的工作线程数
+        EventCount notFullEvents_[TASK_PRIORITY_COUNT];                     //!< 生产者等待各队列空位（BLOCK 策略）
     };
 }// namespace thp
 
@@ -0,0 +1,191 @@
+#ifndef THREADPOOL_WORK_STEALING_DEQUE_H
+#define THREADPOOL_WORK_STEALING_DEQUE_H
+
+#include "../net/NonCopyable.h"
+#include "../net/SysHeadFile.h"
+
+#include <optional>
+
+namespace thp
+{
+    /**
+     * @class WorkStealingDeque
+     * @brief Chase-Lev 无锁工作窃取双端队列
+     * @tparam T 元素类型，必须可平凡拷贝（通常为任务指针）
+     *
+     * - 所有者线程在底部 [push()] / [pop()]（LIFO，缓存友好）
+     * - 其他线程在顶部 [steal()]（FIFO），与所有者仅在最后一个元素上通过 CAS 竞争
+     * - 容量不足时由所有者线程扩容，旧数组保留到析构，保证并发窃取者读到的内存始终有效
+     *
+     * 内存序参考 Lê et al., "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP'13)
+     */
+    template<typename T>
+    class WorkStealingDeque : net::NonCopyable
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque element must be trivially copyable");
+
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 初始容量（向上取整为 2 的幂）
+         */
+        explicit WorkStealingDeque(size_t capacity = 256)
+            : top_(0),
+              bottom_(0)
+        {
+            size_t size = 1;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            arrays_.push_back(std::make_unique<Array>(size));
+            array_.store(arrays_.back().get(), std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief 在底部压入元素（仅所有者线程调用）
+         * @param item 元素
+         */
+        void push(T item)
+        {
+            int64_t b = bottom_.load(std::memory_order_relaxed);
+            int64_t t = top_.load(std::memory_order_acquire);
+            Array *a = array_.load(std::memory_order_relaxed);
+            if (b - t > static_cast<int64_t>(a->capacity) - 1)
+            {
+                a = grow(a, b, t);
+            }
+            a->put(b, item);
+            bottom_.store(b + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief 从底部弹出元素（仅所有者线程调用）
+         * @return 队列为空或最后一个元素被窃取时返回 std::nullopt
+         */
+        std::optional<T> pop()
+        {
+            int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+            Array *a = array_.load(std::memory_order_relaxed);
+            bottom_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top_.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                // 队列为空，恢复 bottom
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+
+            T item = a->get(b);
+            if (t == b)
+            {
+                // 只剩最后一个元素，与窃取者竞争
+                bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                        std::memory_order_relaxed);
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                if (!won)
+                {
+                    return std::nullopt;
+                }
+            }
+            return item;
+        }
+
+        /**
+         * @brief 从顶部窃取元素（任意线程调用）
+         * @return 队列为空或竞争失败时返回 std::nullopt
+         */
+        std::optional<T> steal()
+        {
+            int64_t t = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t b = bottom_.load(std::memory_order_acquire);
+            if (t >= b)
+            {
+                return std::nullopt;
+            }
+
+            Array *a = array_.load(std::memory_order_acquire);
+            T item = a->get(t);
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return std::nullopt;
+            }
+            return item;
+        }
+
+        /**
+         * @brief 估算当前元素数量（并发下仅供参考）
+         * @return 元素数量
+         */
+        [[nodiscard]] size_t size() const
+        {
+            int64_t b = bottom_.load(std::memory_order_relaxed);
+            int64_t t = top_.load(std::memory_order_relaxed);
+            return b > t ? static_cast<size_t>(b - t) : 0;
+        }
+
+        /**
+         * @brief 判断队列是否为空（并发下仅供参考）
+         * @return 为空返回 true
+         */
+        [[nodiscard]] bool empty() const
+        {
+            return size() == 0;
+        }
+
+    private:
+        /**
+         * @struct Array
+         * @brief 环形数组，下标按容量取模
+         */
+        struct Array
+        {
+            explicit Array(size_t size)
+                : capacity(size),
+                  mask(size - 1),
+                  buffer(new std::atomic<T>[size])
+            {}
+
+            T get(int64_t index) const
+            {
+                return buffer[static_cast<size_t>(index) & mask].load(std::memory_order_relaxed);
+            }
+
+            void put(int64_t index, T item)
+            {
+                buffer[static_cast<size_t>(index) & mask].store(item, std::memory_order_relaxed);
+            }
+
+            const size_t capacity;
+            const size_t mask;
+            std::unique_ptr<std::atomic<T>[]> buffer;
+        };
+
+        /**
+         * @brief 容量翻倍，复制 [t, b) 区间的元素
+         * @return 新数组
+         */
+        Array *grow(Array *old, int64_t b, int64_t t)
+        {
+            auto bigger = std::make_unique<Array>(old->capacity * 2);
+            for (int64_t i = t; i < b; ++i)
+            {
+                bigger->put(i, old->get(i));
+            }
+            Array *a = bigger.get();
+            arrays_.push_back(std::move(bigger));
+            array_.store(a, std::memory_order_release);
+            return a;
+        }
+
+        alignas(64) std::atomic<int64_t> top_;   //!< 窃取端下标
+        alignas(64) std::atomic<int64_t> bottom_;//!< 所有者端下标
+        std::atomic<Array *> array_;             //!< 当前使用的数组
+        std::vector<std::unique_ptr<Array>> arrays_;//!< 所有分配过的数组（含已被替换的旧数组）
+    };
+}// namespace thp
+
+#endif//THREADPOOL_WORK_STEALING_DEQUE_H
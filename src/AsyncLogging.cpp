@@ -0,0 +1,218 @@
+//
+// Created by shuzeyong on 2025/5/15.
+//
+
+#include "../include/net/AsyncLogging.h"
+
+using namespace net;
+
+AsyncLogging::AsyncLogging(std::string basename,
+                           off_t rollSize,
+                           int flushInterval,
+                           size_t maxQueuedBuffers,
+                           size_t maxFiles)
+    : flushInterval_(flushInterval),
+      maxQueuedBuffers_(maxQueuedBuffers > 0 ? maxQueuedBuffers : 1),
+      running_(false),
+      basename_(std::move(basename)),
+      rollSize_(rollSize),
+      maxFiles_(maxFiles),
+      currentBuffer_(new Buffer),
+      nextBuffer_(new Buffer),
+      flushRequested_(0),
+      flushCompleted_(0),
+      droppedLines_(0),
+      droppedBytes_(0)
+{
+    buffers_.reserve(16);
+}
+
+AsyncLogging::~AsyncLogging()
+{
+    if (running_)
+    {
+        stop();
+    }
+}
+
+void AsyncLogging::append(const char *logline, size_t len)
+{
+    // 单行超过缓冲区容量：任何缓冲区都放不下，直接计入丢弃
+    if (len >= kLargeBuffer)
+    {
+        droppedLines_.fetch_add(1, std::memory_order_relaxed);
+        droppedBytes_.fetch_add(len, std::memory_order_relaxed);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // 快速路径：当前缓冲区放得下，直接拷贝
+    if (currentBuffer_->avail() > len)
+    {
+        currentBuffer_->append(logline, len);
+        return;
+    }
+
+    // 待写缓冲区已达上限：后台写入跟不上，丢弃该行而不是无限制申请内存
+    if (buffers_.size() >= maxQueuedBuffers_)
+    {
+        droppedLines_.fetch_add(1, std::memory_order_relaxed);
+        droppedBytes_.fetch_add(len, std::memory_order_relaxed);
+        return;
+    }
+
+    // 当前缓冲区写满：移入待写队列，换上预备缓冲区（没有则新建）
+    buffers_.push_back(std::move(currentBuffer_));
+    if (nextBuffer_)
+    {
+        currentBuffer_ = std::move(nextBuffer_);
+    }
+    else
+    {
+        currentBuffer_.reset(new Buffer);
+    }
+    currentBuffer_->append(logline, len);
+
+    // 有写满的缓冲区，立即唤醒后台线程
+    cond_.notify_one();
+}
+
+void AsyncLogging::start()
+{
+    if (running_)
+    {
+        return;
+    }
+    running_ = true;
+    // net::Thread 只能启动一次，每次启动都新建线程对象，使 stop() 之后可以再次 start()
+    thread_ = std::make_unique<Thread>([this] { threadFunc(); }, "AsyncLogging");
+    thread_->start();
+}
+
+void AsyncLogging::stop()
+{
+    if (!running_)
+    {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        running_ = false;
+        cond_.notify_one();
+    }
+    thread_->join();
+}
+
+void AsyncLogging::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!running_)
+    {
+        return;
+    }
+
+    // 申请一个刷新序号，后台线程完成对应批次后会推进 flushCompleted_
+    uint64_t seq = ++flushRequested_;
+    cond_.notify_one();
+    flushDone_.wait(lock, [this, seq] { return flushCompleted_ >= seq; });
+}
+
+uint64_t AsyncLogging::droppedLines() const
+{
+    return droppedLines_.load(std::memory_order_relaxed);
+}
+
+uint64_t AsyncLogging::droppedBytes() const
+{
+    return droppedBytes_.load(std::memory_order_relaxed);
+}
+
+void AsyncLogging::writeBuffers(LogFile &output, const AsyncLogging::BufferVector &buffers)
+{
+    for (const BufferPtr &buffer: buffers)
+    {
+        output.append(buffer->data(), buffer->length());
+    }
+}
+
+void AsyncLogging::threadFunc()
+{
+    // 日志文件只由后台线程访问，无需加锁
+    LogFile output(basename_, rollSize_, false, flushInterval_, 1024, maxFiles_);
+
+    // 后台线程持有两块空闲缓冲区，交换时直接还给前端，避免前端临界区内申请内存
+    BufferPtr newBuffer1(new Buffer);
+    BufferPtr newBuffer2(new Buffer);
+    BufferVector buffersToWrite;
+    buffersToWrite.reserve(16);
+
+    while (running_)
+    {
+        uint64_t flushSeq;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            // 没有写满的缓冲区且没有刷新请求时，最多等待一个刷新周期
+            if (buffers_.empty() && flushRequested_ == flushCompleted_ && running_)
+            {
+                cond_.wait_for(lock, std::chrono::seconds(flushInterval_));
+            }
+
+            // 连同未写满的当前缓冲区一起取走，临界区内只做指针交换
+            buffers_.push_back(std::move(currentBuffer_));
+            currentBuffer_ = std::move(newBuffer1);
+            buffersToWrite.swap(buffers_);
+            if (!nextBuffer_)
+            {
+                nextBuffer_ = std::move(newBuffer2);
+            }
+            flushSeq = flushRequested_;
+        }
+
+        // 临界区外批量写文件
+        writeBuffers(output, buffersToWrite);
+
+        // 保留两块缓冲区用于下一轮交换，其余释放
+        if (buffersToWrite.size() > 2)
+        {
+            buffersToWrite.resize(2);
+        }
+        if (!newBuffer1)
+        {
+            newBuffer1 = std::move(buffersToWrite.back());
+            buffersToWrite.pop_back();
+            newBuffer1->reset();
+        }
+        if (!newBuffer2 && !buffersToWrite.empty())
+        {
+            newBuffer2 = std::move(buffersToWrite.back());
+            buffersToWrite.pop_back();
+            newBuffer2->reset();
+        }
+        buffersToWrite.clear();
+        output.flush();
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            flushCompleted_ = flushSeq;
+        }
+        flushDone_.notify_all();
+    }
+
+    // 退出前写出剩余日志
+    uint64_t flushSeq;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        buffers_.push_back(std::move(currentBuffer_));
+        currentBuffer_ = std::move(newBuffer1);
+        buffersToWrite.swap(buffers_);
+        flushSeq = flushRequested_;
+    }
+    writeBuffers(output, buffersToWrite);
+    output.flush();
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        flushCompleted_ = flushSeq;
+    }
+    flushDone_.notify_all();
+}
@@ -0,0 +1,298 @@
+//
+// Created by shuzeyong on 2025/5/17.
+//
+
+#include "../include/net/BinaryLogging.h"
+
+using namespace net;
+
+/**
+ * @struct BinaryLogger::FormatEntry
+ * @brief 调用点注册的格式定义
+ */
+struct BinaryLogger::FormatEntry
+{
+    uint8_t level;                //!< 日志级别
+    std::string file;             //!< 源文件名（不含目录）
+    uint32_t line;                //!< 行号
+    std::string fmt;              //!< 格式串
+    std::vector<BinArgType> types;//!< 参数类型
+};
+
+/**
+ * @struct BinaryLogger::ThreadRing
+ * @brief 单生产者（所属线程）单消费者（后台线程）的字节环形缓冲区
+ *
+ * head/tail 为单调递增的字节序号，分处不同缓存行，避免前后端伪共享
+ */
+struct BinaryLogger::ThreadRing
+{
+    explicit ThreadRing(size_t size)
+        : data(new char[size]),
+          mask(size - 1),
+          tid(CurrentThread::tid())
+    {}
+
+    std::unique_ptr<char[]> data;//!< 数据存储区
+    const size_t mask;           //!< 容量 - 1（容量为 2 的幂）
+    const int tid;               //!< 所属线程 ID
+
+    alignas(64) std::atomic<uint64_t> head{0};//!< 写入序号，仅所属线程修改
+    alignas(64) std::atomic<uint64_t> tail{0};//!< 读取序号，仅后台线程修改
+    std::atomic_bool exited{false};           //!< 所属线程是否已退出
+};
+
+/**
+ * @brief 向上取整为 2 的幂
+ */
+static size_t roundUpPowerOfTwo(size_t n)
+{
+    size_t size = 1;
+    while (size < n)
+    {
+        size <<= 1;
+    }
+    return size;
+}
+
+/**
+ * @brief 写入原始字节
+ */
+static void writeRaw(FILE *fp, const void *data, size_t len)
+{
+    fwrite_unlocked(data, 1, len, fp);
+}
+
+BinaryLogger::BinaryLogger()
+    : emittedFormats_(0),
+      ringSize_(0),
+      flushIntervalMs_(100),
+      fp_(nullptr),
+      droppedRecords_(0)
+{}
+
+BinaryLogger::~BinaryLogger()
+{
+    stop();
+}
+
+BinaryLogger &BinaryLogger::getInstance()
+{
+    static BinaryLogger logger;
+    return logger;
+}
+
+bool BinaryLogger::start(const std::string &basename, int flushIntervalMs, size_t ringSize)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (running_)
+    {
+        return true;
+    }
+
+    std::string filename = basename + ".binlog";
+    fp_ = fopen(filename.c_str(), "we");
+    if (fp_ == nullptr)
+    {
+        fprintf(stderr, "BinaryLogger: open %s failed: %s\n", filename.c_str(), strerror(errno));
+        return false;
+    }
+    writeRaw(fp_, kBinLogMagic, sizeof(kBinLogMagic));
+
+    // 新文件需要重新写出完整的格式字典
+    emittedFormats_ = 0;
+    flushIntervalMs_ = flushIntervalMs > 0 ? flushIntervalMs : 1;
+    ringSize_ = roundUpPowerOfTwo(std::max(ringSize, 2 * kBinLogMaxRecord));
+
+    running_ = true;
+    thread_ = std::make_unique<Thread>([this] { threadFunc(); }, "BinaryLogging");
+    thread_->start();
+    return true;
+}
+
+void BinaryLogger::stop()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!running_)
+        {
+            return;
+        }
+        running_ = false;
+        cond_.notify_one();
+    }
+    thread_->join();
+    thread_.reset();
+
+    fclose(fp_);
+    fp_ = nullptr;
+}
+
+uint64_t BinaryLogger::droppedRecords() const
+{
+    return droppedRecords_.load(std::memory_order_relaxed);
+}
+
+uint32_t BinaryLogger::registerFormat(std::atomic_uint32_t *siteId, int level, const char *file, int line,
+                                      const char *fmt, const BinArgType *types, size_t nargs)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // 多个线程同时首次执行同一调用点时只注册一次
+    uint32_t id = siteId->load(std::memory_order_relaxed);
+    if (id != 0)
+    {
+        return id;
+    }
+
+    const char *slash = strrchr(file, '/');
+    formats_.push_back(FormatEntry{static_cast<uint8_t>(level),
+                                   slash ? slash + 1 : file,
+                                   static_cast<uint32_t>(line),
+                                   fmt,
+                                   std::vector<BinArgType>(types, types + nargs)});
+    id = static_cast<uint32_t>(formats_.size());
+    siteId->store(id, std::memory_order_release);
+    return id;
+}
+
+BinaryLogger::ThreadRing *BinaryLogger::threadRing()
+{
+    // 线程退出时只做标记，由后台线程写完剩余数据后回收
+    static thread_local struct Holder
+    {
+        std::shared_ptr<ThreadRing> ring;
+        ~Holder()
+        {
+            if (ring)
+            {
+                ring->exited.store(true, std::memory_order_release);
+            }
+        }
+    } holder;
+
+    if (__builtin_expect(!holder.ring, 0))
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        holder.ring = std::make_shared<ThreadRing>(ringSize_);
+        rings_.push_back(holder.ring);
+    }
+    return holder.ring.get();
+}
+
+void BinaryLogger::append(const char *record, size_t len)
+{
+    ThreadRing *ring = threadRing();
+    const size_t capacity = ring->mask + 1;
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    uint64_t tail = ring->tail.load(std::memory_order_acquire);
+
+    // 后台线程跟不上时丢弃新记录，前端不阻塞
+    if (capacity - (head - tail) < len)
+    {
+        droppedRecords_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    size_t pos = head & ring->mask;
+    size_t first = std::min(len, capacity - pos);
+    memcpy(ring->data.get() + pos, record, first);
+    memcpy(ring->data.get(), record + first, len - first);
+    ring->head.store(head + len, std::memory_order_release);
+}
+
+void BinaryLogger::threadFunc()
+{
+    while (running_)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_.wait_for(lock, std::chrono::milliseconds(flushIntervalMs_), [] { return !running_; });
+        }
+        drain();
+    }
+
+    // 退出前写出剩余记录
+    drain();
+}
+
+void BinaryLogger::drain()
+{
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        rings = rings_;
+    }
+
+    // 先读退出标记再读写入序号：标记为已退出的线程，读到的 head 已包含其全部记录
+    std::vector<bool> exited(rings.size());
+    std::vector<uint64_t> heads(rings.size());
+    for (size_t i = 0; i < rings.size(); ++i)
+    {
+        exited[i] = rings[i]->exited.load(std::memory_order_acquire);
+        heads[i] = rings[i]->head.load(std::memory_order_acquire);
+    }
+
+    // 记录引用的格式 ID 都在对应 head 发布之前注册，此时格式表已包含它们
+    std::vector<FormatEntry> newFormats;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        newFormats.assign(formats_.begin() + static_cast<ptrdiff_t>(emittedFormats_), formats_.end());
+        emittedFormats_ = formats_.size();
+    }
+    auto id = static_cast<uint32_t>(emittedFormats_ - newFormats.size());
+    for (const FormatEntry &entry: newFormats)
+    {
+        ++id;
+        auto nargs = static_cast<uint16_t>(entry.types.size());
+        auto fileLen = static_cast<uint32_t>(entry.file.size());
+        auto fmtLen = static_cast<uint32_t>(entry.fmt.size());
+        writeRaw(fp_, &kBinLogFormatEntry, sizeof(kBinLogFormatEntry));
+        writeRaw(fp_, &id, sizeof(id));
+        writeRaw(fp_, &entry.level, sizeof(entry.level));
+        writeRaw(fp_, &entry.line, sizeof(entry.line));
+        writeRaw(fp_, &nargs, sizeof(nargs));
+        writeRaw(fp_, entry.types.data(), entry.types.size());
+        writeRaw(fp_, &fileLen, sizeof(fileLen));
+        writeRaw(fp_, entry.file.data(), fileLen);
+        writeRaw(fp_, &fmtLen, sizeof(fmtLen));
+        writeRaw(fp_, entry.fmt.data(), fmtLen);
+    }
+
+    // 环形缓冲区中只有完整记录，整段原样写出，后台线程无需解析
+    bool reclaim = false;
+    for (size_t i = 0; i < rings.size(); ++i)
+    {
+        ThreadRing *ring = rings[i].get();
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        auto len = static_cast<uint32_t>(heads[i] - tail);
+        if (len > 0)
+        {
+            const size_t capacity = ring->mask + 1;
+            size_t pos = tail & ring->mask;
+            size_t first = std::min<size_t>(len, capacity - pos);
+            int32_t tid = ring->tid;
+            writeRaw(fp_, &kBinLogChunkEntry, sizeof(kBinLogChunkEntry));
+            writeRaw(fp_, &tid, sizeof(tid));
+            writeRaw(fp_, &len, sizeof(len));
+            writeRaw(fp_, ring->data.get() + pos, first);
+            writeRaw(fp_, ring->data.get(), len - first);
+            ring->tail.store(heads[i], std::memory_order_release);
+        }
+        reclaim = reclaim || exited[i];
+    }
+    fflush(fp_);
+
+    // 回收已退出且数据已写完的线程缓冲区
+    if (reclaim)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < rings.size(); ++i)
+        {
+            if (exited[i])
+            {
+                rings_.erase(std::find(rings_.begin(), rings_.end(), rings[i]));
+            }
+        }
+    }
+}
@@ -6,8 +6,8 @@
 
 using namespace net;
 
-Buffer::Buffer(size_t initialSize)
-    : buffer_(kCheapPrepend + initialSize),
+Buffer::Buffer(size_t initialSize, NgxBlockSource *source)
+    : buffer_(kCheapPrepend + initialSize, NgxBlockAllocator<char>(source)),
       readerIndex_(kCheapPrepend),
       writerIndex_(kCheapPrepend)
 {}
@@ -28,7 +28,7 @@ void Buffer::retrieve(size_t len)
 
 std::string Buffer::retrieveAllAsString()
 {
-    return retrieveAsString(readerIndex_);
+    return retrieveAsString(readableBytes());
 }
 
 std::string Buffer::retrieveAsString(size_t len)
@@ -168,6 +168,10 @@ size_t Buffer::writableBytes() const
 {
     return buffer_.size() - writerIndex_;
 }
+size_t Buffer::internalCapacity() const
+{
+    return buffer_.capacity();
+}
 const char *Buffer::begin() const
 {
     return buffer_.data();
@@ -176,6 +180,10 @@ char *Buffer::begin()
 {
     return buffer_.data();
 }
+const char *Buffer::peek() const
+{
+    return beginRead();
+}
 const char *Buffer::beginRead() const
 {
     return begin() + readerIndex_;
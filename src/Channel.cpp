@@ -2,6 +2,8 @@
 // Created by shuzeyong on 2025/5/1.
 //
 
+#define LOG_MODULE net::LogModule::kChannel
+
 #include "../include/net/Channel.h"
 
 using namespace net;
@@ -21,7 +23,12 @@ Channel::Channel(EventLoop *loop, int fd)
 
 Channel::~Channel()
 {
-    remove();// 自动清理
+    // 自动清理：已从 Poller 移除（index_ 复位为 -1）时不再访问所属 EventLoop，
+    // 连接对象的最后一个引用可能在其他线程释放，此时不能触碰 ioLoop 的 Poller
+    if (index_ != -1)
+    {
+        remove();
+    }
 }
 
 void Channel::tie(const std::shared_ptr<void> &obj)
@@ -62,7 +69,11 @@ void Channel::handleEvent(Timestamp receiveTime)
 
 void Channel::handleEventWithGuard(Timestamp receiveTime)
 {
-    LOG_INFO("channel fd=%d handleEvent returnEvent:%d\n", getFd(), revents_);
+    LOG_DEBUG("channel fd=%d handleEvent returnEvent:%u\n", getFd(), revents_);
+
+    // 执行每个回调前发布其类型：EventLoop::loop 只知道 fd，看门狗据此定位卡住的调用点
+    // （定时器通道的读回调中，TimerQueue 会再细化为具体的定时器回调）
+    LoopActivity &activity = loop_->metrics().activity;
 
     // 1. 处理错误事件（EPOLLERR 优先级最高）
     // EPOLLERR 表示文件描述符发生了错误
@@ -70,6 +81,7 @@ void Channel::handleEventWithGuard(Timestamp receiveTime)
     {
         if (errorCallback_)
         {
+            activity.callback.store(&errorCallback_.target_type(), std::memory_order_relaxed);
             errorCallback_();
         }
         else
@@ -85,6 +97,7 @@ void Channel::handleEventWithGuard(Timestamp receiveTime)
     {
         if (closeCallback_)
         {
+            activity.callback.store(&closeCallback_.target_type(), std::memory_order_relaxed);
             closeCallback_();
         }
         else
@@ -101,6 +114,7 @@ void Channel::handleEventWithGuard(Timestamp receiveTime)
     {
         if (readCallback_)
         {
+            activity.callback.store(&readCallback_.target_type(), std::memory_order_relaxed);
             readCallback_(receiveTime);
         }
         else
@@ -115,6 +129,7 @@ void Channel::handleEventWithGuard(Timestamp receiveTime)
     {
         if (writeCallback_)
         {
+            activity.callback.store(&writeCallback_.target_type(), std::memory_order_relaxed);
             writeCallback_();
         }
         else
@@ -2,7 +2,10 @@
 // Created by shuzeyong on 2025/5/1.
 //
 
+#define LOG_MODULE net::LogModule::kPoller
+
 #include "../include/net/EPollPoller.h"
+#include "../include/net/EventLoop.h"
 
 using namespace net;
 
@@ -53,6 +56,7 @@ Timestamp EPollPoller::poll(int timeoutMs, Poller::ChannelList *activeChannels)
         if (static_cast<size_t>(numEvents) == events_.size())
         {
             events_.resize(events_.size() * 2);// 典型 vector 扩容策略
+            ownerLoop_->metrics().eventListResizes.add();
             LOG_DEBUG("Epoll event list expanded to %zd", events_.size());
         }
     }
@@ -102,7 +106,7 @@ void EPollPoller::updateChannel(Channel *channel)
     const int fd = channel->getFd();
 
     // 打印调试信息：文件描述符、关注事件、当前状态
-    LOG_INFO("Updating channel fd=%d events=%d status=%s",
+    LOG_DEBUG("Updating channel fd=%d events=%d status=%s",
              fd, channel->getEvents(),
              (index == kNew) ? "New" : (index == kAdded) ? "Added"
                                                          : "Deleted");
@@ -171,6 +175,7 @@ void EPollPoller::update(int operation, Channel *channel) const
     event.data.ptr = channel;           // 关键设计：通过指针实现事件到对象的反向关联
 
     // 执行 epoll_ctl 系统调用
+    ownerLoop_->metrics().epollCtls.add();
     if (epoll_ctl(epollFd_, operation, fd, &event) < 0)
     {
         // 错误处理：根据操作类型区分日志级别
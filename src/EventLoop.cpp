@@ -2,6 +2,8 @@
 // Created by shuzeyong on 2025/5/1.
 //
 
+#define LOG_MODULE net::LogModule::kEventLoop
+
 #include "../include/net/EventLoop.h"
 
 using namespace net;
@@ -42,10 +44,14 @@ EventLoop::EventLoop()
     : looping_(false),
       quit_(false),
       callingPendingFunctors_(false),
+      wakeupPending_(false),
       threadId_(CurrentThread::tid()),
+      metrics_(this, threadId_),
       poller_(Poller::newDefaultPoller(this)),
       wakeupFd_(createEventfd()),
-      wakeupChannel_(new Channel(this, wakeupFd_))
+      wakeupChannel_(new Channel(this, wakeupFd_)),
+      timerQueue_(new TimerQueue(this)),
+      connectionPool_(SlabPool::create())
 {
     // 打印调试日志，包含对象地址和所属线程信息
     LOG_DEBUG("EventLoop created %p in thread %d \n", this, threadId_);
@@ -71,9 +77,14 @@ EventLoop::EventLoop()
      */
     wakeupChannel_->setReadCallback(std::bind(&EventLoop::handleRead, this));
     wakeupChannel_->enableReading();
+
+    MetricsRegistry::getInstance().registerLoop(&metrics_);
 }
 EventLoop::~EventLoop()
 {
+    // 先注销指标分片，此后看门狗不会再访问本事件循环
+    MetricsRegistry::getInstance().unregisterLoop(&metrics_);
+
     wakeupChannel_->disableAll();// 禁用所有事件监听
     wakeupChannel_->remove();    // 从poller移除
     close(wakeupFd_);            // 关闭文件描述符
@@ -85,6 +96,8 @@ void EventLoop::loop()
     // 标记事件循环开始
     looping_ = true;
     quit_ = false;
+    LoopActivity &activity = metrics_.activity;
+    activity.looping = true;
 
     LOG_INFO("%s : %p start Looping \n", __FUNCTION__, this);
 
@@ -96,21 +109,46 @@ void EventLoop::loop()
         // 核心阻塞调用：通过Poller监听I/O事件，最长阻塞kPollTimeMs(10秒)
         // 返回值pollReturnTime_用于定时器系统的时间补偿
         pollReturnTime_ = poller_->poll(kPollTimeMs, &activeChannels_);
+        int64_t dispatchStart = Timestamp::monotonicNanoseconds();
+        pollReturnMonotonic_ = Timestamp(dispatchStart / Timestamp::kNanoSecondsPerMicroSecond);
+        metrics_.iterations.add();
+        metrics_.eventsPerPoll.record(activeChannels_.size());
+
+        // 发布当前活动：看门狗据此判断事件循环是否卡在某个回调中
+        activity.busySince.store(dispatchStart, std::memory_order_relaxed);
+        activity.phase.store(LoopActivity::kIoDispatch, std::memory_order_relaxed);
 
         // 事件处理阶段：严格顺序执行所有活跃通道的回调
         // 1. 此处不允许添加/删除Channel，需通过queueInLoop延迟操作
         // 2. handleEvent可能修改Channel的监听事件状态
         for (Channel *channel: activeChannels_)
         {
+            activity.fd.store(channel->getFd(), std::memory_order_relaxed);
+            activity.callback.store(nullptr, std::memory_order_relaxed);// 具体回调由 Channel 执行前发布
             channel->handleEvent(pollReturnTime_);
         }
 
         // 异步任务执行阶段：执行所有通过queueInLoop提交的异步任务（Functor）
-        // 潜在风险：长时间任务会阻塞事件循环
+        // 潜在风险：长时间任务会阻塞事件循环（由看门狗检测）
+        int64_t functorsStart = Timestamp::monotonicNanoseconds();
+        activity.phase.store(LoopActivity::kFunctors, std::memory_order_relaxed);
+        activity.fd.store(-1, std::memory_order_relaxed);
         doPendingFunctors();
+        int64_t iterationEnd = Timestamp::monotonicNanoseconds();
+
+        activity.callback.store(nullptr, std::memory_order_relaxed);
+        activity.phase.store(LoopActivity::kPolling, std::memory_order_relaxed);
+        activity.busySince.store(0, std::memory_order_relaxed);
+
+        // 记录本轮 I/O 分发与异步任务的耗时
+        metrics_.ioDispatchNs.add(functorsStart - dispatchStart);
+        metrics_.ioDispatchUs.record((functorsStart - dispatchStart) / Timestamp::kNanoSecondsPerMicroSecond);
+        metrics_.functorsNs.add(iterationEnd - functorsStart);
+        metrics_.functorsUs.record((iterationEnd - functorsStart) / Timestamp::kNanoSecondsPerMicroSecond);
     }
 
     LOG_INFO("%s : %p stop looping \n", __FUNCTION__, this);
+    activity.looping = false;
     looping_ = false;
 }
 
@@ -172,6 +210,21 @@ void EventLoop::queueInLoop(const EventLoop::Functor &cb)
     }
     // 临界区结束：锁在此处自动释放
 
+    wakeupIfNeeded();
+}
+
+void EventLoop::queueInLoop(EventLoop::Functor &&cb)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        pendingFunctors_.emplace_back(std::move(cb));
+    }
+
+    wakeupIfNeeded();
+}
+
+void EventLoop::wakeupIfNeeded()
+{
     /*
      * 唤醒条件判断：
      * 1. 若调用者为非事件循环线程，必须唤醒事件循环线程（可能阻塞在 poll 中），确保新任务被及时处理。
@@ -181,11 +234,38 @@ void EventLoop::queueInLoop(const EventLoop::Functor &cb)
      */
     if (!isInLoopThread() || callingPendingFunctors_)
     {
-        // 调用底层唤醒机制（如eventfd写入）
-        wakeup();
+        // 合并唤醒：上一次唤醒之后事件循环还未取走任务队列，新任务会被同一批处理，无需再写 eventfd
+        // （doPendingFunctors() 在加锁取队列之前清除该标志，因此不会漏掉唤醒）
+        if (!wakeupPending_.exchange(true))
+        {
+            // 调用底层唤醒机制（如eventfd写入）
+            wakeup();
+        }
     }
 }
 
+TimerId EventLoop::runAt(Timestamp time, EventLoop::Functor cb)
+{
+    return timerQueue_->addTimer(std::move(cb),
+                                 time.microSecondsSinceEpoch() * Timestamp::kNanoSecondsPerMicroSecond, 0);
+}
+
+TimerId EventLoop::runAfter(std::chrono::nanoseconds delay, EventLoop::Functor cb)
+{
+    return timerQueue_->addTimer(std::move(cb), Timestamp::monotonicNanoseconds() + delay.count(), 0);
+}
+
+TimerId EventLoop::runEvery(std::chrono::nanoseconds interval, EventLoop::Functor cb)
+{
+    return timerQueue_->addTimer(std::move(cb), Timestamp::monotonicNanoseconds() + interval.count(),
+                                 interval.count());
+}
+
+void EventLoop::cancel(TimerId timerId)
+{
+    timerQueue_->cancel(timerId);
+}
+
 void EventLoop::wakeup() const
 {
     uint64_t one = 1;
@@ -199,11 +279,12 @@ void EventLoop::wakeup() const
     }
 }
 
-void EventLoop::handleRead() const
+void EventLoop::handleRead()
 {
     uint64_t one = 1;
     // 从 wakeupFd_ 中读取数据，预期读取 8 字节
     ssize_t n = read(wakeupFd_, &one, sizeof(one));
+    metrics_.wakeups.add();
 
     // 检查读取的字节数是否符合预期，如果不符合则记录错误日志
     if (n != sizeof(one))
@@ -216,6 +297,7 @@ void EventLoop::doPendingFunctors()
 {
     std::vector<Functor> functors;
     callingPendingFunctors_ = true;// 状态屏障：阻塞期间新任务入队不处理
+    wakeupPending_ = false;        // 此后入队的任务需要重新唤醒
 
     {// 原子交换操作：毫秒级锁定实现无锁化执行
         std::unique_lock<std::mutex> lock(mutex_);
@@ -226,8 +308,10 @@ void EventLoop::doPendingFunctors()
     // 注意：任务可能产生新的pendingFunctors_，这些新任务将在下次循环处理
     for (const Functor &functor: functors)
     {
+        metrics_.activity.callback.store(&functor.target_type(), std::memory_order_relaxed);
         functor();
     }
+    metrics_.functorsRun.add(functors.size());
 
     // 必须最后更新状态标志，保证可见性（假设存在内存屏障机制）
     callingPendingFunctors_ = false;
@@ -0,0 +1,257 @@
+//
+// Created by shuzeyong on 2025/5/16.
+//
+
+#include "../include/net/LogFile.h"
+
+#include <dirent.h>
+#include <unistd.h>
+
+using namespace net;
+
+/**
+ * @brief 获取本地时区相对 UTC 的偏移（秒）
+ * @return 偏移秒数（东八区为 28800）
+ */
+static long localGmtOffset()
+{
+    time_t now = time(nullptr);
+    tm tm_time = {};
+    localtime_r(&now, &tm_time);
+    return tm_time.tm_gmtoff;
+}
+
+LogFile::LogFile(std::string basename,
+                 off_t rollSize,
+                 bool threadSafe,
+                 int flushInterval,
+                 int checkEveryN,
+                 size_t maxFiles)
+    : basename_(std::move(basename)),
+      rollSize_(rollSize),
+      flushInterval_(flushInterval),
+      checkEveryN_(checkEveryN),
+      maxFiles_(maxFiles),
+      gmtOffset_(localGmtOffset()),
+      count_(0),
+      mutex_(threadSafe ? new std::mutex : nullptr),
+      startOfPeriod_(0),
+      lastRoll_(0),
+      lastFlush_(0),
+      fp_(nullptr),
+      writtenBytes_(0)
+{
+    if (maxFiles_ > 0)
+    {
+        scanOldFiles();
+    }
+    rollFile();
+}
+
+LogFile::~LogFile()
+{
+    if (fp_)
+    {
+        fflush(fp_);
+        fclose(fp_);
+    }
+}
+
+void LogFile::append(const char *logline, size_t len)
+{
+    if (mutex_)
+    {
+        std::unique_lock<std::mutex> lock(*mutex_);
+        appendUnlocked(logline, len);
+    }
+    else
+    {
+        appendUnlocked(logline, len);
+    }
+}
+
+void LogFile::flush()
+{
+    if (mutex_)
+    {
+        std::unique_lock<std::mutex> lock(*mutex_);
+        if (fp_)
+        {
+            fflush(fp_);
+        }
+    }
+    else if (fp_)
+    {
+        fflush(fp_);
+    }
+}
+
+void LogFile::appendUnlocked(const char *logline, size_t len)
+{
+    // 文件打开失败时丢弃日志，下次滚动时重试
+    if (fp_ == nullptr)
+    {
+        rollFile();
+        return;
+    }
+
+    // 写入 stdio 缓冲区，不加 FILE 内部锁（外层已保证互斥）
+    size_t written = 0;
+    while (written < len)
+    {
+        size_t n = fwrite_unlocked(logline + written, 1, len - written, fp_);
+        if (n == 0)
+        {
+            int err = ferror(fp_);
+            if (err)
+            {
+                fprintf(stderr, "LogFile::append() failed %s\n", strerror(err));
+            }
+            break;
+        }
+        written += n;
+    }
+    writtenBytes_ += static_cast<off_t>(written);
+
+    // 按大小滚动
+    if (writtenBytes_ > rollSize_)
+    {
+        rollFile();
+        return;
+    }
+
+    // 每写入 checkEveryN_ 次才取一次时间，检查按天滚动和定期刷新
+    if (++count_ >= checkEveryN_)
+    {
+        count_ = 0;
+        time_t now = time(nullptr);
+        if (periodOf(now) != startOfPeriod_)
+        {
+            rollFile();
+        }
+        else if (now - lastFlush_ > flushInterval_)
+        {
+            lastFlush_ = now;
+            fflush(fp_);
+        }
+    }
+}
+
+bool LogFile::rollFile()
+{
+    time_t now = time(nullptr);
+
+    // 同一秒内生成的文件名相同，不重复切换
+    if (now <= lastRoll_)
+    {
+        return false;
+    }
+    lastRoll_ = now;// 打开失败时也记录，避免每条日志都重试
+
+    std::string filename = getLogFileName(basename_, now);
+    FILE *fp = fopen(filename.c_str(), "ae");
+    if (fp == nullptr)
+    {
+        fprintf(stderr, "LogFile: open %s failed: %s\n", filename.c_str(), strerror(errno));
+        return false;
+    }
+
+    if (fp_)
+    {
+        fclose(fp_);
+    }
+    fp_ = fp;
+    setbuffer(fp_, buffer_, sizeof(buffer_));
+
+    lastFlush_ = now;
+    startOfPeriod_ = periodOf(now);
+    writtenBytes_ = 0;
+
+    files_.push_back(std::move(filename));
+    removeOldFiles();
+    return true;
+}
+
+time_t LogFile::periodOf(time_t now) const
+{
+    return (now + gmtOffset_) / kRollPerSeconds;
+}
+
+void LogFile::scanOldFiles()
+{
+    // basename 可含目录：拆成目录与文件名前缀
+    std::string dir = ".";
+    std::string prefix = basename_;
+    size_t slash = basename_.rfind('/');
+    if (slash != std::string::npos)
+    {
+        dir = slash == 0 ? "/" : basename_.substr(0, slash);
+        prefix = basename_.substr(slash + 1);
+    }
+    prefix += '.';
+
+    DIR *dirp = opendir(dir.c_str());
+    if (dirp == nullptr)
+    {
+        return;
+    }
+    std::vector<std::string> names;
+    while (dirent *entry = readdir(dirp))
+    {
+        // 只认 getLogFileName() 生成的文件名：前缀后紧跟 YYYYmmdd-HHMMSS，以 .log 结尾
+        std::string_view name(entry->d_name);
+        if (name.size() > prefix.size() + 16 && name.starts_with(prefix) && name.ends_with(".log") &&
+            isdigit(static_cast<unsigned char>(name[prefix.size()])) && name[prefix.size() + 8] == '-')
+        {
+            names.emplace_back(name);
+        }
+    }
+    closedir(dirp);
+
+    // 文件名中的时间戳定长，字典序即时间先后
+    std::sort(names.begin(), names.end());
+    std::string base = slash == std::string::npos ? std::string() : basename_.substr(0, slash + 1);
+    for (const std::string &name: names)
+    {
+        files_.push_back(base + name);
+    }
+}
+
+void LogFile::removeOldFiles()
+{
+    if (maxFiles_ == 0)
+    {
+        return;
+    }
+    while (files_.size() > maxFiles_)
+    {
+        unlink(files_.front().c_str());
+        files_.pop_front();
+    }
+}
+
+std::string LogFile::getLogFileName(const std::string &basename, time_t now)
+{
+    std::string filename;
+    filename.reserve(basename.size() + 64);
+    filename = basename;
+
+    char timebuf[32];
+    tm tm_time = {};
+    localtime_r(&now, &tm_time);
+    strftime(timebuf, sizeof(timebuf), ".%Y%m%d-%H%M%S.", &tm_time);
+    filename += timebuf;
+
+    char hostname[256] = {};
+    if (gethostname(hostname, sizeof(hostname) - 1) != 0)
+    {
+        strcpy(hostname, "unknownhost");
+    }
+    filename += hostname;
+
+    char pidbuf[32];
+    snprintf(pidbuf, sizeof(pidbuf), ".%d.log", getpid());
+    filename += pidbuf;
+
+    return filename;
+}
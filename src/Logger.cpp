@@ -5,39 +5,175 @@
 #include "../include/net/Logger.h"
 #include "../include/net/Timestamp.h"
 
+#include <cstdarg>
+
 using namespace net;
 
-Logger &Logger::getInstance()
+static_assert(static_cast<int>(LogModule::kNumModules) == 7, "update Logger::moduleLevels_ initializer");
+
+// 常量初始化，保证其他全局对象构造期间写日志时级别已就绪
+std::atomic_int Logger::moduleLevels_[static_cast<int>(LogModule::kNumModules)] = {
+        INFO, INFO, INFO, INFO, INFO, INFO, INFO};
+
+/**
+ * @brief 默认日志输出：写入 stdout
+ *
+ * 使用 fwrite 而非 std::endl，避免每行日志都触发一次刷新系统调用
+ */
+static void defaultOutput(const char *msg, size_t len)
 {
-    static Logger logger;
-    return logger;
+    fwrite(msg, 1, len, stdout);
 }
 
-void Logger::setLogLevel(int level)
+/**
+ * @brief 默认日志刷新：刷新 stdout
+ */
+static void defaultFlush()
 {
-    level_ = level;
+    fflush(stdout);
 }
 
-void Logger::log(const std::string &msg) const
+// 每个线程缓存最近一次格式化的 "YYYY/MM/DD HH:MM:SS"，同一秒内只需渲染微秒部分；
+// 按 6 个 int 字段的最大宽度预留空间（6 × 11 + 5 个分隔符 + 结尾 0），保证 snprintf 不截断
+static __thread char t_time[72];
+static __thread time_t t_lastSecond = -1;
+
+const size_t kSecondsFormatLength = 19;// "YYYY/MM/DD HH:MM:SS" 的长度
+
+/**
+ * @brief 将时间格式化为 "YYYY/MM/DD HH:MM:SS.uuuuuu"
+ *
+ * 秒级前缀按线程缓存，每秒最多调用一次 localtime_r 和 snprintf，
+ * 微秒部分逐位手工渲染
+ *
+ * @param now 当前时间
+ * @param buf 输出缓冲区，至少 26 字节
+ * @return 写入的字节数
+ */
+static size_t formatTime(Timestamp now, char *buf)
 {
-    switch (level_)
+    int64_t microSecondsSinceEpoch = now.microSecondsSinceEpoch();
+    auto seconds = static_cast<time_t>(microSecondsSinceEpoch / Timestamp::kMicroSecondsPerSecond);
+    auto microseconds = static_cast<int>(microSecondsSinceEpoch % Timestamp::kMicroSecondsPerSecond);
+
+    if (seconds != t_lastSecond)
     {
+        t_lastSecond = seconds;
+        tm tm_time = {};
+        localtime_r(&seconds, &tm_time);
+        snprintf(t_time, sizeof(t_time), "%4d/%02d/%02d %02d:%02d:%02d",
+                 tm_time.tm_year + 1900, tm_time.tm_mon + 1, tm_time.tm_mday,
+                 tm_time.tm_hour, tm_time.tm_min, tm_time.tm_sec);
+    }
+
+    memcpy(buf, t_time, kSecondsFormatLength);
+    char *p = buf + kSecondsFormatLength;
+    *p = '.';
+    for (int i = 6; i >= 1; --i)
+    {
+        p[i] = static_cast<char>('0' + microseconds % 10);
+        microseconds /= 10;
+    }
+    return kSecondsFormatLength + 7;
+}
+
+/**
+ * @brief 获取日志级别标签
+ * @param level 日志级别
+ * @return 级别标签字符串
+ */
+static const char *levelTag(int level)
+{
+    switch (level)
+    {
+        case DEBUG:
+            return "[DEBUG]";
         case INFO:
-            std::cout << "[INFO]";
-            break;
+            return "[INFO]";
         case ERROR:
-            std::cout << "[ERROR]";
-            break;
+            return "[ERROR]";
         case FATAL:
-            std::cout << "[FATAL]";
-            break;
-        case DEBUG:
-            std::cout << "[DEBUG]";
-            break;
+            return "[FATAL]";
         default:
-            break;
+            return "";
+    }
+}
+
+Logger::Logger()
+    : output_(defaultOutput),
+      flush_(defaultFlush)
+{}
+
+Logger &Logger::getInstance()
+{
+    static Logger logger;
+    return logger;
+}
+
+void Logger::setLogLevel(int level)
+{
+    for (std::atomic_int &moduleLevel: moduleLevels_)
+    {
+        moduleLevel.store(level, std::memory_order_relaxed);
     }
+}
+
+void Logger::setModuleLogLevel(LogModule module, int level)
+{
+    moduleLevels_[static_cast<int>(module)].store(level, std::memory_order_relaxed);
+}
 
-    // 打印时间和msg
-    std::cout << Timestamp::now().toString() << " : " << msg << std::endl;
+int Logger::getLogLevel(LogModule module)
+{
+    return moduleLevels_[static_cast<int>(module)].load(std::memory_order_relaxed);
+}
+
+void Logger::setOutput(Logger::OutputFunc out)
+{
+    output_ = out ? std::move(out) : OutputFunc(defaultOutput);
+}
+
+void Logger::setFlush(Logger::FlushFunc flush)
+{
+    flush_ = flush ? std::move(flush) : FlushFunc(defaultFlush);
+}
+
+void Logger::log(int level, const char *fmt, ...) const
+{
+    // 整行在栈上拼接：级别 + 时间 + " : " + 消息 + 换行，一次性交给输出端
+    char buf[1024 + 64];
+    size_t len = 0;
+
+    auto appendStr = [&](const char *s, size_t n) {
+        n = std::min(n, sizeof(buf) - 1 - len);
+        memcpy(buf + len, s, n);
+        len += n;
+    };
+
+    const char *tag = levelTag(level);
+    appendStr(tag, strlen(tag));
+    len += formatTime(Timestamp::now(), buf + len);
+    appendStr(" : ", 3);
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + len, sizeof(buf) - 1 - len, fmt, args);
+    va_end(args);
+    if (n > 0)
+    {
+        len += std::min(static_cast<size_t>(n), sizeof(buf) - 2 - len);
+    }
+
+    // 调用方常以 "\n" 结尾，避免输出空行
+    if (buf[len - 1] != '\n')
+    {
+        buf[len++] = '\n';
+    }
+    output_(buf, len);
+
+    // FATAL 之后进程会退出，必须保证日志落盘
+    if (level == FATAL)
+    {
+        flush_();
+    }
 }
@@ -0,0 +1,175 @@
+//
+// Created by shuzeyong on 2025/5/25.
+//
+
+#define LOG_MODULE net::LogModule::kEventLoop
+
+#include "../include/net/LoopWatchdog.h"
+#include "../include/net/EventLoop.h"
+#include "../include/net/Logger.h"
+
+#include <cxxabi.h>
+#include <execinfo.h>
+
+using namespace net;
+
+namespace
+{
+    /**
+     * @brief 将类型名还原为可读形式，失败时返回原始名称
+     */
+    std::string demangle(const char *name)
+    {
+        int status = 0;
+        char *readable = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        if (status != 0 || readable == nullptr)
+        {
+            return name;
+        }
+        std::string result(readable);
+        free(readable);
+        return result;
+    }
+}// namespace
+
+LoopWatchdog::LoopWatchdog(std::chrono::milliseconds threshold, std::chrono::milliseconds interval)
+    : thresholdNs_(std::chrono::duration_cast<std::chrono::nanoseconds>(threshold).count()),
+      interval_(interval.count() > 0 ? interval : std::max(threshold / 2, std::chrono::milliseconds(1))),
+      backtraceSignal_(0),
+      running_(false)
+{
+}
+
+LoopWatchdog::~LoopWatchdog()
+{
+    stop();
+}
+
+void LoopWatchdog::start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_)
+    {
+        running_ = true;
+        thread_ = std::thread([this] { run(); });
+    }
+}
+
+void LoopWatchdog::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cond_.notify_all();
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+void LoopWatchdog::enableBacktrace(int signo)
+{
+    // 预先调用一次 backtrace：首次调用会加载 libgcc，不能发生在信号处理函数中
+    void *frame;
+    ::backtrace(&frame, 1);
+
+    struct sigaction sa = {};
+    sa.sa_handler = &LoopWatchdog::backtraceHandler;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(signo, &sa, nullptr) < 0)
+    {
+        LOG_ERROR("LoopWatchdog::enableBacktrace sigaction(%d) error:%d", signo, errno);
+        return;
+    }
+    backtraceSignal_ = signo;
+}
+
+void LoopWatchdog::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_)
+    {
+        cond_.wait_for(lock, interval_, [this] { return !running_; });
+        if (!running_)
+        {
+            break;
+        }
+        lock.unlock();
+        check();
+        lock.lock();
+    }
+}
+
+void LoopWatchdog::check()
+{
+    std::unordered_map<LoopMetrics *, int64_t> reported;
+    int64_t now = Timestamp::monotonicNanoseconds();
+
+    MetricsRegistry::getInstance().forEachLoop([&](LoopMetrics &metrics) {
+        LoopActivity &activity = metrics.activity;
+        if (!activity.looping.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        // 卡顿检测：本轮事件处理持续超过阈值，且这次卡顿尚未报告过
+        int64_t busySince = activity.busySince.load(std::memory_order_relaxed);
+        if (busySince != 0 && now - busySince >= thresholdNs_)
+        {
+            auto it = reported_.find(&metrics);
+            if (it == reported_.end() || it->second != busySince)
+            {
+                reportStall(metrics, now - busySince);
+            }
+            reported[&metrics] = busySince;
+        }
+
+        // 延迟测量：探测任务在事件循环线程中记录入队到执行的延迟
+        if (!activity.probePending.exchange(true, std::memory_order_relaxed))
+        {
+            LoopMetrics *target = &metrics;
+            int64_t queued = Timestamp::monotonicNanoseconds();
+            metrics.loop->queueInLoop([target, queued] {
+                int64_t lagNs = Timestamp::monotonicNanoseconds() - queued;
+                target->lagUs.record(lagNs / Timestamp::kNanoSecondsPerMicroSecond);
+                target->activity.probePending.store(false, std::memory_order_relaxed);
+            });
+        }
+    });
+
+    // 只保留仍在卡顿中的记录，已退出的事件循环随之清除
+    reported_.swap(reported);
+}
+
+void LoopWatchdog::reportStall(LoopMetrics &metrics, int64_t stalledNs) const
+{
+    const LoopActivity &activity = metrics.activity;
+    int phase = activity.phase.load(std::memory_order_relaxed);
+    int fd = activity.fd.load(std::memory_order_relaxed);
+    const std::type_info *callback = activity.callback.load(std::memory_order_relaxed);
+    std::string site = callback ? demangle(callback->name()) : std::string("-");
+
+    LOG_ERROR("EventLoop %p in thread %d stalled for %ld ms in %s, fd=%d, callback=%s",
+              metrics.loop, metrics.tid, stalledNs / 1000000,
+              phase == LoopActivity::kFunctors ? "pending functors" : "I/O dispatch",
+              fd, site.c_str());
+    metrics.stalls.add();
+
+    if (backtraceSignal_ != 0)
+    {
+        ::syscall(SYS_tgkill, ::getpid(), metrics.tid, backtraceSignal_);
+    }
+}
+
+void LoopWatchdog::backtraceHandler(int)
+{
+    static const char kHeader[] = "LoopWatchdog: backtrace of stalled EventLoop thread:\n";
+    void *frames[64];
+
+    ssize_t n = ::write(STDERR_FILENO, kHeader, sizeof(kHeader) - 1);
+    (void) n;
+    int depth = ::backtrace(frames, 64);
+    ::backtrace_symbols_fd(frames, depth, STDERR_FILENO);
+}
@@ -1,9 +1,17 @@
 #include "../include/net/MenoryPool.h"
 
-NgxMemPool::NgxMemPool(size_t size)
+#include <cstdio>
+
+NgxMemPool::NgxMemPool(size_t size, NgxBlockSource *source)
+    : _source(source),
+      _freeLargeNodes(nullptr),
+      _freeLarge{},
+      _freeLargeBytes(0),
+      _stats{}
 {
     // 分配内存池，确保分配的大小不小于 NGX_MIN_POOL_SIZE
-    _pool = static_cast<NgxPool_t *>(malloc(size > NGX_MIN_POOL_SIZE ? size : NGX_MIN_POOL_SIZE));
+    size = size > NGX_MIN_POOL_SIZE ? size : NGX_MIN_POOL_SIZE;
+    _pool = static_cast<NgxPool_t *>(_source->allocate(size));
     if (_pool == nullptr)
     {
         /*日志*/
@@ -41,19 +49,33 @@ NgxMemPool::~NgxMemPool()
         }
     }
 
+    // 调试模式下检查仍在使用的分配是否越界
+    verifyGuards();
+
     // 遍历并释放所有大内存块
     for (l = _pool->large; l; l = l->next)
     {
         if (l->alloc)
         {
-            free(l->alloc);// 释放大内存块
+            _source->deallocate(l->alloc, l->size);// 释放大内存块
+        }
+    }
+
+    // 释放所有缓存中的空闲大内存块
+    for (int i = 0; i < NGX_LARGE_CLASS_COUNT; ++i)
+    {
+        while (_freeLarge[i])
+        {
+            NgxPoolFreeLarge_t *next = _freeLarge[i]->next;
+            _source->deallocate(_freeLarge[i], largeClassSize(i));
+            _freeLarge[i] = next;
         }
     }
 
     // 遍历并释放内存池中的所有内存块
     for (p = _pool, n = _pool->d.next; /* void */; p = n, n = n->d.next)
     {
-        free(p);// 释放当前内存块
+        _source->deallocate(p, (size_t) (p->d.end - (u_char *) p));// 释放当前内存块
 
         if (n == nullptr)
         {
@@ -67,15 +89,38 @@ void NgxMemPool::resetPool()
 {
     NgxPool_t *p;
     NgxPoolLarge_t *l;
+    NgxPoolCleanup_t *c;
+
+    // 清理操作节点位于小块内存中，重置后会被覆盖，需先执行并清空
+    for (c = _pool->cleanup; c; c = c->next)
+    {
+        if (c->handler)
+        {
+            c->handler(c->data);
+        }
+    }
+    _pool->cleanup = nullptr;
 
-    // 遍历并释放所有大块内存
+#if NGX_POOL_DEBUG
+    // 检查越界后填充已回收的内存，重置后仍通过旧指针访问时更容易暴露
+    verifyGuards();
+    for (const NgxPoolDebugAlloc_t &a: _debugAllocs)
+    {
+        memset(a.p, NGX_POOL_POISON_FREE, a.size + NGX_POOL_GUARD_SIZE);
+    }
+    _debugAllocs.clear();
+#endif
+
+    // 回收所有大块内存：按规格放入空闲链表，供下一轮请求复用
     for (l = _pool->large; l; l = l->next)
     {
         if (l->alloc)
         {
-            free(l->alloc);
+            releaseLarge(l->alloc, l->size);
         }
     }
+    // 跟踪节点位于小块内存中，重置后会被覆盖
+    _freeLargeNodes = nullptr;
 
     // 重置第一块内存池的状态
     p = _pool;
@@ -92,31 +137,60 @@ void NgxMemPool::resetPool()
     // 将当前内存池指针重置为第一块内存池，并清空大块内存链表
     _pool->current = _pool;
     _pool->large = nullptr;
+
+    ++_stats.resets;
+    _stats.smallRequestedBytes = 0;
 }
 
 
 void *NgxMemPool::palloc(size_t size)
 {
-    // 判断请求的内存大小是否小于或等于小块内存的最大大小
-    if (size <= _pool->max)
-    {
-        // 从小块内存池中分配内存
-        return pallocSmall(size, true);
-    }
-    // 从大块内存池中分配内存
-    return pallocLarge(size);
+    // 分配对齐的内存
+    return allocate(size, true);
 }
 
 void *NgxMemPool::pnalloc(size_t size)
 {
-    // 检查请求的内存大小是否小于或等于内存池的最大小块大小
-    if (size <= _pool->max)
+    // 分配不对齐的内存（大块内存本身总是对齐的）
+    return allocate(size, false);
+}
+
+void *NgxMemPool::allocate(size_t size, bool align)
+{
+    void *p;
+
+    // 判断请求的内存大小是否小于或等于小块内存的最大大小（调试模式下已扣除保护字节）
+    if (size <= smallMax())
+    {
+        // 从小块内存池中分配内存，保护字节与请求一起分配，保证不越过内存块末尾
+        p = pallocSmall(size + NGX_POOL_GUARD_SIZE, align);
+        if (p)
+        {
+            ++_stats.smallAllocs;
+            _stats.smallRequestedBytes += size;
+        }
+    }
+    else
+    {
+        // 从大块内存池中分配内存
+        p = pallocLarge(size + NGX_POOL_GUARD_SIZE);
+        if (p)
+        {
+            ++_stats.largeAllocs;
+        }
+    }
+
+#if NGX_POOL_DEBUG
+    if (p)
     {
-        // 从小块内存池中分配内存，不进行内存对齐
-        return pallocSmall(size, false);
+        auto *m = (u_char *) p;
+        memset(m, NGX_POOL_POISON_ALLOC, size);
+        memset(m + size, NGX_POOL_GUARD_BYTE, NGX_POOL_GUARD_SIZE);
+        _debugAllocs.push_back({m, size});
     }
-    // 从大块内存池中分配内存
-    return pallocLarge(size);
+#endif
+
+    return p;
 }
 
 void *NgxMemPool::pcalloc(size_t size)
@@ -171,52 +245,106 @@ void *NgxMemPool::pallocSmall(size_t size, bool align)
 void *NgxMemPool::pallocLarge(size_t size)
 {
     void *p;
-    u_int n;
     NgxPoolLarge_t *large;
 
-    // 使用标准库的 malloc 函数分配内存
-    p = malloc(size);
-    if (p == nullptr)
+    // 按规格向上取整；同规格有空闲的大内存块时直接复用，否则向内存来源申请
+    int index = largeClassIndex(size);
+    size_t blockSize = index >= 0 ? largeClassSize(index) : size;
+    if (index >= 0 && _freeLarge[index])
     {
-        return nullptr;
+        p = _freeLarge[index];
+        _freeLarge[index] = _freeLarge[index]->next;
+        _freeLargeBytes -= blockSize;
+        ++_stats.largeCacheHits;
     }
-
-    n = 0;
-
-    // 遍历大内存块链表，查找是否有空闲的节点
-    for (large = _pool->large; large; large = large->next)
+    else
     {
-        if (large->alloc == nullptr)
+        p = _source->allocate(blockSize);
+        if (p == nullptr)
         {
-            // 找到空闲节点，将分配的内存块挂载到该节点
-            large->alloc = p;
-            return p;
-        }
-
-        // 如果遍历的节点数超过 3 个，则跳出循环
-        if (n++ > 3)
-        {
-            break;
+            return nullptr;
         }
     }
 
-    // 分配一个新的节点并将其插入到链表头部
-    large = (NgxPoolLarge_t *) pallocSmall(sizeof(NgxPoolLarge_t), true);
+    // 获取跟踪节点并插入到链表头部
+    large = getLargeNode();
     if (large == nullptr)
     {
-        // 如果节点分配失败，则释放之前分配的内存块
-        free(p);
+        // 如果节点分配失败，则回收之前分配的内存块
+        releaseLarge(p, blockSize);
         return nullptr;
     }
 
-    // 将新节点插入到链表头部，并挂载分配的内存块
     large->alloc = p;
+    large->size = blockSize;
     large->next = _pool->large;
     _pool->large = large;
 
     return p;
 }
 
+NgxPoolLarge_t *NgxMemPool::getLargeNode()
+{
+    // 优先复用 pfree 归还的节点，避免节点随大块内存的分配释放不断占用小块内存
+    if (_freeLargeNodes)
+    {
+        NgxPoolLarge_t *large = _freeLargeNodes;
+        _freeLargeNodes = large->next;
+        return large;
+    }
+    return (NgxPoolLarge_t *) pallocSmall(sizeof(NgxPoolLarge_t), true);
+}
+
+void NgxMemPool::releaseLarge(void *p, size_t size)
+{
+    // 不按规格缓存，或缓存总量已达上限时直接归还内存来源
+    int index = largeClassIndex(size);
+    if (index < 0 || _freeLargeBytes + size > NGX_LARGE_CACHE_MAX)
+    {
+        _source->deallocate(p, size);
+        return;
+    }
+
+    auto *block = (NgxPoolFreeLarge_t *) p;
+    block->next = _freeLarge[index];
+    _freeLarge[index] = block;
+    _freeLargeBytes += size;
+}
+
+int NgxMemPool::largeClassIndex(size_t size)
+{
+    if (size < NGX_LARGE_CLASS_MIN || size > NGX_LARGE_CLASS_MAX)
+    {
+        return -1;
+    }
+    if (size == NGX_LARGE_CLASS_MIN)
+    {
+        return 0;
+    }
+
+    // 与最小规格的 2 的幂距离决定区间，最高位之后的 NGX_LARGE_CLASS_STEP_BITS 位决定区间内的档位
+    const int minBits = __builtin_ctzll(NGX_LARGE_CLASS_MIN);
+    size_t v = size - 1;
+    int msb = 63 - __builtin_clzll(v);
+    int shift = msb - NGX_LARGE_CLASS_STEP_BITS;
+    int sub = (int) (v >> shift) & ((1 << NGX_LARGE_CLASS_STEP_BITS) - 1);
+    return (msb - minBits) * (1 << NGX_LARGE_CLASS_STEP_BITS) + sub + 1;
+}
+
+size_t NgxMemPool::largeClassSize(int index)
+{
+    if (index == 0)
+    {
+        return NGX_LARGE_CLASS_MIN;
+    }
+
+    const int minBits = __builtin_ctzll(NGX_LARGE_CLASS_MIN);
+    int group = (index - 1) >> NGX_LARGE_CLASS_STEP_BITS;
+    int sub = (index - 1) & ((1 << NGX_LARGE_CLASS_STEP_BITS) - 1);
+    int shift = group + minBits - NGX_LARGE_CLASS_STEP_BITS;
+    return (size_t) ((1 << NGX_LARGE_CLASS_STEP_BITS) + sub + 1) << shift;
+}
+
 void *NgxMemPool::pallocBlock(size_t size)
 {
     u_char *m;
@@ -227,7 +355,7 @@ void *NgxMemPool::pallocBlock(size_t size)
     psize = (size_t) (_pool->d.end - (u_char *) _pool);
 
     // 分配一个新的内存池
-    m = (u_char *) malloc(psize);
+    m = (u_char *) _source->allocate(psize);
     if (m == nullptr)
     {
         return nullptr;
@@ -243,6 +371,7 @@ void *NgxMemPool::pallocBlock(size_t size)
     m += sizeof(NgxPoolData_t);
     m = ngx_align_ptr(m, NGX_ALIGNMENT);
     newPool->d.last = m + size;
+    ++_stats.blockAllocs;
 
     // 遍历内存池链表，更新 current 指针
     for (p = _pool->current; p->d.next; p = p->d.next)
@@ -250,6 +379,7 @@ void *NgxMemPool::pallocBlock(size_t size)
         if (p->d.failed++ > 4)
         {
             _pool->current = p->d.next;
+            ++_stats.currentSkips;
         }
     }
 
@@ -290,6 +420,83 @@ NgxPoolCleanup_t *NgxMemPool::cleanupAdd(size_t size)
     return c;
 }
 
+size_t NgxMemPool::smallMax() const
+{
+    return _pool->max - NGX_POOL_GUARD_SIZE;
+}
+
+NgxPoolStats_t NgxMemPool::stats() const
+{
+    NgxPoolStats_t s = _stats;
+
+    // 遍历内存块：current 之前的块已被跳过，其剩余空间不会再被使用
+    bool skipped = true;
+    for (NgxPool_t *p = _pool; p; p = p->d.next)
+    {
+        u_char *start = (u_char *) p + (p == _pool ? sizeof(NgxPool_t) : sizeof(NgxPoolData_t));
+        if (p == _pool->current)
+        {
+            skipped = false;
+        }
+
+        ++s.blocks;
+        s.blockBytes += (size_t) (p->d.end - (u_char *) p);
+        s.smallUsedBytes += (size_t) (p->d.last - start);
+        if (skipped)
+        {
+            ++s.skippedBlocks;
+            s.skippedFreeBytes += (size_t) (p->d.end - p->d.last);
+        }
+        else
+        {
+            s.smallFreeBytes += (size_t) (p->d.end - p->d.last);
+        }
+    }
+
+    // 遍历仍在使用的大块内存
+    for (NgxPoolLarge_t *l = _pool->large; l; l = l->next)
+    {
+        if (l->alloc)
+        {
+            ++s.largeLive;
+            s.largeLiveBytes += l->size;
+        }
+    }
+    s.largeCachedBytes = _freeLargeBytes;
+
+    return s;
+}
+
+bool NgxMemPool::guardIntact(const NgxPoolDebugAlloc_t &a) const
+{
+    for (size_t i = 0; i < NGX_POOL_GUARD_SIZE; ++i)
+    {
+        if (a.p[a.size + i] != NGX_POOL_GUARD_BYTE)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t NgxMemPool::verifyGuards()
+{
+    size_t corrupted = 0;
+#if NGX_POOL_DEBUG
+    for (const NgxPoolDebugAlloc_t &a: _debugAllocs)
+    {
+        if (!guardIntact(a))
+        {
+            ++corrupted;
+            fprintf(stderr, "NgxMemPool %p: guard bytes after %p (size %zu) overwritten\n",
+                    (void *) this, (void *) a.p, a.size);
+        }
+    }
+    _stats.guardViolations += corrupted;
+#endif
+    return corrupted;
+}
+
 void NgxMemPool::pfree(void *p)
 {
     NgxPoolLarge_t *prev = nullptr;  // 用于记录当前节点的前一个节点
@@ -300,19 +507,44 @@ void NgxMemPool::pfree(void *p)
     {
         if (p == l->alloc)
         {
-            free(l->alloc);    // 释放内存块
-            l->alloc = nullptr;// 将指针置为空，防止悬空指针
-
-            // 如果当前节点不是链表头节点，则将其移动到链表头部
+            // 从链表中摘除节点，链表中只保留仍在使用的大内存块
             if (prev)
             {
-                prev->next = l->next;  // 将前一个节点的 next 指向当前节点的下一个节点
-                l->next = _pool->large;// 将当前节点的 next 指向链表头节点
-                _pool->large = l;      // 将链表头节点更新为当前节点
+                prev->next = l->next;
+            }
+            else
+            {
+                _pool->large = l->next;
             }
+
+#if NGX_POOL_DEBUG
+            // 检查越界并填充已释放的内存，移除分配记录
+            for (auto it = _debugAllocs.begin(); it != _debugAllocs.end(); ++it)
+            {
+                if (it->p == p)
+                {
+                    if (!guardIntact(*it))
+                    {
+                        ++_stats.guardViolations;
+                        fprintf(stderr, "NgxMemPool %p: guard bytes after %p (size %zu) overwritten\n",
+                                (void *) this, p, it->size);
+                    }
+                    memset(it->p, NGX_POOL_POISON_FREE, it->size + NGX_POOL_GUARD_SIZE);
+                    _debugAllocs.erase(it);
+                    break;
+                }
+            }
+#endif
+
+            // 内存块按规格缓存等待复用，节点放入空闲节点链表
+            ++_stats.largeFrees;
+            releaseLarge(l->alloc, l->size);
+            l->alloc = nullptr;
+            l->next = _freeLargeNodes;
+            _freeLargeNodes = l;
             return;// 内存块已释放，函数返回
         }
         prev = l;   // 更新前一个节点为当前节点
         l = l->next;// 移动到下一个节点
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,158 @@
+//
+// Created by shuzeyong on 2025/5/24.
+//
+
+#include "../include/net/Metrics.h"
+
+using namespace net;
+
+void LoopMetricsSnapshot::merge(const LoopMetricsSnapshot &other)
+{
+    iterations += other.iterations;
+    functorsRun += other.functorsRun;
+    wakeups += other.wakeups;
+    eventsPerPoll.merge(other.eventsPerPoll);
+    ioDispatchNs += other.ioDispatchNs;
+    functorsNs += other.functorsNs;
+    ioDispatchUs.merge(other.ioDispatchUs);
+    functorsUs.merge(other.functorsUs);
+    lagUs.merge(other.lagUs);
+    stalls += other.stalls;
+    epollCtls += other.epollCtls;
+    eventListResizes += other.eventListResizes;
+    bytesRead += other.bytesRead;
+    bytesWritten += other.bytesWritten;
+    eagain += other.eagain;
+    bufferBytes += other.bufferBytes;
+    outputPending += other.outputPending;
+    accepts += other.accepts;
+    activeConnections += other.activeConnections;
+    memPools += other.memPools;
+    memPoolSmallAllocs += other.memPoolSmallAllocs;
+    memPoolLargeAllocs += other.memPoolLargeAllocs;
+    memPoolLargeCacheHits += other.memPoolLargeCacheHits;
+    memPoolBlockAllocs += other.memPoolBlockAllocs;
+    memPoolCurrentSkips += other.memPoolCurrentSkips;
+    memPoolResets += other.memPoolResets;
+    memPoolGuardViolations += other.memPoolGuardViolations;
+    memPoolFootprint.merge(other.memPoolFootprint);
+    memPoolWaste.merge(other.memPoolWaste);
+}
+
+LoopMetrics::LoopMetrics(EventLoop *loop, pid_t tid)
+    : loop(loop),
+      tid(tid)
+{
+}
+
+void LoopMetrics::snapshotInto(LoopMetricsSnapshot &snapshot) const
+{
+    snapshot.iterations += iterations.value();
+    snapshot.functorsRun += functorsRun.value();
+    snapshot.wakeups += wakeups.value();
+    eventsPerPoll.snapshotInto(snapshot.eventsPerPoll);
+    snapshot.ioDispatchNs += ioDispatchNs.value();
+    snapshot.functorsNs += functorsNs.value();
+    ioDispatchUs.snapshotInto(snapshot.ioDispatchUs);
+    functorsUs.snapshotInto(snapshot.functorsUs);
+    lagUs.snapshotInto(snapshot.lagUs);
+    snapshot.stalls += stalls.value();
+    snapshot.epollCtls += epollCtls.value();
+    snapshot.eventListResizes += eventListResizes.value();
+    snapshot.bytesRead += bytesRead.value();
+    snapshot.bytesWritten += bytesWritten.value();
+    snapshot.eagain += eagain.value();
+    snapshot.bufferBytes += bufferBytes.value();
+    snapshot.outputPending += outputPending.value();
+    snapshot.accepts += accepts.value();
+    snapshot.activeConnections += activeConnections.value();
+    snapshot.memPools += memPools.value();
+    snapshot.memPoolSmallAllocs += memPoolSmallAllocs.value();
+    snapshot.memPoolLargeAllocs += memPoolLargeAllocs.value();
+    snapshot.memPoolLargeCacheHits += memPoolLargeCacheHits.value();
+    snapshot.memPoolBlockAllocs += memPoolBlockAllocs.value();
+    snapshot.memPoolCurrentSkips += memPoolCurrentSkips.value();
+    snapshot.memPoolResets += memPoolResets.value();
+    snapshot.memPoolGuardViolations += memPoolGuardViolations.value();
+    memPoolFootprint.snapshotInto(snapshot.memPoolFootprint);
+    memPoolWaste.snapshotInto(snapshot.memPoolWaste);
+}
+
+void LoopMetrics::publishMemPool(const NgxPoolStats_t &stats, NgxPoolStats_t &published)
+{
+    // 累计计数只发布增量，同一个内存池可以多次发布
+    memPoolSmallAllocs.add(stats.smallAllocs - published.smallAllocs);
+    memPoolLargeAllocs.add(stats.largeAllocs - published.largeAllocs);
+    memPoolLargeCacheHits.add(stats.largeCacheHits - published.largeCacheHits);
+    memPoolBlockAllocs.add(stats.blockAllocs - published.blockAllocs);
+    memPoolCurrentSkips.add(stats.currentSkips - published.currentSkips);
+    memPoolResets.add(stats.resets - published.resets);
+    memPoolGuardViolations.add(stats.guardViolations - published.guardViolations);
+
+    // 占用情况反映一轮请求（两次重置之间）的内存需求，用于调整内存池大小
+    memPoolFootprint.record(stats.blockBytes + stats.largeLiveBytes);
+    memPoolWaste.record(stats.skippedFreeBytes);
+    published = stats;
+}
+
+MetricsRegistry &MetricsRegistry::getInstance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+void MetricsRegistry::registerLoop(LoopMetrics *metrics)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    loops_.push_back(metrics);
+}
+
+void MetricsRegistry::unregisterLoop(LoopMetrics *metrics)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find(loops_.begin(), loops_.end(), metrics);
+    if (it != loops_.end())
+    {
+        metrics->snapshotInto(retired_);
+        loops_.erase(it);
+    }
+}
+
+LoopMetricsSnapshot MetricsRegistry::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    LoopMetricsSnapshot total = retired_;
+    for (const LoopMetrics *metrics: loops_)
+    {
+        metrics->snapshotInto(total);
+    }
+    return total;
+}
+
+std::vector<LoopMetricsSnapshot> MetricsRegistry::snapshotLoops() const
+{
+    std::vector<LoopMetricsSnapshot> result;
+    snapshotLoops(result);
+    return result;
+}
+
+void MetricsRegistry::snapshotLoops(std::vector<LoopMetricsSnapshot> &out) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    out.resize(loops_.size());
+    for (size_t i = 0; i < loops_.size(); ++i)
+    {
+        out[i] = LoopMetricsSnapshot();
+        out[i].tid = loops_[i]->tid;
+        loops_[i]->snapshotInto(out[i]);
+    }
+}
+
+void MetricsRegistry::forEachLoop(const std::function<void(LoopMetrics &)> &func)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (LoopMetrics *metrics: loops_)
+    {
+        func(*metrics);
+    }
+}
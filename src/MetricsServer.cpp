@@ -0,0 +1,308 @@
+//
+// Created by shuzeyong on 2025/5/26.
+//
+
+#define LOG_MODULE net::LogModule::kTcpServer
+
+#include "../include/net/MetricsServer.h"
+
+#include <cstdarg>
+
+using namespace net;
+
+namespace
+{
+    /**
+     * @brief 格式化一行（不超过 256 字节）并追加到缓冲区，不分配内存
+     */
+    __attribute__((format(printf, 2, 3))) void appendf(Buffer *buf, const char *fmt, ...)
+    {
+        char line[256];
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(line, sizeof(line), fmt, args);
+        va_end(args);
+        if (n > 0)
+        {
+            buf->append(line, std::min(static_cast<size_t>(n), sizeof(line) - 1));
+        }
+    }
+
+    /**
+     * @brief 输出指标族的 HELP 与 TYPE 行
+     */
+    void appendFamily(Buffer *buf, const char *name, const char *help, const char *type)
+    {
+        appendf(buf, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    }
+
+    /**
+     * @brief 输出一个直方图：HDR 细分桶按 2 的幂区间合并为累积桶
+     *
+     * 每个序列都输出同一组固定的 le 边界（2^k - 1，k = 0 ~ HISTOGRAM_MAX_BITS - 1），
+     * 不因样本分布而增减，保证跨抓取、跨序列可以直接 histogram_quantile / sum by (le)；
+     * 最后一个 HDR 桶同时容纳超出范围的值，只计入 +Inf
+     */
+    void appendHistogram(Buffer *buf, const char *name, const char *labels, const thp::HistogramSnapshot &h)
+    {
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i + 1 < thp::HISTOGRAM_BUCKET_COUNT; ++i)
+        {
+            cumulative += h.buckets[i];
+            uint64_t upper = thp::HistogramSnapshot::bucketUpperBound(i);
+            if ((upper & (upper + 1)) == 0)
+            {
+                appendf(buf, "%s_bucket{%s,le=\"%lu\"} %lu\n", name, labels, upper, cumulative);
+            }
+        }
+        cumulative += h.buckets[thp::HISTOGRAM_BUCKET_COUNT - 1];
+        // 快照各字段之间不严格一致，取较大值保证累积桶单调
+        uint64_t total = std::max(cumulative, h.count);
+        appendf(buf, "%s_bucket{%s,le=\"+Inf\"} %lu\n", name, labels, total);
+        appendf(buf, "%s_sum{%s} %lu\n", name, labels, h.sum);
+        appendf(buf, "%s_count{%s} %lu\n", name, labels, total);
+    }
+
+    /**
+     * @brief 大小写不敏感的子串查找
+     */
+    bool containsIgnoreCase(std::string_view text, std::string_view pattern)
+    {
+        auto it = std::search(text.begin(), text.end(), pattern.begin(), pattern.end(),
+                              [](char a, char b) { return tolower(a) == tolower(b); });
+        return it != text.end();
+    }
+
+    struct CounterFamily
+    {
+        const char *name;
+        const char *help;
+        uint64_t LoopMetricsSnapshot::*field;
+    };
+
+    struct GaugeFamily
+    {
+        const char *name;
+        const char *help;
+        int64_t LoopMetricsSnapshot::*field;
+    };
+
+    struct HistogramFamily
+    {
+        const char *name;
+        const char *help;
+        thp::HistogramSnapshot LoopMetricsSnapshot::*field;
+    };
+
+    const CounterFamily kLoopCounters[] = {
+            {"muduo_loop_iterations_total", "Event loop iterations.", &LoopMetricsSnapshot::iterations},
+            {"muduo_loop_functors_total", "Pending functors run by the event loop.", &LoopMetricsSnapshot::functorsRun},
+            {"muduo_loop_wakeups_total", "Wakeup events handled by the event loop.", &LoopMetricsSnapshot::wakeups},
+            {"muduo_loop_io_dispatch_nanoseconds_total", "Time spent dispatching I/O events.", &LoopMetricsSnapshot::ioDispatchNs},
+            {"muduo_loop_functors_nanoseconds_total", "Time spent running pending functors.", &LoopMetricsSnapshot::functorsNs},
+            {"muduo_loop_stalls_total", "Stalls detected by the loop watchdog.", &LoopMetricsSnapshot::stalls},
+            {"muduo_poller_epoll_ctl_total", "epoll_ctl calls.", &LoopMetricsSnapshot::epollCtls},
+            {"muduo_poller_event_list_resizes_total", "epoll event list resizes.", &LoopMetricsSnapshot::eventListResizes},
+            {"muduo_connection_read_bytes_total", "Bytes read from connections.", &LoopMetricsSnapshot::bytesRead},
+            {"muduo_connection_written_bytes_total", "Bytes written to connections.", &LoopMetricsSnapshot::bytesWritten},
+            {"muduo_connection_eagain_total", "Reads and writes that hit EAGAIN.", &LoopMetricsSnapshot::eagain},
+            {"muduo_server_accepts_total", "Connections accepted.", &LoopMetricsSnapshot::accepts},
+            {"muduo_mempool_small_allocs_total", "Small allocations from connection memory pools.", &LoopMetricsSnapshot::memPoolSmallAllocs},
+            {"muduo_mempool_large_allocs_total", "Large allocations from connection memory pools.", &LoopMetricsSnapshot::memPoolLargeAllocs},
+            {"muduo_mempool_large_cache_hits_total", "Large allocations served from the size-class cache.", &LoopMetricsSnapshot::memPoolLargeCacheHits},
+            {"muduo_mempool_block_allocs_total", "New memory pool blocks allocated.", &LoopMetricsSnapshot::memPoolBlockAllocs},
+            {"muduo_mempool_current_skips_total", "Memory pool blocks skipped by the current pointer.", &LoopMetricsSnapshot::memPoolCurrentSkips},
+            {"muduo_mempool_resets_total", "Memory pool resets.", &LoopMetricsSnapshot::memPoolResets},
+            {"muduo_mempool_guard_violations_total", "Guard byte overwrites detected in debug mode.", &LoopMetricsSnapshot::memPoolGuardViolations},
+    };
+
+    const GaugeFamily kLoopGauges[] = {
+            {"muduo_server_active_connections", "Connections currently open.", &LoopMetricsSnapshot::activeConnections},
+            {"muduo_buffer_allocated_bytes", "Bytes allocated by connection buffers.", &LoopMetricsSnapshot::bufferBytes},
+            {"muduo_buffer_output_pending_bytes", "Bytes waiting in connection output buffers.", &LoopMetricsSnapshot::outputPending},
+            {"muduo_mempool_pools", "Connection memory pools currently alive.", &LoopMetricsSnapshot::memPools},
+    };
+
+    const HistogramFamily kLoopHistograms[] = {
+            {"muduo_loop_events_per_poll", "Events returned by each poll.", &LoopMetricsSnapshot::eventsPerPoll},
+            {"muduo_loop_io_dispatch_microseconds", "I/O dispatch time per loop iteration.", &LoopMetricsSnapshot::ioDispatchUs},
+            {"muduo_loop_functors_microseconds", "Pending functor time per loop iteration.", &LoopMetricsSnapshot::functorsUs},
+            {"muduo_loop_lag_microseconds", "Delay between queueing a watchdog probe and running it.", &LoopMetricsSnapshot::lagUs},
+            {"muduo_mempool_footprint_bytes", "Memory pool footprint at each reset.", &LoopMetricsSnapshot::memPoolFootprint},
+            {"muduo_mempool_waste_bytes", "Free space left in skipped memory pool blocks at each reset.", &LoopMetricsSnapshot::memPoolWaste},
+    };
+}// namespace
+
+MetricsServer::MetricsServer(EventLoop *loop, const InetAddress &listenAddr, std::string name)
+    : server_(loop, listenAddr, std::move(name))
+{
+    server_.setMessageCallback([this](const TcpConnectionPtr &conn, Buffer *buf, Timestamp receiveTime) {
+        onMessage(conn, buf, receiveTime);
+    });
+}
+
+void MetricsServer::start()
+{
+    server_.start();
+}
+
+void MetricsServer::addThreadPool(std::string name, thp::ThreadPool *pool)
+{
+    threadPools_.emplace_back(std::move(name), pool);
+    poolStats_.resize(threadPools_.size());
+}
+
+void MetricsServer::render(Buffer *buf)
+{
+    renderLoops(buf);
+    renderThreadPools(buf);
+}
+
+void MetricsServer::renderLoops(Buffer *buf)
+{
+    MetricsRegistry::getInstance().snapshotLoops(loops_);
+
+    char labels[32];
+    for (const CounterFamily &family: kLoopCounters)
+    {
+        appendFamily(buf, family.name, family.help, "counter");
+        for (const LoopMetricsSnapshot &loop: loops_)
+        {
+            appendf(buf, "%s{loop=\"%d\"} %lu\n", family.name, loop.tid, loop.*family.field);
+        }
+    }
+    for (const GaugeFamily &family: kLoopGauges)
+    {
+        appendFamily(buf, family.name, family.help, "gauge");
+        for (const LoopMetricsSnapshot &loop: loops_)
+        {
+            appendf(buf, "%s{loop=\"%d\"} %ld\n", family.name, loop.tid, loop.*family.field);
+        }
+    }
+    for (const HistogramFamily &family: kLoopHistograms)
+    {
+        appendFamily(buf, family.name, family.help, "histogram");
+        for (const LoopMetricsSnapshot &loop: loops_)
+        {
+            snprintf(labels, sizeof(labels), "loop=\"%d\"", loop.tid);
+            appendHistogram(buf, family.name, labels, loop.*family.field);
+        }
+    }
+}
+
+void MetricsServer::renderThreadPools(Buffer *buf)
+{
+    if (threadPools_.empty())
+    {
+        return;
+    }
+
+    static const char *const kGauges[][2] = {
+            {"muduo_threadpool_threads", "Worker threads."},
+            {"muduo_threadpool_idle_threads", "Idle worker threads."},
+            {"muduo_threadpool_queue_depth", "Tasks waiting in the queue."},
+    };
+    static const char *const kCounters[][2] = {
+            {"muduo_threadpool_executed_total", "Tasks executed."},
+            {"muduo_threadpool_steals_total", "Successful work steals."},
+            {"muduo_threadpool_rejected_total", "Tasks rejected."},
+            {"muduo_threadpool_caller_runs_total", "Tasks run in the submitting thread."},
+            {"muduo_threadpool_discarded_total", "Oldest tasks discarded."},
+    };
+
+    // 每个线程池只加锁取一次快照
+    for (size_t i = 0; i < threadPools_.size(); ++i)
+    {
+        poolStats_[i] = threadPools_[i].second->stats();
+    }
+
+    for (size_t g = 0; g < std::size(kGauges); ++g)
+    {
+        appendFamily(buf, kGauges[g][0], kGauges[g][1], "gauge");
+        for (size_t i = 0; i < threadPools_.size(); ++i)
+        {
+            const thp::PoolStats &stats = poolStats_[i];
+            size_t values[] = {stats.threads, stats.idleThreads, stats.queueDepth};
+            appendf(buf, "%s{pool=\"%s\"} %zu\n", kGauges[g][0], threadPools_[i].first.c_str(), values[g]);
+        }
+    }
+    for (size_t c = 0; c < std::size(kCounters); ++c)
+    {
+        appendFamily(buf, kCounters[c][0], kCounters[c][1], "counter");
+        for (size_t i = 0; i < threadPools_.size(); ++i)
+        {
+            const thp::PoolStats &stats = poolStats_[i];
+            uint64_t values[] = {stats.executed, stats.steals, stats.rejected, stats.callerRuns, stats.discarded};
+            appendf(buf, "%s{pool=\"%s\"} %lu\n", kCounters[c][0], threadPools_[i].first.c_str(), values[c]);
+        }
+    }
+
+    char labels[96];
+    appendFamily(buf, "muduo_threadpool_queue_wait_nanoseconds", "Time tasks spent waiting in the queue.", "histogram");
+    for (size_t i = 0; i < threadPools_.size(); ++i)
+    {
+        snprintf(labels, sizeof(labels), "pool=\"%s\"", threadPools_[i].first.c_str());
+        appendHistogram(buf, "muduo_threadpool_queue_wait_nanoseconds", labels, poolStats_[i].queueWaitNs);
+    }
+    appendFamily(buf, "muduo_threadpool_run_time_nanoseconds", "Task execution time.", "histogram");
+    for (size_t i = 0; i < threadPools_.size(); ++i)
+    {
+        snprintf(labels, sizeof(labels), "pool=\"%s\"", threadPools_[i].first.c_str());
+        appendHistogram(buf, "muduo_threadpool_run_time_nanoseconds", labels, poolStats_[i].runTimeNs);
+    }
+}
+
+void MetricsServer::onMessage(const TcpConnectionPtr &conn, Buffer *buf, Timestamp)
+{
+    while (conn->isConnected())
+    {
+        std::string_view request(buf->peek(), buf->readableBytes());
+        size_t headerEnd = request.find("\r\n\r\n");
+        if (headerEnd == std::string_view::npos)
+        {
+            // 请求头不完整：等待更多数据，过长则视为非法请求
+            if (request.size() > kMaxRequestSize)
+            {
+                buf->retrieveAll();
+                conn->shutdown();
+            }
+            return;
+        }
+
+        std::string_view head = request.substr(0, headerEnd);
+        std::string_view requestLine = head.substr(0, head.find("\r\n"));
+        bool found = requestLine.starts_with("GET /metrics ") || requestLine.starts_with("GET /metrics?");
+        bool close = requestLine.ends_with("HTTP/1.0") || containsIgnoreCase(head, "connection: close");
+        buf->retrieve(headerEnd + 4);
+
+        respond(conn, found, close);
+        if (close)
+        {
+            conn->shutdown();
+            return;
+        }
+    }
+}
+
+void MetricsServer::respond(const TcpConnectionPtr &conn, bool found, bool close)
+{
+    body_.retrieveAll();
+    if (found)
+    {
+        render(&body_);
+    }
+    else
+    {
+        body_.append("not found\n", 10);
+    }
+
+    // 响应头与响应体拼成一次发送，避免两次小写入触发 Nagle 与延迟确认
+    response_.retrieveAll();
+    appendf(&response_, "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n%s\r\n",
+            found ? "200 OK" : "404 Not Found",
+            found ? "text/plain; version=0.0.4; charset=utf-8" : "text/plain",
+            body_.readableBytes(),
+            close ? "Connection: close\r\n" : "");
+    response_.append(body_.peek(), body_.readableBytes());
+    conn->send(&response_);
+}
@@ -0,0 +1,144 @@
+//
+// Created by shuzeyong on 2025/5/23.
+//
+
+#include "../include/net/NgxBlockSource.h"
+
+#include <cstdlib>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+    size_t systemPageSize()
+    {
+        static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return pageSize;
+    }
+
+    size_t roundUp(size_t size, size_t align)
+    {
+        return (size + align - 1) & ~(align - 1);
+    }
+}// namespace
+
+NgxBlockSource *NgxBlockSource::mallocSource()
+{
+    static NgxMallocBlockSource source;
+    return &source;
+}
+
+void *NgxMallocBlockSource::allocate(size_t size)
+{
+    return malloc(size);
+}
+
+void NgxMallocBlockSource::deallocate(void *p, size_t)
+{
+    free(p);
+}
+
+void NgxMallocBlockSource::purge(void *p, size_t size)
+{
+    // 只处理完全落在内存块内的页面，不触碰 malloc 在块前后的元数据；free 之后这些页面再次使用时重新缺页
+    auto begin = roundUp(reinterpret_cast<uintptr_t>(p), systemPageSize());
+    auto end = (reinterpret_cast<uintptr_t>(p) + size) & ~(systemPageSize() - 1);
+    if (begin < end)
+    {
+        madvise(reinterpret_cast<void *>(begin), end - begin, MADV_DONTNEED);
+    }
+    free(p);
+}
+
+NgxMmapBlockSource::NgxMmapBlockSource(HugePageMode mode, bool prefault)
+    : mode_(mode),
+      prefault_(prefault),
+      hugePageFallbacks_(0)
+{
+}
+
+bool NgxMmapBlockSource::useHugeTlb(size_t size) const
+{
+    return mode_ == kExplicitHugePages && size >= NGX_HUGE_PAGE_SIZE;
+}
+
+size_t NgxMmapBlockSource::mappedSize(size_t size) const
+{
+    // 使用显式大页的请求即使退回透明大页也按 2MB 取整，保证释放时的长度与映射一致；
+    // 更小的请求只按页面取整，不会被放大到 2MB
+    return roundUp(size == 0 ? 1 : size, useHugeTlb(size) ? NGX_HUGE_PAGE_SIZE : systemPageSize());
+}
+
+void *NgxMmapBlockSource::allocate(size_t size)
+{
+    size_t length = mappedSize(size);
+
+    if (useHugeTlb(size))
+    {
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (prefault_ ? MAP_POPULATE : 0);
+        void *p = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (p != MAP_FAILED)
+        {
+            return p;
+        }
+        // 未预留大页或大页已用完：退回透明大页方式
+        hugePageFallbacks_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (mode_ == kNormalPages || length < NGX_HUGE_PAGE_SIZE)
+    {
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS | (prefault_ ? MAP_POPULATE : 0);
+        void *p = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+    return mapTransparent(length);
+}
+
+void *NgxMmapBlockSource::mapTransparent(size_t length) const
+{
+    // 多映射 2MB 后裁掉首尾，使起始地址按 2MB 对齐，整段都可以由透明大页承载
+    size_t span = length + NGX_HUGE_PAGE_SIZE;
+    void *raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    auto start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = roundUp(start, NGX_HUGE_PAGE_SIZE);
+    if (aligned > start)
+    {
+        munmap(raw, aligned - start);
+    }
+    size_t tail = start + span - (aligned + length);
+    if (tail > 0)
+    {
+        munmap(reinterpret_cast<void *>(aligned + length), tail);
+    }
+
+    auto *p = reinterpret_cast<void *>(aligned);
+    madvise(p, length, MADV_HUGEPAGE);
+    if (prefault_)
+    {
+        // 大页建议生效后再预先缺页，使缺页时直接分配大页
+        madvise(p, length, MADV_WILLNEED);
+        for (size_t offset = 0; offset < length; offset += systemPageSize())
+        {
+            static_cast<volatile char *>(p)[offset] = 0;
+        }
+    }
+    return p;
+}
+
+void NgxMmapBlockSource::deallocate(void *p, size_t size)
+{
+    if (p != nullptr)
+    {
+        munmap(p, mappedSize(size));
+    }
+}
+
+uint64_t NgxMmapBlockSource::hugePageFallbacks() const
+{
+    return hugePageFallbacks_.load(std::memory_order_relaxed);
+}
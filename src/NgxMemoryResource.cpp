@@ -0,0 +1,63 @@
+//
+// Created by shuzeyong on 2025/5/21.
+//
+
+#include "../include/net/NgxMemoryResource.h"
+
+#include <new>
+
+NgxMemoryResource::NgxMemoryResource(NgxMemPool *pool)
+    : pool_(pool)
+{
+}
+
+NgxMemPool *NgxMemoryResource::getPool() const
+{
+    return pool_;
+}
+
+bool NgxMemoryResource::alignedByPool(size_t bytes, size_t alignment) const
+{
+    // 小块内存按 NGX_ALIGNMENT 对齐，大块内存由 malloc 分配，按 max_align_t 对齐
+    if (bytes > pool_->smallMax())
+    {
+        return alignment <= alignof(std::max_align_t);
+    }
+    return alignment <= NGX_ALIGNMENT;
+}
+
+void *NgxMemoryResource::do_allocate(size_t bytes, size_t alignment)
+{
+    if (alignedByPool(bytes, alignment))
+    {
+        void *p = pool_->palloc(bytes);
+        if (p == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    // 对齐要求超过内存池的保证：多分配对齐余量后手动对齐
+    auto *p = static_cast<u_char *>(pool_->pnalloc(bytes + alignment - 1));
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ngx_align_ptr(p, alignment);
+}
+
+void NgxMemoryResource::do_deallocate(void *p, size_t bytes, size_t alignment)
+{
+    // 只有直接分配的大块内存可以立即归还；小块内存与手动对齐的内存随内存池重置或销毁回收
+    if (bytes > pool_->smallMax() && alignedByPool(bytes, alignment))
+    {
+        pool_->pfree(p);
+    }
+}
+
+bool NgxMemoryResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    // 只有同一个适配器（即同一个内存池）分配的内存才能互相释放
+    return this == &other;
+}
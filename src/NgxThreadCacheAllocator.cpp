@@ -0,0 +1,531 @@
+//
+// Created by shuzeyong on 2025/5/22.
+//
+
+#include "../include/net/NgxThreadCacheAllocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <sys/types.h>
+#include <vector>
+
+namespace
+{
+    /*空闲对象（链表指针存放在对象自身中）*/
+    struct NgxTcFreeObject_t
+    {
+        NgxTcFreeObject_t *next;
+    };
+
+    /*计算对象规格下标：16 ~ 128 字节每 16 字节一档，之后每个 2 的幂区间 4 档（均为 16 的倍数）*/
+    int sizeClassIndex(size_t size)
+    {
+        if (size <= 128)
+        {
+            return size == 0 ? 0 : (int) ((size + 15) / 16) - 1;
+        }
+        size_t v = size - 1;
+        int msb = 63 - __builtin_clzll(v);
+        int shift = msb - 2;
+        int sub = (int) (v >> shift) & 3;
+        return 8 + (msb - 7) * 4 + sub;
+    }
+
+    /*规格下标对应的对象大小*/
+    size_t sizeClassSize(int index)
+    {
+        if (index < 8)
+        {
+            return (size_t) (index + 1) * 16;
+        }
+        int group = (index - 8) / 4;
+        int sub = (index - 8) % 4;
+        return (size_t) (5 + sub) << (group + 5);
+    }
+
+    /*线程缓存与中心之间一次转移的对象数*/
+    uint32_t batchSize(int index)
+    {
+        return (uint32_t) std::clamp<size_t>(NGX_TC_SPAN_MIN / sizeClassSize(index), 2, 32);
+    }
+
+    /*规格对应的 span 大小：至少容纳 8 个对象*/
+    size_t spanSize(int index)
+    {
+        return std::max(NGX_TC_SPAN_MIN, sizeClassSize(index) * 8);
+    }
+}// namespace
+
+/*span：从内存来源申请的一段连续内存，切分为同一规格的对象*/
+struct NgxTcSpan_t
+{
+    u_char *base;                // 起始地址
+    size_t bytes;                // 大小
+    uint32_t live;               // 已分配出去的对象数
+    NgxTcFreeObject_t *freeList; // 空闲对象
+    NgxTcSpan_t *prev;           // 规格中有空闲对象的 span 链表
+    NgxTcSpan_t *next;
+};
+
+/*某个规格的中心空闲链表*/
+struct NgxTcCentralList_t
+{
+    std::mutex mtx;
+    std::vector<std::pair<NgxTcFreeObject_t *, uint32_t>> batches;// 转移缓存：整批对象（链表头，数量）
+    NgxTcSpan_t *spans = nullptr;                                  // 有空闲对象的 span
+    uint32_t emptySpans = 0;                                       // 完全空闲的 span 数量
+};
+
+/**
+ * @class NgxCentralHeap
+ * @brief 中心堆：各规格的中心空闲链表；span 与大对象直接向线程安全的 [NgxBlockSource] 申请，
+ *        只有 span 地址表需要加锁
+ */
+class NgxCentralHeap : net::NonCopyable
+{
+public:
+    explicit NgxCentralHeap(NgxBlockSource *source)
+        : source_(source)
+    {}
+
+    ~NgxCentralHeap()
+    {
+        close();
+    }
+
+    /*分配器销毁：释放全部 span，之后线程缓存的归还直接丢弃（不再访问对象内存）*/
+    void close()
+    {
+        if (closed.exchange(true, std::memory_order_acq_rel))
+        {
+            return;
+        }
+        std::unique_lock<std::shared_mutex> lock(spanMapMtx_);
+        for (auto &entry: spanMap_)
+        {
+            source_->deallocate(entry.second->base, entry.second->bytes);
+            delete entry.second;
+        }
+        spanMap_.clear();
+    }
+
+    /*从中心取一批对象，返回链表头，count 为实际数量*/
+    NgxTcFreeObject_t *fetch(int index, uint32_t want, uint32_t &count)
+    {
+        NgxTcCentralList_t &list = lists_[index];
+        std::lock_guard<std::mutex> lock(list.mtx);
+
+        if (!list.batches.empty() && list.batches.back().second == want)
+        {
+            auto batch = list.batches.back();
+            list.batches.pop_back();
+            count = batch.second;
+            return batch.first;
+        }
+
+        NgxTcFreeObject_t *head = nullptr;
+        for (count = 0; count < want; ++count)
+        {
+            NgxTcSpan_t *span = list.spans;
+            if (span == nullptr)
+            {
+                span = newSpan(index);
+                if (span == nullptr)
+                {
+                    break;
+                }
+                linkSpan(list, span);
+                ++list.emptySpans;
+            }
+            if (span->live++ == 0)
+            {
+                --list.emptySpans;
+            }
+            NgxTcFreeObject_t *obj = span->freeList;
+            span->freeList = obj->next;
+            if (span->freeList == nullptr)
+            {
+                unlinkSpan(list, span);// 已分配完的 span 不在链表中，有对象归还时再加入
+            }
+            obj->next = head;
+            head = obj;
+        }
+        return head;
+    }
+
+    /*向中心归还一批对象*/
+    void giveBack(int index, NgxTcFreeObject_t *head, uint32_t count)
+    {
+        if (closed.load(std::memory_order_acquire))
+        {
+            return;
+        }
+        {
+            NgxTcCentralList_t &list = lists_[index];
+            std::lock_guard<std::mutex> lock(list.mtx);
+
+            if (count == batchSize(index) && list.batches.size() < NGX_TC_TRANSFER_BATCHES)
+            {
+                list.batches.emplace_back(head, count);
+            }
+            else
+            {
+                returnToSpans(list, head);
+            }
+        }
+
+        // 周期性归还：到期后由第一个抢到的线程执行
+        int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::steady_clock::now().time_since_epoch())
+                              .count();
+        int64_t next = nextScavenge_.load(std::memory_order_relaxed);
+        if (now >= next && nextScavenge_.compare_exchange_strong(next, now + NGX_TC_SCAVENGE_INTERVAL_MS))
+        {
+            for (NgxTcCentralList_t &list: lists_)
+            {
+                std::lock_guard<std::mutex> lock(list.mtx);
+                releaseEmptySpans(list, 1);
+            }
+        }
+    }
+
+    /*清空转移缓存，并释放所有完全空闲的 span*/
+    void releaseFreeMemory()
+    {
+        for (NgxTcCentralList_t &list: lists_)
+        {
+            std::lock_guard<std::mutex> lock(list.mtx);
+            for (auto &batch: list.batches)
+            {
+                returnToSpans(list, batch.first);
+            }
+            list.batches.clear();
+            releaseEmptySpans(list, 0);
+        }
+    }
+
+    /*分配超过 NGX_TC_MAX_SIZE 的大对象*/
+    void *allocateLarge(size_t bytes)
+    {
+        return source_->allocate(bytes);
+    }
+
+    /*释放大对象*/
+    void deallocateLarge(void *p, size_t bytes)
+    {
+        source_->deallocate(p, bytes);
+    }
+
+    std::atomic<bool> closed{false};// 分配器已销毁，线程缓存应直接释放
+
+private:
+    std::atomic<int64_t> nextScavenge_{0};// 下一次周期性归还的时间（steady_clock 毫秒）
+
+    /*释放完全空闲的 span，只保留 keep 个（调用方持有规格锁）*/
+    void releaseEmptySpans(NgxTcCentralList_t &list, uint32_t keep)
+    {
+        NgxTcSpan_t *span = list.spans;
+        while (span && list.emptySpans > keep)
+        {
+            NgxTcSpan_t *next = span->next;
+            if (span->live == 0)
+            {
+                unlinkSpan(list, span);
+                --list.emptySpans;
+                releaseSpan(span);
+            }
+            span = next;
+        }
+    }
+
+    /*逐个归还对象到所属 span；完全空闲的 span 超过上限时交还内存来源*/
+    void returnToSpans(NgxTcCentralList_t &list, NgxTcFreeObject_t *head)
+    {
+        std::vector<NgxTcSpan_t *> emptied;
+        {
+            // 整批对象只加一次读锁查找所属 span
+            std::shared_lock<std::shared_mutex> lock(spanMapMtx_);
+            while (head)
+            {
+                NgxTcFreeObject_t *obj = head;
+                head = head->next;
+
+                NgxTcSpan_t *span = findSpanLocked(obj);
+                if (span->freeList == nullptr)
+                {
+                    linkSpan(list, span);
+                }
+                obj->next = span->freeList;
+                span->freeList = obj;
+                if (--span->live == 0 && ++list.emptySpans > NGX_TC_MAX_EMPTY_SPANS)
+                {
+                    unlinkSpan(list, span);
+                    --list.emptySpans;
+                    emptied.push_back(span);
+                }
+            }
+        }
+        for (NgxTcSpan_t *span: emptied)
+        {
+            releaseSpan(span);
+        }
+    }
+
+    NgxTcSpan_t *newSpan(int index)
+    {
+        size_t bytes = spanSize(index);
+        size_t objSize = sizeClassSize(index);
+        auto *base = (u_char *) source_->allocate(bytes);
+        if (base == nullptr)
+        {
+            return nullptr;
+        }
+
+        auto *span = new NgxTcSpan_t{base, bytes, 0, nullptr, nullptr, nullptr};
+        for (size_t offset = (bytes / objSize) * objSize; offset > 0; offset -= objSize)
+        {
+            auto *obj = (NgxTcFreeObject_t *) (base + offset - objSize);
+            obj->next = span->freeList;
+            span->freeList = obj;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(spanMapMtx_);
+        spanMap_.emplace((uintptr_t) base, span);
+        return span;
+    }
+
+    /*span 已长期空闲：物理内存立即归还系统（malloc 来源的 64KB span 低于 mmap 阈值，仅 free 不会归还）*/
+    void releaseSpan(NgxTcSpan_t *span)
+    {
+        {
+            std::unique_lock<std::shared_mutex> lock(spanMapMtx_);
+            spanMap_.erase((uintptr_t) span->base);
+        }
+        source_->purge(span->base, span->bytes);
+        delete span;
+    }
+
+    NgxTcSpan_t *findSpanLocked(void *p)
+    {
+        // span 起始地址不按 span 大小对齐：取起始地址不大于 p 的最后一个 span
+        auto it = spanMap_.upper_bound((uintptr_t) p);
+        return std::prev(it)->second;
+    }
+
+    static void linkSpan(NgxTcCentralList_t &list, NgxTcSpan_t *span)
+    {
+        span->prev = nullptr;
+        span->next = list.spans;
+        if (list.spans)
+        {
+            list.spans->prev = span;
+        }
+        list.spans = span;
+    }
+
+    static void unlinkSpan(NgxTcCentralList_t &list, NgxTcSpan_t *span)
+    {
+        if (span->prev)
+        {
+            span->prev->next = span->next;
+        }
+        else
+        {
+            list.spans = span->next;
+        }
+        if (span->next)
+        {
+            span->next->prev = span->prev;
+        }
+        span->prev = span->next = nullptr;
+    }
+
+    NgxTcCentralList_t lists_[NGX_TC_CLASS_COUNT];// 各规格的中心空闲链表
+
+    NgxBlockSource *source_;// span 与大对象的内存来源（线程安全，无需加锁）
+
+    std::shared_mutex spanMapMtx_;              // 保护 spanMap_
+    std::map<uintptr_t, NgxTcSpan_t *> spanMap_;// span 起始地址 -> span，用于由对象地址找到所属 span
+};
+
+namespace
+{
+    /*某个线程针对某个中心堆的线程缓存*/
+    class NgxThreadCache : net::NonCopyable
+    {
+    public:
+        explicit NgxThreadCache(std::shared_ptr<NgxCentralHeap> central)
+            : central_(std::move(central))
+        {}
+
+        ~NgxThreadCache()
+        {
+            flush();
+        }
+
+        void *allocate(int index)
+        {
+            FreeList &list = lists_[index];
+            if (list.head == nullptr)
+            {
+                list.head = central_->fetch(index, batchSize(index), list.length);
+                if (list.head == nullptr)
+                {
+                    throw std::bad_alloc();
+                }
+            }
+            NgxTcFreeObject_t *obj = list.head;
+            list.head = obj->next;
+            --list.length;
+            return obj;
+        }
+
+        void deallocate(void *p, int index)
+        {
+            FreeList &list = lists_[index];
+            auto *obj = (NgxTcFreeObject_t *) p;
+            obj->next = list.head;
+            list.head = obj;
+
+            // 超过两批时归还一批，避免单个线程囤积（如只释放不分配的消费者线程）
+            uint32_t batch = batchSize(index);
+            if (++list.length > 2 * batch)
+            {
+                NgxTcFreeObject_t *head = list.head;
+                NgxTcFreeObject_t *tail = head;
+                for (uint32_t i = 1; i < batch; ++i)
+                {
+                    tail = tail->next;
+                }
+                list.head = tail->next;
+                tail->next = nullptr;
+                list.length -= batch;
+                central_->giveBack(index, head, batch);
+            }
+        }
+
+        /*将所有缓存的对象归还中心*/
+        void flush()
+        {
+            for (int i = 0; i < NGX_TC_CLASS_COUNT; ++i)
+            {
+                if (lists_[i].head)
+                {
+                    central_->giveBack(i, lists_[i].head, lists_[i].length);
+                    lists_[i].head = nullptr;
+                    lists_[i].length = 0;
+                }
+            }
+        }
+
+        [[nodiscard]] const NgxCentralHeap *central() const
+        {
+            return central_.get();
+        }
+
+    private:
+        struct FreeList
+        {
+            NgxTcFreeObject_t *head = nullptr;// 空闲对象链表
+            uint32_t length = 0;              // 链表长度
+        };
+
+        std::shared_ptr<NgxCentralHeap> central_;// 所属中心堆
+        FreeList lists_[NGX_TC_CLASS_COUNT];     // 各规格的空闲链表
+    };
+
+    /*当前线程的所有线程缓存（通常只有一个分配器），线程退出时全部归还*/
+    thread_local std::vector<std::unique_ptr<NgxThreadCache>> tlsCaches;
+
+    NgxThreadCache *findThreadCache(const NgxCentralHeap *central)
+    {
+        for (auto &cache: tlsCaches)
+        {
+            if (cache->central() == central)
+            {
+                return cache.get();
+            }
+        }
+        return nullptr;
+    }
+
+    NgxThreadCache *threadCache(const std::shared_ptr<NgxCentralHeap> &central)
+    {
+        if (NgxThreadCache *cache = findThreadCache(central.get()))
+        {
+            return cache;
+        }
+
+        // 第一次使用该分配器：顺便归还并释放已销毁分配器的线程缓存
+        std::erase_if(tlsCaches, [](const auto &cache) {
+            return cache->central()->closed.load(std::memory_order_acquire);
+        });
+        tlsCaches.push_back(std::make_unique<NgxThreadCache>(central));
+        return tlsCaches.back().get();
+    }
+}// namespace
+
+NgxThreadCacheAllocator::NgxThreadCacheAllocator(NgxBlockSource *source)
+    : central_(std::make_shared<NgxCentralHeap>(source))
+{
+}
+
+NgxThreadCacheAllocator::~NgxThreadCacheAllocator()
+{
+    // 立即释放全部内存；各线程的线程缓存在线程下次创建线程缓存或退出时丢弃
+    // （析构可能发生在线程局部变量销毁之后，这里不访问线程缓存）
+    central_->close();
+}
+
+void NgxThreadCacheAllocator::releaseFreeMemory()
+{
+    if (NgxThreadCache *cache = findThreadCache(central_.get()))
+    {
+        cache->flush();
+    }
+    central_->releaseFreeMemory();
+}
+
+void *NgxThreadCacheAllocator::do_allocate(size_t bytes, size_t alignment)
+{
+    // 对象按 16 字节对齐（规格均为 16 的倍数，span 至少按 max_align_t 对齐），更高的对齐要求交给全局 operator new
+    if (alignment > alignof(std::max_align_t))
+    {
+        return ::operator new(bytes, std::align_val_t(alignment));
+    }
+    if (bytes > NGX_TC_MAX_SIZE)
+    {
+        void *p = central_->allocateLarge(bytes);
+        if (p == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+    return threadCache(central_)->allocate(sizeClassIndex(bytes));
+}
+
+void NgxThreadCacheAllocator::do_deallocate(void *p, size_t bytes, size_t alignment)
+{
+    if (alignment > alignof(std::max_align_t))
+    {
+        ::operator delete(p, std::align_val_t(alignment));
+        return;
+    }
+    if (bytes > NGX_TC_MAX_SIZE)
+    {
+        central_->deallocateLarge(p, bytes);
+        return;
+    }
+    threadCache(central_)->deallocate(p, sizeClassIndex(bytes));
+}
+
+bool NgxThreadCacheAllocator::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
@@ -0,0 +1,131 @@
+//
+// Created by shuzeyong on 2025/5/20.
+//
+
+#include "../include/net/ObjectPool.h"
+#include "../include/net/CurrentThread.h"
+
+using namespace net;
+
+SlabPool::SlabPool(size_t blocksPerSlab)
+    : ownerTid_(0),
+      blockSize_(0),
+      requestSize_(0),
+      blocksPerSlab_(std::max<size_t>(blocksPerSlab, 1)),
+      freeList_(nullptr),
+      remoteFree_(nullptr),
+      refs_(1)
+{
+}
+
+std::shared_ptr<SlabPool> SlabPool::create(size_t blocksPerSlab)
+{
+    // 句柄析构时只释放自己的引用，仍有未归还的块时池继续存活
+    return {new SlabPool(blocksPerSlab), [](SlabPool *pool) { pool->release(); }};
+}
+
+void SlabPool::release()
+{
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete this;
+    }
+}
+
+SlabPool::~SlabPool()
+{
+    for (void *slab: slabs_)
+    {
+        ::operator delete(slab);
+    }
+    for (void *block: strays_)
+    {
+        ::operator delete(block);
+    }
+}
+
+void *SlabPool::allocate(size_t size)
+{
+    if (blockSize_ == 0)
+    {
+        // 第一次分配：确定所属线程与块大小（块至少能容纳空闲链表指针，并按 max_align_t 对齐）
+        ownerTid_ = CurrentThread::tid();
+        requestSize_ = size;
+        size_t align = alignof(std::max_align_t);
+        blockSize_ = (std::max(size, sizeof(FreeBlock)) + align - 1) & ~(align - 1);
+    }
+    if (size != requestSize_)
+    {
+        return nullptr;
+    }
+    if (CurrentThread::tid() != ownerTid_)
+    {
+        // 其他线程不能访问本地空闲链表：单独申请一块并登记，释放后同样进入池中复用
+        void *block = ::operator new(blockSize_);
+        std::lock_guard<std::mutex> lock(strayMtx_);
+        strays_.push_back(block);
+        return block;
+    }
+
+    if (freeList_ == nullptr)
+    {
+        refill();
+    }
+    FreeBlock *block = freeList_;
+    freeList_ = block->next;
+    return block;
+}
+
+void SlabPool::deallocate(void *p)
+{
+    auto *block = static_cast<FreeBlock *>(p);
+    if (CurrentThread::tid() == ownerTid_)
+    {
+        block->next = freeList_;
+        freeList_ = block;
+        return;
+    }
+
+    // 其他线程：压入远程释放栈（只有所属线程整体取走，不存在 ABA 问题）
+    FreeBlock *head = remoteFree_.load(std::memory_order_relaxed);
+    do {
+        block->next = head;
+    } while (!remoteFree_.compare_exchange_weak(head, block,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed));
+}
+
+bool SlabPool::owns(size_t size) const
+{
+    return blockSize_ != 0 && size == requestSize_;
+}
+
+size_t SlabPool::slabCount() const
+{
+    return slabs_.size();
+}
+
+size_t SlabPool::blockSize() const
+{
+    return blockSize_;
+}
+
+void SlabPool::refill()
+{
+    // 优先取回其他线程释放的块
+    freeList_ = remoteFree_.exchange(nullptr, std::memory_order_acquire);
+    if (freeList_ != nullptr)
+    {
+        return;
+    }
+
+    // 申请新的 slab 并切分成块
+    auto *slab = static_cast<char *>(::operator new(blockSize_ * blocksPerSlab_));
+    slabs_.push_back(slab);
+    for (size_t i = blocksPerSlab_; i-- > 0;)
+    {
+        auto *block = reinterpret_cast<FreeBlock *>(slab + i * blockSize_);
+        block->next = freeList_;
+        freeList_ = block;
+    }
+}
@@ -2,6 +2,8 @@
 // Created by shuzeyong on 2025/5/8.
 //
 
+#define LOG_MODULE net::LogModule::kAcceptor
+
 #include "../include/net/Socket.h"
 
 using namespace net;
@@ -2,6 +2,8 @@
 // Created by shuzeyong on 2025/5/8.
 //
 
+#define LOG_MODULE net::LogModule::kTcpConnection
+
 #include "../include/net/TcpConnection.h"
 
 using namespace net;
@@ -24,44 +26,76 @@ TcpConnection::TcpConnection(EventLoop *loop,
       name_(std::move(name)),
       state_(kConnecting),                // 初始连接状态（正在连接）
       reading_(true),                     // 默认启用读事件监听
-      socket_(new Socket(sockfd)),        // 封装socket描述符
-      channel_(new Channel(loop, sockfd)),// 创建事件通道
+      socket_(sockfd),                    // 封装socket描述符
+      channel_(loop, sockfd),             // 创建事件通道
       localAddr_(localAddr),              // 存储本地地址
       peerAddr_(peerAddr),                // 存储对端地址
-      highWaterMark_(64 * 1024 * 1024)    // 设置64MB高水位缓冲区限制
+      highWaterMark_(64 * 1024 * 1024),   // 设置64MB高水位缓冲区限制
+      blockSource_(NgxBlockSource::mallocSource())
 {
     // 配置channel的四个核心回调：将网络事件转发到TcpConnection的处理方法
-    channel_->setReadCallback([this](auto &&PH1) { handleRead(std::forward<decltype(PH1)>(PH1)); });
-    channel_->setWriteCallback([this] { handleWrite(); });
-    channel_->setCloseCallback([this] { handleClose(); });
-    channel_->setErrorCallback([this] { handleError(); });
+    channel_.setReadCallback([this](auto &&PH1) { handleRead(std::forward<decltype(PH1)>(PH1)); });
+    channel_.setWriteCallback([this] { handleWrite(); });
+    channel_.setCloseCallback([this] { handleClose(); });
+    channel_.setErrorCallback([this] { handleError(); });
 
     // 调试日志记录连接创建信息
     LOG_DEBUG("TcpConnection::ctor[%s] at this fd=%d \n", name_.c_str(), sockfd);
 
     // 启用TCP keepalive机制保持长连接
-    socket_->setKeepAlive(true);
+    socket_.setKeepAlive(true);
 }
 
 TcpConnection::~TcpConnection()
 {
-    LOG_INFO("TcpConnection::dtor[%s] at fd=%d state=%d", name_.c_str(), channel_->getFd(), static_cast<int>(state_));
+    LOG_INFO("TcpConnection::dtor[%s] at fd=%d state=%d", name_.c_str(), channel_.getFd(), static_cast<int>(state_));
 }
 
 void TcpConnection::send(const std::string &buf)
+{
+    send(buf.data(), buf.size());
+}
+
+void TcpConnection::send(const void *data, size_t len)
 {
     // 检查当前连接状态是否为已连接
     if (state_ == kConnected)
     {
-        // 在事件循环线程中异步调用sendInLoop函数来发送数据
-        loop_->runInLoop(
-                [This = shared_from_this(), capture0 = buf.c_str(), capture1 = buf.size()] {
-                    This->sendInLoop(capture0, capture1);
-                });
+        if (loop_->isInLoopThread())
+        {
+            sendInLoop(data, len);
+        }
+        else
+        {
+            // 调用方返回后数据可能失效，拷贝一份交给事件循环线程发送
+            loop_->queueInLoop(
+                    [This = shared_from_this(), message = std::string(static_cast<const char *>(data), len)] {
+                        This->sendInLoop(message.data(), message.size());
+                    });
+        }
     }
 }
 
-void TcpConnection::sendInLoop(const void *data, size_t len)
+void TcpConnection::send(Buffer *buf)
+{
+    if (state_ == kConnected)
+    {
+        if (loop_->isInLoopThread())
+        {
+            sendInLoop(buf->peek(), buf->readableBytes());
+            buf->retrieveAll();
+        }
+        else
+        {
+            loop_->queueInLoop(
+                    [This = shared_from_this(), message = buf->retrieveAllAsString()] {
+                        This->sendInLoop(message.data(), message.size());
+                    });
+        }
+    }
+}
+
+bool TcpConnection::sendInLoop(const void *data, size_t len)
 {
     ssize_t nwrote = 0;     // 实际写入socket的字节数
     size_t remaining = len; // 剩余待发送字节数
@@ -71,20 +105,21 @@ void TcpConnection::sendInLoop(const void *data, size_t len)
     if (state_ == kDisconnected)
     {
         LOG_ERROR("disconnected, give up writing");
-        return;
+        return false;
     }
 
     /* 直接写入优化路径：当满足以下条件时尝试直接写入socket
      * 1. 输出缓冲区为空（没有待发送的遗留数据）
      * 2. 未注册写事件监听（说明之前没有发送阻塞的情况）
      */
-    if (!channel_->isWriting() && outputBuffer_.readableBytes() == 0)
+    if (!channel_.isWriting() && outputBuffer_.readableBytes() == 0)
     {
         // 尝试非阻塞写入（可能部分成功）
-        nwrote = write(channel_->getFd(), data, len);
+        nwrote = ::write(channel_.getFd(), data, len);
 
         if (nwrote >= 0)// 成功写入部分或全部数据
         {
+            loop_->metrics().bytesWritten.add(nwrote);
             remaining = len - nwrote;
             // 既然在这里数据全部发送完毕了，就不用再给channel设置handleWrite()事件了
             // 即不再监听tcp读缓冲区什么时候有空间，如果有注册写完成回调则调用
@@ -100,7 +135,11 @@ void TcpConnection::sendInLoop(const void *data, size_t len)
         {
             nwrote = 0;
             // 如果错误不是EWOULDBLOCK，记录错误并根据错误类型设置faultError标志
-            if (errno != EWOULDBLOCK)
+            if (errno == EWOULDBLOCK)
+            {
+                loop_->metrics().eagain.add();
+            }
+            else
             {
                 LOG_ERROR("%s : %d : %s", __FILE__, __LINE__, __FUNCTION__);
                 if (errno == EPIPE || errno == ECONNRESET)
@@ -133,11 +172,113 @@ void TcpConnection::sendInLoop(const void *data, size_t len)
         outputBuffer_.append(static_cast<const char *>(data) + nwrote, remaining);
 
         // 注册写事件监听（当内核发送缓冲区可用时触发handleWrite）
-        if (!channel_->isWriting())
+        if (!channel_.isWriting())
+        {
+            channel_.enableWriting();
+        }
+    }
+    publishBufferMetrics();
+    return !faultError;
+}
+
+void TcpConnection::publishBufferMetrics()
+{
+    // 只发布与上次的差值，事件循环的仪表即为其上所有连接之和
+    auto bufferBytes = static_cast<int64_t>(inputBuffer_.internalCapacity() + outputBuffer_.internalCapacity());
+    auto outputPending = static_cast<int64_t>(outputBuffer_.readableBytes());
+    LoopMetrics &metrics = loop_->metrics();
+    metrics.bufferBytes.add(bufferBytes - bufferBytesPublished_);
+    metrics.outputPending.add(outputPending - outputPendingPublished_);
+    bufferBytesPublished_ = bufferBytes;
+    outputPendingPublished_ = outputPending;
+}
+
+TcpConnection::ReadAwaiter TcpConnection::read(size_t n)
+{
+    coroutineMode_ = true;
+    return {this, n, std::string_view()};
+}
+
+TcpConnection::ReadAwaiter TcpConnection::readUntil(std::string_view delim)
+{
+    coroutineMode_ = true;
+    return {this, 0, delim};
+}
+
+TcpConnection::WriteAwaiter TcpConnection::write(std::string_view data)
+{
+    return {this, data};
+}
+
+bool TcpConnection::tryCompleteRead(ReadAwaiter *awaiter)
+{
+    std::string_view readable(inputBuffer_.peek(), inputBuffer_.readableBytes());
+    size_t len = std::string_view::npos;
+    if (awaiter->delim_.empty())
+    {
+        if (readable.size() >= awaiter->n_)
         {
-            channel_->enableWriting();
+            len = awaiter->n_;
         }
     }
+    else
+    {
+        size_t pos = readable.find(awaiter->delim_);
+        if (pos != std::string_view::npos)
+        {
+            len = pos + awaiter->delim_.size();
+        }
+    }
+
+    if (len != std::string_view::npos)
+    {
+        // 只移动读指针，数据在下一次从 socket 读取前保持不变，因此结果可直接指向缓冲区
+        awaiter->result_ = readable.substr(0, len);
+        inputBuffer_.retrieve(len);
+        return true;
+    }
+    if (state_ == kDisconnected)
+    {
+        awaiter->result_ = std::nullopt;
+        return true;
+    }
+    return false;
+}
+
+bool TcpConnection::startWrite(WriteAwaiter *awaiter)
+{
+    if (state_ != kConnected || !sendInLoop(awaiter->data_.data(), awaiter->data_.size()))
+    {
+        awaiter->ok_ = false;
+        return false;
+    }
+    if (outputBuffer_.readableBytes() == 0)
+    {
+        awaiter->ok_ = true;
+        return false;
+    }
+    // 剩余数据已进入输出缓冲区，由 handleWrite() 写完后恢复
+    writeWaiter_ = awaiter;
+    return true;
+}
+
+void TcpConnection::resumeReader()
+{
+    if (readWaiter_ && tryCompleteRead(readWaiter_))
+    {
+        ReadAwaiter *awaiter = std::exchange(readWaiter_, nullptr);
+        awaiter->handle_.resume();
+    }
+}
+
+void TcpConnection::resumeWriter(bool ok)
+{
+    if (writeWaiter_)
+    {
+        WriteAwaiter *awaiter = std::exchange(writeWaiter_, nullptr);
+        awaiter->ok_ = ok;
+        awaiter->handle_.resume();
+    }
 }
 
 void TcpConnection::shutdown()
@@ -155,12 +296,12 @@ void TcpConnection::shutdown()
 void TcpConnection::shutdownInLoop()
 {
     // 关键条件判断：仅当输出通道无待发送数据时才能立即关闭写端
-    if (!channel_->isWriting())
+    if (!channel_.isWriting())
     {
         // 执行半关闭操作，触发后续连接关闭事件链
         // shutdownWrite()将发送FIN包，通知对端不再发送数据
         // 同时使epoll监听到EPOLLHUP事件，激活closeCallback
-        socket_->shutdownWrite();
+        socket_.shutdownWrite();
     }
 }
 
@@ -171,10 +312,15 @@ void TcpConnection::connectEstablished()
 
     // 将当前连接对象与channel_绑定，确保在channel_事件回调时能够访问到当前连接对象
     // 因为TcpConnection对象是暴露给用户的，所以得保障TcpConnection对象的生命周期
-    channel_->tie(shared_from_this());
+    channel_.tie(shared_from_this());
 
     // 启用channel_的读事件监听，以便接收来自对端的数据
-    channel_->enableReading();
+    channel_.enableReading();
+
+    if (memPool_)
+    {
+        loop_->metrics().memPools.add(1);
+    }
 
     // 调用用户注册的连接回调函数，通知上层应用连接已建立
     connectionCallback_(shared_from_this());
@@ -189,25 +335,52 @@ void TcpConnection::connectDestroyed()
         setState(kDisconnected);
 
         // 禁用与该连接相关的所有事件
-        channel_->disableAll();
+        channel_.disableAll();
 
         // 调用连接回调函数，通知上层连接已销毁
         connectionCallback_(shared_from_this());
     }
 
+    // 恢复仍在等待的协程，使其看到连接已断开并结束
+    resumeReader();
+    resumeWriter(false);
+
+    // 一次性释放请求内存池中的全部内存（上层回调与协程都已结束对它的使用）
+    if (memPool_)
+    {
+        loop_->metrics().publishMemPool(memPool_->stats(), memPoolPublished_);
+        loop_->metrics().memPools.sub(1);
+    }
+    loop_->metrics().bufferBytes.sub(bufferBytesPublished_);
+    loop_->metrics().outputPending.sub(outputPendingPublished_);
+    bufferBytesPublished_ = 0;
+    outputPendingPublished_ = 0;
+    memResource_.reset();
+    memPool_.reset();
+
     // 将该连接的channel从poller中移除
-    channel_->remove();
+    channel_.remove();
 }
 
 void TcpConnection::handleRead(Timestamp receiveTime)
 {
     int savedErrno = 0;
     // 从fd的读缓冲区中读取数据到用户的读缓冲区中
-    ssize_t n = inputBuffer_.readFd(channel_->getFd(), &savedErrno);
+    ssize_t n = inputBuffer_.readFd(channel_.getFd(), &savedErrno);
 
-    if (n > 0)// 成功读取数据：调用用户注册的消息回调函数
+    if (n > 0)// 成功读取数据：恢复等待读的协程，或调用用户注册的消息回调函数
     {
-        messageCallback_(shared_from_this(), &inputBuffer_, receiveTime);
+        loop_->metrics().bytesRead.add(n);
+        // 逐请求追踪：开启二进制日志时只记录原始参数，代价很小
+        LOG_DEBUG("TcpConnection::handleRead[%s] fd=%d read %zd bytes", name_.c_str(), channel_.getFd(), n);
+        if (coroutineMode_)
+        {
+            resumeReader();
+        }
+        else
+        {
+            messageCallback_(shared_from_this(), &inputBuffer_, receiveTime);
+        }
     }
     else if (n == 0)// 客户端主动关闭连接：执行关闭处理流程
     {
@@ -215,24 +388,30 @@ void TcpConnection::handleRead(Timestamp receiveTime)
     }
     else// 读取发生错误：记录日志并执行用户设置的错误处理
     {
+        if (savedErrno == EAGAIN)
+        {
+            loop_->metrics().eagain.add();
+        }
         errno = savedErrno;
         LOG_ERROR("%s : %d : %s", __FILE__, __LINE__, __FUNCTION__);
         handleError();
     }
+    publishBufferMetrics();
 }
 
 void TcpConnection::handleWrite()
 {
     // 检查通道是否注册了写事件
-    if (channel_->isWriting())
+    if (channel_.isWriting())
     {
         int savedErrno = 0;
         // 非阻塞写入：将输出缓冲区数据尽可能多地写入socket
-        ssize_t n = outputBuffer_.writeFd(channel_->getFd(), &savedErrno);
+        ssize_t n = outputBuffer_.writeFd(channel_.getFd(), &savedErrno);
 
         // 成功写入数据的处理流程
         if (n > 0)
         {
+            loop_->metrics().bytesWritten.add(n);
             // 更新缓冲区状态，移动读指针以释放已发送数据占用的空间
             outputBuffer_.retrieve(n);
 
@@ -240,7 +419,7 @@ void TcpConnection::handleWrite()
             if (outputBuffer_.readableBytes() == 0)
             {
                 // 停止监听写事件（避免busy loop）
-                channel_->disableWriting();
+                channel_.disableWriting();
 
                 // 执行写完成回调（如果已设置），表示用户写缓冲区有空间了
                 if (writeCompleteCallback_)
@@ -256,29 +435,37 @@ void TcpConnection::handleWrite()
                 {
                     shutdownInLoop();
                 }
+
+                // 恢复等待写完成的协程
+                resumeWriter(true);
             }
         }
         else// 写入失败处理
         {
+            if (savedErrno == EAGAIN)
+            {
+                loop_->metrics().eagain.add();
+            }
             LOG_ERROR("%s : %d : %s", __FILE__, __LINE__, __FUNCTION__);
         }
+        publishBufferMetrics();
     }
     else// 连接已断开时的错误处理
     {
-        LOG_ERROR("Connection fd = %d is down, no more writing \n", channel_->getFd());
+        LOG_ERROR("Connection fd = %d is down, no more writing \n", channel_.getFd());
     }
 }
 
 void TcpConnection::handleClose()
 {
     // 记录连接关闭时的关键信息：文件描述符和当前状态
-    LOG_DEBUG("%s fd = %d state = %d \n", __FUNCTION__ channel_->getFd(), (int) state_);
+    LOG_DEBUG("%s fd = %d state = %d \n", __FUNCTION__, channel_.getFd(), (int) state_);
 
     // 将连接状态标记为已断开
     setState(kDisconnected);
 
     // 禁用通道上的所有事件监听（读写事件等）
-    channel_->disableAll();
+    channel_.disableAll();
 
     /* 创建智能指针保持对象生命周期：
      * 1. 使用shared_from_this()保证在回调执行期间对象不会被销毁
@@ -286,6 +473,10 @@ void TcpConnection::handleClose()
      */
     TcpConnectionPtr guardThis(shared_from_this());
 
+    // 恢复仍在等待的协程，使其看到连接已断开并结束
+    resumeReader();
+    resumeWriter(false);
+
     // 触发用户设置的上层连接回调（通知连接状态变化）
     connectionCallback_(guardThis);
 
@@ -301,7 +492,7 @@ void TcpConnection::handleError()
 
     // 通过getsockopt获取套接字错误状态，优先获取SO_ERROR选项值
     // 如果系统调用失败则取errno作为错误码
-    if (getsockopt(channel_->getFd(), SOL_SOCKET, SO_ERROR, &optval, &optlen) < 0)
+    if (getsockopt(channel_.getFd(), SOL_SOCKET, SO_ERROR, &optval, &optlen) < 0)
     {
         err = errno;
     }
@@ -344,6 +535,46 @@ Buffer *TcpConnection::getOutputBuffer()
     return &outputBuffer_;
 }
 
+void TcpConnection::setBlockSource(NgxBlockSource *source)
+{
+    blockSource_ = source;
+    inputBuffer_ = Buffer(Buffer::kInitialSize, source);
+    outputBuffer_ = Buffer(Buffer::kInitialSize, source);
+}
+
+void TcpConnection::enableMemPool(size_t size)
+{
+    if (!memPool_)
+    {
+        memPool_ = std::make_unique<NgxMemPool>(std::max<size_t>(size, NGX_MIN_POOL_SIZE), blockSource_);
+        memResource_ = std::make_unique<NgxMemoryResource>(memPool_.get());
+        // 连接建立前创建的内存池在 connectEstablished() 中计入（指标只由事件循环线程写入）
+        if (state_ == kConnected)
+        {
+            loop_->metrics().memPools.add(1);
+        }
+    }
+}
+
+NgxMemPool *TcpConnection::getMemPool() const
+{
+    return memPool_.get();
+}
+
+std::pmr::memory_resource *TcpConnection::getMemoryResource() const
+{
+    return memResource_.get();
+}
+
+void TcpConnection::resetMemPool()
+{
+    if (memPool_)
+    {
+        loop_->metrics().publishMemPool(memPool_->stats(), memPoolPublished_);
+        memPool_->resetPool();
+    }
+}
+
 bool TcpConnection::isConnected() const
 {
     return state_ == kConnected;
@@ -2,6 +2,8 @@
 // Created by shuzeyong on 2025/5/1.
 //
 
+#define LOG_MODULE net::LogModule::kTcpServer
+
 #include "../include/net/TcpServer.h"
 
 using namespace net;
@@ -47,8 +49,10 @@ TcpServer::TcpServer(EventLoop *loop,
       EventLoopThreadPool_(new EventLoopThreadPool(loop, name_)),     // 创建事件循环线程池，用于处理连接
       connectionCallback_(defaultConnectionCallback),                 // 初始化默认的连接回调函数
       messageCallback_(defaultMessageCallback),                       // 初始化默认的消息回调函数
+      started_(0),                                                    // 初始化服务器启动状态为未启动
       nextConnId_(1),                                                 // 初始化下一个连接 ID 为 1
-      started_(0)                                                     // 初始化服务器启动状态为未启动
+      connMemPoolSize_(0),                                            // 默认不为连接创建请求内存池
+      blockSource_(NgxBlockSource::mallocSource())                    // 默认从 malloc/free 申请缓冲区
 {
     // 设置 Acceptor 的新连接回调函数，当有新连接时，调用 TcpServer::newConnection 方法
     acceptor_->setNewConnectionCallback(
@@ -77,20 +81,20 @@ TcpServer::~TcpServer()
         // 通过事件循环机制调用TcpConnection的connectDestroyed方法，确保连接资源被安全释放
         conn->getLoop()->runInLoop([conn] { conn->connectDestroyed(); });
     }
+    loop_->metrics().activeConnections.sub(static_cast<int64_t>(connections_.size()));
 }
 
 void TcpServer::newConnection(int sockfd, const InetAddress &peerAddr)
 {
-    // 生成唯一的连接名称，格式为：服务器名称@连接ID（例如：Server@1）
-    char buffer[32] = {};
-    snprintf(buffer, sizeof(buffer), "@%d", nextConnId_);
-    std::string connName = name_ + buffer;
+    // 分配连接ID（连接名称在 ioLoop 线程中生成）
+    int connId = nextConnId_++;
 
     // 记录新连接的日志信息，包括客户端地址和连接ID
     LOG_INFO("[%s] NEW CONNECTION | Client:%s | ConnID:%d",
-             name_.c_str(), peerAddr.toIpPort().c_str(), nextConnId_);
+             name_.c_str(), peerAddr.toIpPort().c_str(), connId);
 
-    ++nextConnId_;
+    loop_->metrics().accepts.add();
+    loop_->metrics().activeConnections.add(1);
 
     // 获取本地地址信息
     sockaddr_in local = {};
@@ -105,14 +109,84 @@ void TcpServer::newConnection(int sockfd, const InetAddress &peerAddr)
     // 使用轮询（Round-Robin）算法分配，确保负载均衡
     EventLoop *ioLoop = EventLoopThreadPool_->getNextLoop();
 
-    // 创建TcpConnection对象，管理新连接的通信
-    TcpConnectionPtr conn(new TcpConnection(ioLoop,   // 连接所在的EventLoop
-                                            connName, // 连接名称
-                                            sockfd,   // accept返回的connfd
-                                            localAddr,// 服务端地址
-                                            peerAddr  // accept返回的客户端地址
-                                            ));
-    connections_[connName] = conn;// 将连接管理到ConnectionMap中
+    // 连接对象在 ioLoop 线程中从该线程的连接对象池创建：连接最终也在 ioLoop 线程析构，分配与释放都是池的本地路径
+    LoopHandoff &handoff = *handoffs_.at(ioLoop);
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(handoff.mutex);
+        wasEmpty = handoff.accepted.empty();
+        handoff.accepted.push_back(AcceptedSocket{sockfd, connId, localAddr, peerAddr});
+    }
+    if (wasEmpty)
+    {
+        ioLoop->runInLoop([this, ioLoop] { createConnectionsInLoop(ioLoop); });
+    }
+}
+
+void TcpServer::createConnectionsInLoop(EventLoop *ioLoop)
+{
+    LoopHandoff &handoff = *handoffs_.at(ioLoop);
+    {
+        std::lock_guard<std::mutex> lock(handoff.mutex);
+        handoff.acceptedBatch.swap(handoff.accepted);
+    }
+
+    std::vector<TcpConnectionPtr> &conns = handoff.establishing;
+    for (const AcceptedSocket &accepted: handoff.acceptedBatch)
+    {
+        conns.push_back(createConnection(ioLoop, accepted));
+    }
+    handoff.acceptedBatch.clear();
+
+    // 先交给 baseloop 加入ConnectionMap，再建立连接：连接回调中可能立即关闭连接，
+    // 而 removeConnection 同样由本线程投递到 baseloop，任务按投递顺序执行，因此移除一定发生在加入之后
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(handoff.mutex);
+        wasEmpty = handoff.created.empty();
+        handoff.created.insert(handoff.created.end(), conns.begin(), conns.end());
+    }
+    if (wasEmpty)
+    {
+        loop_->runInLoop([this, ioLoop] { addConnectionsInLoop(ioLoop); });
+    }
+
+    // connectEstablished()会将Channel注册到Poller，开始监听可读事件
+    for (const TcpConnectionPtr &conn: conns)
+    {
+        conn->connectEstablished();
+    }
+    conns.clear();
+}
+
+TcpConnectionPtr TcpServer::createConnection(EventLoop *ioLoop, const AcceptedSocket &accepted)
+{
+    // 生成唯一的连接名称，格式为：服务器名称@连接ID（例如：Server@1）
+    char buffer[32] = {};
+    snprintf(buffer, sizeof(buffer), "@%d", accepted.connId);
+    std::string connName = name_ + buffer;
+
+    // 连接对象（内含 Socket、Channel）与 shared_ptr 控制块在同一个池化内存块中，稳定状态下不再调用 malloc。
+    // 每个连接仍有的堆分配：输入/输出 Buffer 的初始存储（经 blockSource_）、ConnectionMap 的节点，
+    // 以及超出短字符串优化长度（15 字节）的连接名称
+    TcpConnectionPtr conn = std::allocate_shared<TcpConnection>(
+            SlabAllocator<TcpConnection>(ioLoop->connectionPool()),
+            ioLoop,            // 连接所在的EventLoop
+            connName,          // 连接名称
+            accepted.sockfd,   // accept返回的connfd
+            accepted.localAddr,// 服务端地址
+            accepted.peerAddr  // accept返回的客户端地址
+    );
+
+    // 按需替换内存来源、创建请求内存池（此时连接尚未建立）
+    if (blockSource_ != NgxBlockSource::mallocSource())
+    {
+        conn->setBlockSource(blockSource_);
+    }
+    if (connMemPoolSize_ > 0)
+    {
+        conn->enableMemPool(connMemPoolSize_);
+    }
 
     // 设置用户回调函数：这些回调由TcpServer的用户定义（如业务逻辑处理）
     conn->setConnectionCallback(connectionCallback_);      // 1. 连接建立/关闭回调
@@ -125,11 +199,21 @@ void TcpServer::newConnection(int sockfd, const InetAddress &peerAddr)
             [this](auto &&PH1) {
                 removeConnection(std::forward<decltype(PH1)>(PH1));// 从连接管理器中移除并销毁连接
             });
+    return conn;
+}
 
-    // 在选定的subLoop中执行连接建立操作
-    // 通过runInLoop确保connectEstablished在ioLoop线程中调用，避免竞态条件
-    ioLoop->runInLoop([conn] { conn->connectEstablished(); });
-    // connectEstablished()会将Channel注册到Poller，开始监听可读事件
+void TcpServer::addConnectionsInLoop(EventLoop *ioLoop)
+{
+    LoopHandoff &handoff = *handoffs_.at(ioLoop);
+    {
+        std::lock_guard<std::mutex> lock(handoff.mutex);
+        handoff.createdBatch.swap(handoff.created);
+    }
+    for (const TcpConnectionPtr &conn: handoff.createdBatch)
+    {
+        connections_[conn->getName()] = conn;// 将连接管理到ConnectionMap中
+    }
+    handoff.createdBatch.clear();
 }
 
 void TcpServer::removeConnection(const TcpConnectionPtr &conn)
@@ -148,7 +232,7 @@ void TcpServer::removeConnectionInLoop(const TcpConnectionPtr &conn)
 
     // 从连接池中删除（RAII方式自动管理连接生命周期）
     size_t n = connections_.erase(conn->getName());
-    (void) n;
+    loop_->metrics().activeConnections.sub(static_cast<int64_t>(n));
 
     // 在IO线程中安全销毁连接（确保在所属事件循环线程执行）
     EventLoop *ioLoop = conn->getLoop();
@@ -165,6 +249,12 @@ void TcpServer::start()
         // 启动线程池处理IO事件，threadInitCallback_用于线程初始化配置
         EventLoopThreadPool_->start(threadInitCallback_);
 
+        // 为每个 ioLoop 创建交接队列（之后只读，各线程可并发查找）
+        for (EventLoop *ioLoop: EventLoopThreadPool_->getAllLoops())
+        {
+            handoffs_.emplace(ioLoop, std::make_unique<LoopHandoff>());
+        }
+
         // 在mainLoop中启动监听器Acceptpr，开始监听新连接
         loop_->runInLoop([acceptor = acceptor_.get()] { acceptor->listen(); });
     }
@@ -213,4 +303,13 @@ void TcpServer::setThreadInitCallback(TcpServer::ThreadInitCallback cb)
 void TcpServer::setThreadNum(int numThreads)
 {
     EventLoopThreadPool_->setNumThread(numThreads);
-}
\ No newline at end of file
+}
+
+void TcpServer::setConnectionMemPoolSize(size_t size)
+{
+    connMemPoolSize_ = size;
+}
+void TcpServer::setBlockSource(NgxBlockSource *source)
+{
+    blockSource_ = source;
+}
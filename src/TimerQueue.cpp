@@ -0,0 +1,167 @@
+//
+// Created by shuzeyong on 2025/5/18.
+//
+
+#define LOG_MODULE net::LogModule::kEventLoop
+
+#include "../include/net/TimerQueue.h"
+#include "../include/net/EventLoop.h"
+
+#include <sys/timerfd.h>
+
+using namespace net;
+
+/**
+ * @brief 创建基于 CLOCK_MONOTONIC 的非阻塞 timerfd
+ */
+static int createTimerfd()
+{
+    int timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerfd < 0)
+    {
+        LOG_FATAL("timerfd_create error:%d \n", errno);
+    }
+    return timerfd;
+}
+
+TimerQueue::TimerQueue(EventLoop *loop)
+    : loop_(loop),
+      timerfd_(createTimerfd()),
+      timerfdChannel_(new Channel(loop, timerfd_)),
+      armedExpiration_(0),
+      nextId_(1)
+{
+    timerfdChannel_->setReadCallback([this](Timestamp) { handleRead(); });
+    timerfdChannel_->enableReading();
+}
+
+TimerQueue::~TimerQueue()
+{
+    timerfdChannel_->disableAll();
+    timerfdChannel_->remove();
+    close(timerfd_);
+}
+
+TimerId TimerQueue::addTimer(TimerCallback cb, int64_t expiration, int64_t interval)
+{
+    TimerId id = nextId_.fetch_add(1, std::memory_order_relaxed);
+    Timer timer{expiration, interval, id, std::move(cb), false};
+    if (loop_->isInLoopThread())
+    {
+        addTimerInLoop(std::move(timer));
+    }
+    else
+    {
+        loop_->queueInLoop([this, timer = std::make_shared<Timer>(std::move(timer))]() {
+            addTimerInLoop(std::move(*timer));
+        });
+    }
+    return id;
+}
+
+void TimerQueue::cancel(TimerId timerId)
+{
+    loop_->runInLoop([this, timerId]() { cancelInLoop(timerId); });
+}
+
+void TimerQueue::addTimerInLoop(Timer &&timer)
+{
+    timers_.push_back(std::move(timer));
+    std::push_heap(timers_.begin(), timers_.end(), later);
+    resetTimerfd();
+}
+
+void TimerQueue::cancelInLoop(TimerId timerId)
+{
+    // 只做标记，到期时跳过；正在执行的周期定时器也不会再次入堆
+    for (Timer &timer: timers_)
+    {
+        if (timer.id == timerId)
+        {
+            timer.cancelled = true;
+            return;
+        }
+    }
+    for (Timer &timer: expired_)
+    {
+        if (timer.id == timerId)
+        {
+            timer.cancelled = true;
+            return;
+        }
+    }
+}
+
+void TimerQueue::handleRead()
+{
+    uint64_t howMany;
+    ssize_t n = read(timerfd_, &howMany, sizeof(howMany));
+    if (n != sizeof(howMany) && errno != EAGAIN)
+    {
+        LOG_ERROR("TimerQueue::handleRead() reads %zd bytes instead of 8", n);
+    }
+    armedExpiration_ = 0;
+
+    // 先取出全部到期定时器再执行，回调中添加的新定时器留到下一轮
+    int64_t now = Timestamp::monotonicNanoseconds();
+    while (!timers_.empty() && timers_.front().expiration <= now)
+    {
+        std::pop_heap(timers_.begin(), timers_.end(), later);
+        expired_.push_back(std::move(timers_.back()));
+        timers_.pop_back();
+    }
+
+    for (size_t i = 0; i < expired_.size(); ++i)
+    {
+        if (!expired_[i].cancelled)
+        {
+            loop_->metrics().activity.callback.store(&expired_[i].cb.target_type(), std::memory_order_relaxed);
+            expired_[i].cb();
+        }
+    }
+
+    for (Timer &timer: expired_)
+    {
+        if (timer.interval > 0 && !timer.cancelled)
+        {
+            timer.expiration = now + timer.interval;
+            timers_.push_back(std::move(timer));
+            std::push_heap(timers_.begin(), timers_.end(), later);
+        }
+    }
+    expired_.clear();
+
+    resetTimerfd();
+}
+
+void TimerQueue::resetTimerfd()
+{
+    // 跳过堆顶已取消的定时器
+    while (!timers_.empty() && timers_.front().cancelled)
+    {
+        std::pop_heap(timers_.begin(), timers_.end(), later);
+        timers_.pop_back();
+    }
+    if (timers_.empty())
+    {
+        return;
+    }
+
+    int64_t expiration = timers_.front().expiration;
+    if (armedExpiration_ != 0 && armedExpiration_ <= expiration)
+    {
+        return;
+    }
+
+    // 使用绝对时间，已过期的时间点会让 timerfd 立即可读（0 表示停止，需避开）
+    itimerspec spec{};
+    int64_t when = std::max<int64_t>(expiration, 1);
+    spec.it_value.tv_sec = static_cast<time_t>(when / 1000000000);
+    spec.it_value.tv_nsec = static_cast<long>(when % 1000000000);
+    if (timerfd_settime(timerfd_, TFD_TIMER_ABSTIME, &spec, nullptr) < 0)
+    {
+        LOG_ERROR("timerfd_settime error:%d \n", errno);
+        return;
+    }
+    armedExpiration_ = expiration;
+}
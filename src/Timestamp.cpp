@@ -13,27 +13,71 @@ Timestamp::Timestamp(int64_t microSecondsSinceEpoch)
     : microSecondsSinceEpoch_(microSecondsSinceEpoch)
 {}
 
+/**
+ * @brief 读取指定时钟并换算为纳秒（clock_gettime 走 vDSO，不陷入内核）
+ */
+static int64_t clockNanoseconds(clockid_t clock)
+{
+    timespec ts = {};
+    clock_gettime(clock, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * Timestamp::kMicroSecondsPerSecond * Timestamp::kNanoSecondsPerMicroSecond +
+           ts.tv_nsec;
+}
+
 Timestamp Timestamp::now()
 {
-    // 使用time函数获取当前时间，并将其传递给Timestamp构造函数
-    return Timestamp(time(nullptr));
+    return Timestamp(clockNanoseconds(CLOCK_REALTIME) / kNanoSecondsPerMicroSecond);
+}
+
+Timestamp Timestamp::monotonic()
+{
+    return Timestamp(clockNanoseconds(CLOCK_MONOTONIC) / kNanoSecondsPerMicroSecond);
+}
+
+int64_t Timestamp::monotonicNanoseconds()
+{
+    return clockNanoseconds(CLOCK_MONOTONIC);
+}
+
+std::string Timestamp::toString() const
+{
+    return toFormattedString(false);
 }
 
-std::string Timestamp::toString()
+std::string Timestamp::toFormattedString(bool showMicroseconds) const
 {
-    char buf[128] = {};// 用于存储格式化后的时间字符串的缓冲区
+    char buf[64] = {};// 用于存储格式化后的时间字符串的缓冲区
 
-    // 将时间戳转换为本地时间结构体 tm
-    tm *tm_time = localtime(&microSecondsSinceEpoch_);
+    // 将时间戳转换为本地时间结构体 tm（线程安全版本）
+    time_t seconds = secondsSinceEpoch();
+    tm tm_time = {};
+    localtime_r(&seconds, &tm_time);
 
     // 使用 snprintf 将时间格式化为 "YYYY/MM/DD HH:MM:SS" 的字符串
-    snprintf(buf, 128, "%4d/%02d/%02d %02d:%02d:%02d",
-             tm_time->tm_year + 1900,// 年份，tm_year 是从 1900 年开始的偏移量
-             tm_time->tm_mon + 1,    // 月份，tm_mon 是从 0 开始的，所以需要加 1
-             tm_time->tm_mday,       // 日
-             tm_time->tm_hour,       // 小时
-             tm_time->tm_min,        // 分钟
-             tm_time->tm_sec);       // 秒
+    int len = snprintf(buf, sizeof(buf), "%4d/%02d/%02d %02d:%02d:%02d",
+                       tm_time.tm_year + 1900,// 年份，tm_year 是从 1900 年开始的偏移量
+                       tm_time.tm_mon + 1,    // 月份，tm_mon 是从 0 开始的，所以需要加 1
+                       tm_time.tm_mday,       // 日
+                       tm_time.tm_hour,       // 小时
+                       tm_time.tm_min,        // 分钟
+                       tm_time.tm_sec);       // 秒
+
+    // 追加微秒部分
+    if (showMicroseconds)
+    {
+        int microseconds = static_cast<int>(microSecondsSinceEpoch_ % kMicroSecondsPerSecond);
+        snprintf(buf + len, sizeof(buf) - len, ".%06d", microseconds);
+    }
 
     return buf;// 返回格式化后的时间字符串
-}
\ No newline at end of file
+}
+
+int64_t Timestamp::microSecondsSinceEpoch() const
+{
+    return microSecondsSinceEpoch_;
+}
+
+time_t Timestamp::secondsSinceEpoch() const
+{
+    return static_cast<time_t>(microSecondsSinceEpoch_ / kMicroSecondsPerSecond);
+}
@@ -0,0 +1,379 @@
+//
+// Created by shuzeyong on 2025/5/17.
+//
+
+/*
+ * 二进制日志离线解码工具：将 BinaryLogger 生成的 .binlog 文件还原为文本
+ *
+ * 用法：binlog_decoder <file.binlog> [output.log]
+ * 输出格式：YYYY/MM/DD HH:MM:SS.uuuuuu tid [LEVEL] file:line 消息
+ */
+
+#include "../include/net/BinaryLogging.h"
+
+using namespace net;
+
+namespace
+{
+    struct Format
+    {
+        uint8_t level = 0;
+        std::string file;
+        uint32_t line = 0;
+        std::string fmt;
+        std::vector<BinArgType> types;
+    };
+
+    /**
+     * @class Reader
+     * @brief 带边界检查的顺序读取器
+     */
+    class Reader
+    {
+    public:
+        Reader(const char *data, size_t len)
+            : cur_(data),
+              end_(data + len)
+        {}
+
+        template<typename T>
+        bool read(T &value)
+        {
+            if (remaining() < sizeof(T))
+            {
+                return false;
+            }
+            memcpy(&value, cur_, sizeof(T));
+            cur_ += sizeof(T);
+            return true;
+        }
+
+        bool read(std::string &s, size_t len)
+        {
+            if (remaining() < len)
+            {
+                return false;
+            }
+            s.assign(cur_, len);
+            cur_ += len;
+            return true;
+        }
+
+        [[nodiscard]] size_t remaining() const { return static_cast<size_t>(end_ - cur_); }
+        [[nodiscard]] const char *current() const { return cur_; }
+        void skip(size_t n) { cur_ += std::min(n, remaining()); }
+
+    private:
+        const char *cur_;
+        const char *end_;
+    };
+
+    /**
+     * @brief 获取日志级别标签
+     */
+    const char *levelTag(uint8_t level)
+    {
+        static const char *const kTags[] = {"[DEBUG]", "[INFO]", "[ERROR]", "[FATAL]"};
+        return level < std::size(kTags) ? kTags[level] : "[?]";
+    }
+
+    /**
+     * @brief 跳过一个参数
+     */
+    void skipArg(Reader &args, BinArgType type)
+    {
+        switch (type)
+        {
+            case BinArgType::kInt32:
+            case BinArgType::kUInt32:
+                args.skip(4);
+                break;
+            case BinArgType::kString: {
+                uint16_t len = 0;
+                args.read(len);
+                args.skip(len);
+                break;
+            }
+            default:
+                args.skip(8);
+                break;
+        }
+    }
+
+    /**
+     * @brief 按格式串渲染一条记录的参数
+     *
+     * 逐个解析转换说明，去掉原有长度修饰符后按记录中保存的实际类型重新拼接，再交给 snprintf。
+     * 宽度/精度中的 * 不交给 snprintf（否则缺少对应的 int 参数），对应参数被跳过，按默认宽度/精度输出
+     */
+    std::string render(const Format &format, Reader &args)
+    {
+        std::string out;
+        const std::string &fmt = format.fmt;
+        size_t argIndex = 0;
+        char buf[512];
+
+        for (size_t i = 0; i < fmt.size(); ++i)
+        {
+            if (fmt[i] != '%')
+            {
+                out += fmt[i];
+                continue;
+            }
+            if (i + 1 < fmt.size() && fmt[i + 1] == '%')
+            {
+                out += '%';
+                ++i;
+                continue;
+            }
+
+            // 标志、宽度、精度；* 对应的参数直接跳过
+            size_t j = i + 1;
+            std::string spec = "%";
+            while (j < fmt.size() && strchr("-+ #0123456789.*", fmt[j]))
+            {
+                if (fmt[j] == '*')
+                {
+                    if (argIndex < format.types.size())
+                    {
+                        skipArg(args, format.types[argIndex++]);
+                    }
+                    // 去掉 "*" 或 ".*"，保留其余标志
+                    if (!spec.empty() && spec.back() == '.')
+                    {
+                        spec.pop_back();
+                    }
+                }
+                else
+                {
+                    spec += fmt[j];
+                }
+                ++j;
+            }
+            // 长度修饰符
+            while (j < fmt.size() && strchr("hlLqjzt", fmt[j]))
+            {
+                ++j;
+            }
+            if (j >= fmt.size())
+            {
+                out += fmt.substr(i);
+                break;
+            }
+            char conv = fmt[j];
+            i = j;
+
+            if (argIndex >= format.types.size())
+            {
+                out += "<missing>";
+                continue;
+            }
+            BinArgType type = format.types[argIndex++];
+
+            // 转换符与实际类型不匹配时改用该类型的默认转换符，避免 snprintf 未定义行为
+            bool integral = type != BinArgType::kDouble && type != BinArgType::kString && type != BinArgType::kPointer;
+            if (integral && !strchr("diouxXc", conv))
+            {
+                conv = (type == BinArgType::kInt32 || type == BinArgType::kInt64) ? 'd' : 'u';
+            }
+            else if (type == BinArgType::kDouble && !strchr("fFeEgGaA", conv))
+            {
+                conv = 'g';
+            }
+            if (integral && conv == 'c' && type != BinArgType::kInt32 && type != BinArgType::kUInt32)
+            {
+                conv = 'd';
+            }
+
+            int n = 0;
+            switch (type)
+            {
+                case BinArgType::kInt32: {
+                    int32_t v = 0;
+                    args.read(v);
+                    n = snprintf(buf, sizeof(buf), (spec + conv).c_str(), v);
+                    break;
+                }
+                case BinArgType::kUInt32: {
+                    uint32_t v = 0;
+                    args.read(v);
+                    n = snprintf(buf, sizeof(buf), (spec + conv).c_str(), v);
+                    break;
+                }
+                case BinArgType::kInt64: {
+                    int64_t v = 0;
+                    args.read(v);
+                    n = snprintf(buf, sizeof(buf), (spec + "ll" + conv).c_str(), static_cast<long long>(v));
+                    break;
+                }
+                case BinArgType::kUInt64: {
+                    uint64_t v = 0;
+                    args.read(v);
+                    n = snprintf(buf, sizeof(buf), (spec + "ll" + conv).c_str(), static_cast<unsigned long long>(v));
+                    break;
+                }
+                case BinArgType::kDouble: {
+                    double v = 0;
+                    args.read(v);
+                    n = snprintf(buf, sizeof(buf), (spec + conv).c_str(), v);
+                    break;
+                }
+                case BinArgType::kString: {
+                    uint16_t len = 0;
+                    std::string s;
+                    args.read(len);
+                    args.read(s, len);
+                    n = snprintf(buf, sizeof(buf), (spec + 's').c_str(), s.c_str());
+                    break;
+                }
+                case BinArgType::kPointer: {
+                    uint64_t v = 0;
+                    args.read(v);
+                    n = snprintf(buf, sizeof(buf), "0x%llx", static_cast<unsigned long long>(v));
+                    break;
+                }
+            }
+            if (n > 0)
+            {
+                out.append(buf, std::min(static_cast<size_t>(n), sizeof(buf) - 1));
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief 解码一个线程数据块中的全部记录
+     */
+    bool decodeChunk(Reader &chunk, int32_t tid, const std::unordered_map<uint32_t, Format> &formats, FILE *out)
+    {
+        while (chunk.remaining() > 0)
+        {
+            uint32_t id;
+            int64_t microSecondsSinceEpoch;
+            uint16_t payloadLen;
+            if (!chunk.read(id) || !chunk.read(microSecondsSinceEpoch) || !chunk.read(payloadLen) ||
+                chunk.remaining() < payloadLen)
+            {
+                fprintf(stderr, "binlog_decoder: truncated record\n");
+                return false;
+            }
+
+            Reader payload(chunk.current(), payloadLen);
+            chunk.skip(payloadLen);
+
+            std::string time = Timestamp(microSecondsSinceEpoch).toFormattedString(true);
+            auto it = formats.find(id);
+            if (it == formats.end())
+            {
+                fprintf(out, "%s %d <unknown format %u>\n", time.c_str(), tid, id);
+                continue;
+            }
+            const Format &format = it->second;
+            std::string msg = render(format, payload);
+            // 每条记录输出一行，去掉格式串自带的换行
+            while (!msg.empty() && msg.back() == '\n')
+            {
+                msg.pop_back();
+            }
+            fprintf(out, "%s %d %s %s:%u %s\n", time.c_str(), tid, levelTag(format.level), format.file.c_str(),
+                    format.line, msg.c_str());
+        }
+        return true;
+    }
+}// namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <file.binlog> [output.log]\n", argv[0]);
+        return 1;
+    }
+
+    FILE *in = fopen(argv[1], "rbe");
+    if (in == nullptr)
+    {
+        fprintf(stderr, "binlog_decoder: open %s failed: %s\n", argv[1], strerror(errno));
+        return 1;
+    }
+    std::string data;
+    char buf[64 * 1024];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0)
+    {
+        data.append(buf, n);
+    }
+    fclose(in);
+
+    FILE *out = stdout;
+    if (argc >= 3 && (out = fopen(argv[2], "we")) == nullptr)
+    {
+        fprintf(stderr, "binlog_decoder: open %s failed: %s\n", argv[2], strerror(errno));
+        return 1;
+    }
+
+    Reader reader(data.data(), data.size());
+    if (reader.remaining() < sizeof(kBinLogMagic) || memcmp(reader.current(), kBinLogMagic, sizeof(kBinLogMagic)) != 0)
+    {
+        fprintf(stderr, "binlog_decoder: %s is not a binary log\n", argv[1]);
+        return 1;
+    }
+    reader.skip(sizeof(kBinLogMagic));
+
+    std::unordered_map<uint32_t, Format> formats;
+    int ret = 0;
+    while (reader.remaining() > 0)
+    {
+        uint8_t kind = 0;
+        reader.read(kind);
+        if (kind == kBinLogFormatEntry)
+        {
+            uint32_t id, fileLen, fmtLen;
+            uint16_t nargs;
+            Format format;
+            std::string types;
+            if (!reader.read(id) || !reader.read(format.level) || !reader.read(format.line) || !reader.read(nargs) ||
+                !reader.read(types, nargs) || !reader.read(fileLen) || !reader.read(format.file, fileLen) ||
+                !reader.read(fmtLen) || !reader.read(format.fmt, fmtLen))
+            {
+                fprintf(stderr, "binlog_decoder: truncated format entry\n");
+                ret = 1;
+                break;
+            }
+            for (char type: types)
+            {
+                format.types.push_back(static_cast<BinArgType>(type));
+            }
+            formats[id] = std::move(format);
+        }
+        else if (kind == kBinLogChunkEntry)
+        {
+            int32_t tid;
+            uint32_t len;
+            if (!reader.read(tid) || !reader.read(len) || reader.remaining() < len)
+            {
+                fprintf(stderr, "binlog_decoder: truncated chunk\n");
+                ret = 1;
+                break;
+            }
+            Reader chunk(reader.current(), len);
+            reader.skip(len);
+            if (!decodeChunk(chunk, tid, formats, out))
+            {
+                ret = 1;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "binlog_decoder: unknown entry kind %u\n", kind);
+            ret = 1;
+            break;
+        }
+    }
+
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    return ret;
+}